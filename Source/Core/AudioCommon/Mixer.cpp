@@ -4,8 +4,16 @@
 
 #include "AudioCommon/Mixer.h"
 
+#include <algorithm>
+#include <array>
+#include <cinttypes>
 #include <cmath>
 #include <cstring>
+#include <limits>
+
+#ifdef _M_X86
+#include <emmintrin.h>
+#endif
 
 #include "AudioCommon/DPL2Decoder.h"
 #include "Common/ChunkFile.h"
@@ -15,6 +23,352 @@
 #include "Common/Swap.h"
 #include "Core/ConfigManager.h"
 
+namespace
+{
+// The polyphase resampler computes each output sample from POLYPHASE_TAPS input samples, with the
+// windowed sinc filter of the closest of POLYPHASE_PHASES fractional positions. The output sample
+// lies between the taps POLYPHASE_TAPS / 2 - 1 and POLYPHASE_TAPS / 2.
+constexpr u32 POLYPHASE_TAPS = 8;
+constexpr u32 POLYPHASE_PHASES = 256;
+constexpr int POLYPHASE_SHIFT = 14;
+// Cutoff frequency of the filter, relative to the Nyquist frequency of the input.
+constexpr double POLYPHASE_CUTOFF = 0.9;
+
+using PolyphaseFilter = std::array<std::array<s16, POLYPHASE_TAPS>, POLYPHASE_PHASES>;
+
+PolyphaseFilter CreatePolyphaseFilter()
+{
+  constexpr double pi = 3.14159265358979323846;
+  PolyphaseFilter filter;
+  for (u32 phase = 0; phase < POLYPHASE_PHASES; ++phase)
+  {
+    const double position = static_cast<double>(phase) / POLYPHASE_PHASES;
+    std::array<double, POLYPHASE_TAPS> weights;
+    double weight_sum = 0.0;
+    for (u32 tap = 0; tap < POLYPHASE_TAPS; ++tap)
+    {
+      // Distance between the input sample and the output sample.
+      const double x = static_cast<double>(tap) - (POLYPHASE_TAPS / 2 - 1) - position;
+      const double sinc_x = pi * x * POLYPHASE_CUTOFF;
+      const double sinc = x == 0.0 ? 1.0 : std::sin(sinc_x) / sinc_x;
+      // Blackman window spanning all the taps.
+      const double w = x / POLYPHASE_TAPS + 0.5;
+      const double window = 0.42 - 0.5 * std::cos(2 * pi * w) + 0.08 * std::cos(4 * pi * w);
+      weights[tap] = sinc * window;
+      weight_sum += weights[tap];
+    }
+
+    // Normalize each phase so that a constant input comes out unchanged.
+    s32 total = 0;
+    for (u32 tap = 0; tap < POLYPHASE_TAPS; ++tap)
+    {
+      filter[phase][tap] =
+          static_cast<s16>(std::lround(weights[tap] / weight_sum * (1 << POLYPHASE_SHIFT)));
+      total += filter[phase][tap];
+    }
+    const u32 nearest_tap = POLYPHASE_TAPS / 2 - 1 + (position >= 0.5 ? 1 : 0);
+    filter[phase][nearest_tap] += static_cast<s16>((1 << POLYPHASE_SHIFT) - total);
+  }
+  return filter;
+}
+
+const PolyphaseFilter s_polyphase_filter = CreatePolyphaseFilter();
+
+// Returns the number of input samples, starting from the read position, that the resampler needs
+// to compute an output sample.
+u32 GetResamplerLookahead(bool polyphase)
+{
+  return polyphase ? POLYPHASE_TAPS : 2;
+}
+
+s32 InterpolateLinear(const s16* input, u32 position)
+{
+  const s64 s1 = input[position >> 16];
+  const s64 s2 = input[(position >> 16) + 1];
+  return static_cast<s32>((s1 * 65536 + (s2 - s1) * (position & 0xffff)) >> 16);
+}
+
+s32 InterpolatePolyphase(const s16* input, u32 position)
+{
+  const s16* taps = &input[position >> 16];
+  const std::array<s16, POLYPHASE_TAPS>& coefs = s_polyphase_filter[(position & 0xffff) >> 8];
+  s32 sum = 0;
+  for (u32 tap = 0; tap < POLYPHASE_TAPS; ++tap)
+    sum += taps[tap] * coefs[tap];
+  return MathUtil::Clamp(sum >> POLYPHASE_SHIFT, -32768, 32767);
+}
+
+// The volume of each channel across one Mix call, which goes in equal steps from the volume that
+// the previous call ended at to the new one, so that volume changes don't cause zipper noise. The
+// volumes are kept in 16.16 fixed point, and frame i gets the volume after i + 1 steps.
+struct VolumeRamp
+{
+  VolumeRamp(s32 lstart, s32 rstart, s32 lend, s32 rend, u32 frames)
+      : left(lstart * 65536), right(rstart * 65536),
+        left_step(frames ? (lend - lstart) * 65536 / static_cast<s32>(frames) : 0),
+        right_step(frames ? (rend - rstart) * 65536 / static_cast<s32>(frames) : 0)
+  {
+  }
+
+  s32 Left(u32 frame) const { return (left + left_step * static_cast<s32>(frame + 1)) >> 16; }
+  s32 Right(u32 frame) const { return (right + right_step * static_cast<s32>(frame + 1)) >> 16; }
+
+  s32 left;
+  s32 right;
+  s32 left_step;
+  s32 right_step;
+};
+
+#ifdef _M_X86
+// Loads the sample at the given index and the next one into a 32-bit lane.
+u32 LoadSamplePair(const s16* samples, u32 index)
+{
+  u32 pair;
+  std::memcpy(&pair, &samples[index], sizeof(pair));
+  return pair;
+}
+
+// Interpolates between the two samples of each 32-bit lane, exactly like InterpolateLinear. The
+// weights are split in a high and a low part to fit in the 16-bit multipliers of PMADDWD, and the
+// intermediate values can wrap around but the result can't.
+__m128i InterpolateLinearPairs(__m128i pairs, __m128i half_weights, __m128i low_weights)
+{
+  const __m128i first = _mm_srai_epi32(_mm_slli_epi32(pairs, 16), 16);
+  const __m128i difference_half = _mm_madd_epi16(pairs, half_weights);
+  const __m128i difference_low = _mm_madd_epi16(pairs, low_weights);
+  const __m128i difference =
+      _mm_add_epi32(_mm_slli_epi32(difference_half, 1), difference_low);
+  return _mm_srai_epi32(_mm_add_epi32(_mm_slli_epi32(first, 16), difference), 16);
+}
+
+// Returns the weights that make PMADDWD compute (second - first) * factor, for 15-bit factors.
+__m128i DifferenceWeights(__m128i factors)
+{
+  const __m128i negated = _mm_sub_epi32(_mm_setzero_si128(), factors);
+  return _mm_or_si128(_mm_slli_epi32(factors, 16), _mm_and_si128(negated, _mm_set1_epi32(0xffff)));
+}
+
+// Scales the samples of four frames by the volume and adds them to the output. The samples have to
+// fit in 16 bits.
+void AccumulateFrames(s32* out, __m128i right, __m128i left, __m128i volume)
+{
+  const __m128i samples = _mm_packs_epi32(right, left);
+  const __m128i low = _mm_mullo_epi16(samples, volume);
+  const __m128i high = _mm_mulhi_epi16(samples, volume);
+  const __m128i scaled_right = _mm_srai_epi32(_mm_unpacklo_epi16(low, high), 8);
+  const __m128i scaled_left = _mm_srai_epi32(_mm_unpackhi_epi16(low, high), 8);
+
+  __m128i* const out_vector = reinterpret_cast<__m128i*>(out);
+  _mm_storeu_si128(&out_vector[0],
+                   _mm_add_epi32(_mm_loadu_si128(&out_vector[0]),
+                                 _mm_unpacklo_epi32(scaled_right, scaled_left)));
+  _mm_storeu_si128(&out_vector[1],
+                   _mm_add_epi32(_mm_loadu_si128(&out_vector[1]),
+                                 _mm_unpackhi_epi32(scaled_right, scaled_left)));
+}
+
+// Steps through the volumes of a VolumeRamp four frames at a time, in the layout that
+// AccumulateFrames takes.
+class VolumeVectors
+{
+public:
+  explicit VolumeVectors(const VolumeRamp& ramp)
+      : m_right(_mm_setr_epi32(ramp.right + ramp.right_step, ramp.right + ramp.right_step * 2,
+                               ramp.right + ramp.right_step * 3, ramp.right + ramp.right_step * 4)),
+        m_left(_mm_setr_epi32(ramp.left + ramp.left_step, ramp.left + ramp.left_step * 2,
+                              ramp.left + ramp.left_step * 3, ramp.left + ramp.left_step * 4)),
+        m_right_step(_mm_set1_epi32(ramp.right_step * 4)),
+        m_left_step(_mm_set1_epi32(ramp.left_step * 4))
+  {
+  }
+
+  __m128i Next()
+  {
+    const __m128i volumes =
+        _mm_packs_epi32(_mm_srai_epi32(m_right, 16), _mm_srai_epi32(m_left, 16));
+    m_right = _mm_add_epi32(m_right, m_right_step);
+    m_left = _mm_add_epi32(m_left, m_left_step);
+    return volumes;
+  }
+
+private:
+  __m128i m_right;
+  __m128i m_left;
+  __m128i m_right_step;
+  __m128i m_left_step;
+};
+
+// Adds up the four lanes of each of the vectors.
+__m128i HorizontalAdd(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+  const __m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b), _mm_unpackhi_epi32(a, b));
+  const __m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d), _mm_unpackhi_epi32(c, d));
+  return _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd));
+}
+#endif
+
+// Resamples count frames starting at the 16.16 fixed point position, and adds them to the output
+// with the volume applied. Each frame of the output holds the right sample first.
+void ResampleLinear(const s16* left, const s16* right, u32 position, u32 ratio, u32 count,
+                    const VolumeRamp& volume, s32* out)
+{
+  u32 i = 0;
+#ifdef _M_X86
+  VolumeVectors volumes(volume);
+  for (; i + 4 <= count; i += 4)
+  {
+    const u32 positions[4] = {position + i * ratio, position + (i + 1) * ratio,
+                              position + (i + 2) * ratio, position + (i + 3) * ratio};
+    const __m128i right_pairs = _mm_setr_epi32(
+        LoadSamplePair(right, positions[0] >> 16), LoadSamplePair(right, positions[1] >> 16),
+        LoadSamplePair(right, positions[2] >> 16), LoadSamplePair(right, positions[3] >> 16));
+    const __m128i left_pairs = _mm_setr_epi32(
+        LoadSamplePair(left, positions[0] >> 16), LoadSamplePair(left, positions[1] >> 16),
+        LoadSamplePair(left, positions[2] >> 16), LoadSamplePair(left, positions[3] >> 16));
+
+    const __m128i fractions = _mm_and_si128(
+        _mm_setr_epi32(positions[0], positions[1], positions[2], positions[3]),
+        _mm_set1_epi32(0xffff));
+    const __m128i half_weights = DifferenceWeights(_mm_srli_epi32(fractions, 1));
+    const __m128i low_weights = DifferenceWeights(_mm_and_si128(fractions, _mm_set1_epi32(1)));
+    const __m128i interpolated_right =
+        InterpolateLinearPairs(right_pairs, half_weights, low_weights);
+    const __m128i interpolated_left = InterpolateLinearPairs(left_pairs, half_weights, low_weights);
+
+    AccumulateFrames(&out[i * 2], interpolated_right, interpolated_left, volumes.Next());
+  }
+#endif
+
+  for (; i < count; ++i)
+  {
+    const u32 sample_position = position + i * ratio;
+    out[i * 2] += (InterpolateLinear(right, sample_position) * volume.Right(i)) >> 8;
+    out[i * 2 + 1] += (InterpolateLinear(left, sample_position) * volume.Left(i)) >> 8;
+  }
+}
+
+void ResamplePolyphase(const s16* left, const s16* right, u32 position, u32 ratio, u32 count,
+                       const VolumeRamp& volume, s32* out)
+{
+  u32 i = 0;
+#ifdef _M_X86
+  VolumeVectors volumes(volume);
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i sums_right[4];
+    __m128i sums_left[4];
+    for (u32 j = 0; j < 4; ++j)
+    {
+      const u32 sample_position = position + (i + j) * ratio;
+      const u32 index = sample_position >> 16;
+      const __m128i coefs = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(s_polyphase_filter[(sample_position & 0xffff) >> 8]
+                                               .data()));
+      sums_right[j] = _mm_madd_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(&right[index])), coefs);
+      sums_left[j] = _mm_madd_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(&left[index])), coefs);
+    }
+
+    // The samples are clamped to 16 bits when AccumulateFrames packs them.
+    const __m128i filtered_right = _mm_srai_epi32(
+        HorizontalAdd(sums_right[0], sums_right[1], sums_right[2], sums_right[3]),
+        POLYPHASE_SHIFT);
+    const __m128i filtered_left = _mm_srai_epi32(
+        HorizontalAdd(sums_left[0], sums_left[1], sums_left[2], sums_left[3]), POLYPHASE_SHIFT);
+
+    AccumulateFrames(&out[i * 2], filtered_right, filtered_left, volumes.Next());
+  }
+#endif
+
+  for (; i < count; ++i)
+  {
+    const u32 sample_position = position + i * ratio;
+    out[i * 2] += (InterpolatePolyphase(right, sample_position) * volume.Right(i)) >> 8;
+    out[i * 2 + 1] += (InterpolatePolyphase(left, sample_position) * volume.Left(i)) >> 8;
+  }
+}
+
+// Copies the first count frames of the big endian ring buffer to one array per channel in host
+// byte order.
+template <typename Ring>
+void DeinterleaveSamples(const Ring& ring, u32 count, s16* left, s16* right)
+{
+  u32 i = 0;
+  while (i < count)
+  {
+    // Stop at the end of the ring buffer.
+    size_t contiguous;
+    const short* in = ring.Peek(i * 2, &contiguous);
+    const u32 end = std::min(count, i + static_cast<u32>(contiguous / 2));
+
+#ifdef _M_X86
+    for (; i + 8 <= end; i += 8, in += 16)
+    {
+      __m128i frames_0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+      __m128i frames_1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8));
+      frames_0 = _mm_or_si128(_mm_slli_epi16(frames_0, 8), _mm_srli_epi16(frames_0, 8));
+      frames_1 = _mm_or_si128(_mm_slli_epi16(frames_1, 8), _mm_srli_epi16(frames_1, 8));
+
+      // The left samples are the lower halves of the 32-bit frames.
+      const __m128i left_samples =
+          _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(frames_0, 16), 16),
+                          _mm_srai_epi32(_mm_slli_epi32(frames_1, 16), 16));
+      const __m128i right_samples =
+          _mm_packs_epi32(_mm_srai_epi32(frames_0, 16), _mm_srai_epi32(frames_1, 16));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&left[i]), left_samples);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&right[i]), right_samples);
+    }
+#endif
+
+    for (; i < end; ++i, in += 2)
+    {
+      left[i] = Common::swap16(in[0]);
+      right[i] = Common::swap16(in[1]);
+    }
+  }
+}
+
+// Clamps the mixed samples and stores them as 16-bit samples.
+void PackSamples(const s32* in, short* out, u32 count)
+{
+  u32 i = 0;
+#ifdef _M_X86
+  const __m128i min = _mm_set1_epi16(-32767);
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i packed =
+        _mm_packs_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&in[i])),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&in[i + 4])));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i]), _mm_max_epi16(packed, min));
+  }
+#endif
+
+  for (; i < count; ++i)
+    out[i] = static_cast<short>(MathUtil::Clamp(in[i], -32767, 32767));
+}
+
+void ConvertToFloat(const short* in, float* out, u32 count)
+{
+  constexpr float scale = 1.0f / std::numeric_limits<short>::max();
+  u32 i = 0;
+#ifdef _M_X86
+  const __m128 scale_vector = _mm_set1_ps(scale);
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&in[i]));
+    const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+    const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+    _mm_storeu_ps(&out[i], _mm_mul_ps(_mm_cvtepi32_ps(low), scale_vector));
+    _mm_storeu_ps(&out[i + 4], _mm_mul_ps(_mm_cvtepi32_ps(high), scale_vector));
+  }
+#endif
+
+  for (; i < count; ++i)
+    out[i] = in[i] * scale;
+}
+}  // namespace
+
 Mixer::Mixer(unsigned int BackendSampleRate)
     : m_sampleRate(BackendSampleRate), m_stretcher(BackendSampleRate)
 {
@@ -24,6 +378,14 @@ Mixer::Mixer(unsigned int BackendSampleRate)
 
 Mixer::~Mixer()
 {
+  const auto log_statistics = [](const char* name, const FifoStatistics& statistics) {
+    INFO_LOG(AUDIO, "%s FIFO: %" PRIu64 " underruns, %" PRIu64 " overruns, %.1f ms latency",
+             name, statistics.underruns, statistics.overruns, statistics.average_latency_ms);
+  };
+  const Statistics statistics = GetStatistics();
+  log_statistics("DMA", statistics.dma);
+  log_statistics("Streaming", statistics.streaming);
+  log_statistics("Wii Remote speaker", statistics.wiimote_speaker);
 }
 
 void Mixer::DoState(PointerWrap& p)
@@ -33,31 +395,24 @@ void Mixer::DoState(PointerWrap& p)
   m_wiimote_speaker_mixer.DoState(p);
 }
 
-// Executed from sound stream thread
-unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
-                                   bool consider_framelimit)
+Mixer::Statistics Mixer::GetStatistics() const
 {
-  unsigned int currentSample = 0;
-
-  // Cache access in non-volatile variable
-  // This is the only function changing the read value, so it's safe to
-  // cache it locally although it's written here.
-  // The writing pointer will be modified outside, but it will only increase,
-  // so we will just ignore new written data while interpolating.
-  // Without this cache, the compiler wouldn't be allowed to optimize the
-  // interpolation loop.
-  u32 indexR = m_indexR.load();
-  u32 indexW = m_indexW.load();
+  return {m_dma_mixer.GetStatistics(), m_streaming_mixer.GetStatistics(),
+          m_wiimote_speaker_mixer.GetStatistics()};
+}
 
-  // render numleft sample pairs to samples[]
-  // advance indexR with sample position
-  // remember fractional offset
+// Executed from sound stream thread
+unsigned int Mixer::MixerFifo::Mix(s32* samples, unsigned int numSamples, bool consider_framelimit)
+{
+  // The producer only ever adds samples, so anything it writes while we are mixing is simply left
+  // for the next call.
+  const u32 available = static_cast<u32>(m_buffer.Size() / 2);
 
   float emulationspeed = SConfig::GetInstance().m_EmulationSpeed;
   float aid_sample_rate = static_cast<float>(m_input_sample_rate);
   if (consider_framelimit && emulationspeed > 0.0f)
   {
-    float numLeft = static_cast<float>(((indexW - indexR) & INDEX_MASK) / 2);
+    float numLeft = static_cast<float>(available);
 
     u32 low_waterwark = m_input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
     low_waterwark = std::min(low_waterwark, MAX_SAMPLES / 2);
@@ -74,74 +429,104 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
 
   const u32 ratio = (u32)(65536.0f * aid_sample_rate / (float)m_mixer->m_sampleRate);
 
-  s32 lvolume = m_LVolume.load();
-  s32 rvolume = m_RVolume.load();
+  const s32 lvolume = m_LVolume.load();
+  const s32 rvolume = m_RVolume.load();
+  const VolumeRamp volume(m_mixed_lvolume, m_mixed_rvolume, lvolume, rvolume, numSamples);
+  m_mixed_lvolume = lvolume;
+  m_mixed_rvolume = rvolume;
+
+  // Work out how many samples can be rendered before the resampler runs out of input, so that the
+  // kernels don't have to check for it.
+  const bool polyphase = SConfig::GetInstance().m_audio_polyphase_resampling;
+  const u32 lookahead = GetResamplerLookahead(polyphase);
+  u32 actual_sample_count = 0;
+  if (available >= lookahead)
+  {
+    // The last position from which the input samples are all available.
+    const u64 last_position = static_cast<u64>(available - lookahead) << 16 | 0xffff;
+    actual_sample_count = numSamples;
+    if (ratio != 0)
+    {
+      actual_sample_count =
+          static_cast<u32>(std::min<u64>(numSamples, (last_position - m_frac) / ratio + 1));
+    }
+  }
 
-  // TODO: consider a higher-quality resampling algorithm.
-  for (; currentSample < numSamples * 2 && ((indexW - indexR) & INDEX_MASK) > 2; currentSample += 2)
+  u32 consumed = 0;
+  if (actual_sample_count != 0)
   {
-    u32 indexR2 = indexR + 2;  // next sample
-
-    s16 l1 = Common::swap16(m_buffer[indexR & INDEX_MASK]);   // current
-    s16 l2 = Common::swap16(m_buffer[indexR2 & INDEX_MASK]);  // next
-    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
-    sampleL = (sampleL * lvolume) >> 8;
-    sampleL += samples[currentSample + 1];
-    samples[currentSample + 1] = MathUtil::Clamp(sampleL, -32767, 32767);
-
-    s16 r1 = Common::swap16(m_buffer[(indexR + 1) & INDEX_MASK]);   // current
-    s16 r2 = Common::swap16(m_buffer[(indexR2 + 1) & INDEX_MASK]);  // next
-    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
-    sampleR = (sampleR * rvolume) >> 8;
-    sampleR += samples[currentSample];
-    samples[currentSample] = MathUtil::Clamp(sampleR, -32767, 32767);
-
-    m_frac += ratio;
-    indexR += 2 * (u16)(m_frac >> 16);
-    m_frac &= 0xffff;
+    const u32 last_index = (m_frac + (actual_sample_count - 1) * ratio) >> 16;
+    const u32 end_position = m_frac + actual_sample_count * ratio;
+    // When resampling down by more than 2x, the end position can be past the available samples.
+    consumed = std::min(end_position >> 16, available);
+    DeinterleaveSamples(m_buffer, std::max(last_index + lookahead, consumed), m_left_input.data(),
+                        m_right_input.data());
+
+    if (polyphase)
+    {
+      ResamplePolyphase(m_left_input.data(), m_right_input.data(), m_frac, ratio,
+                        actual_sample_count, volume, samples);
+    }
+    else
+    {
+      ResampleLinear(m_left_input.data(), m_right_input.data(), m_frac, ratio,
+                     actual_sample_count, volume, samples);
+    }
+
+    m_frac = consumed == end_position >> 16 ? end_position & 0xffff : 0;
+    if (consumed != 0)
+    {
+      m_last_left = m_left_input[consumed - 1];
+      m_last_right = m_right_input[consumed - 1];
+    }
   }
 
-  // Actual number of samples written to the buffer without padding.
-  unsigned int actual_sample_count = currentSample / 2;
+  // Only count the underruns of FIFOs that are playing, as most of them are idle most of the time.
+  if (actual_sample_count < numSamples && (actual_sample_count != 0 || m_playing))
+    m_buffer.CountUnderrun();
+  m_playing = actual_sample_count == numSamples;
 
   // Padding
-  short s[2];
-  s[0] = Common::swap16(m_buffer[(indexR - 1) & INDEX_MASK]);
-  s[1] = Common::swap16(m_buffer[(indexR - 2) & INDEX_MASK]);
-  s[0] = (s[0] * rvolume) >> 8;
-  s[1] = (s[1] * lvolume) >> 8;
-  for (; currentSample < numSamples * 2; currentSample += 2)
+  for (u32 i = actual_sample_count; i < numSamples; ++i)
   {
-    int sampleR = MathUtil::Clamp(s[0] + samples[currentSample + 0], -32767, 32767);
-    int sampleL = MathUtil::Clamp(s[1] + samples[currentSample + 1], -32767, 32767);
-
-    samples[currentSample + 0] = sampleR;
-    samples[currentSample + 1] = sampleL;
+    samples[i * 2] += (m_last_right * volume.Right(i)) >> 8;
+    samples[i * 2 + 1] += (m_last_left * volume.Left(i)) >> 8;
   }
 
-  // Flush cached variable
-  m_indexR.store(indexR);
+  m_buffer.Pop(consumed * 2);
 
   return actual_sample_count;
 }
 
+void Mixer::MixFifos(short* samples, unsigned int num_samples, bool consider_framelimit)
+{
+  while (num_samples != 0)
+  {
+    const unsigned int chunk_samples = std::min(num_samples, MAX_SAMPLES);
+
+    // All the FIFOs are summed with 32 bits of headroom and clamped once at the end.
+    std::fill_n(m_mix_buffer.begin(), chunk_samples * 2, 0);
+    m_dma_mixer.Mix(m_mix_buffer.data(), chunk_samples, consider_framelimit);
+    m_streaming_mixer.Mix(m_mix_buffer.data(), chunk_samples, consider_framelimit);
+    m_wiimote_speaker_mixer.Mix(m_mix_buffer.data(), chunk_samples, consider_framelimit);
+    PackSamples(m_mix_buffer.data(), samples, chunk_samples * 2);
+
+    samples += chunk_samples * 2;
+    num_samples -= chunk_samples;
+  }
+}
+
 unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
 {
   if (!samples)
     return 0;
 
-  memset(samples, 0, num_samples * 2 * sizeof(short));
-
   if (SConfig::GetInstance().m_audio_stretch)
   {
     unsigned int available_samples =
         std::min(m_dma_mixer.AvailableSamples(), m_streaming_mixer.AvailableSamples());
 
-    m_scratch_buffer.fill(0);
-
-    m_dma_mixer.Mix(m_scratch_buffer.data(), available_samples, false);
-    m_streaming_mixer.Mix(m_scratch_buffer.data(), available_samples, false);
-    m_wiimote_speaker_mixer.Mix(m_scratch_buffer.data(), available_samples, false);
+    MixFifos(m_scratch_buffer.data(), available_samples, false);
 
     if (!m_is_stretching)
     {
@@ -153,9 +538,7 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
   }
   else
   {
-    m_dma_mixer.Mix(samples, num_samples, true);
-    m_streaming_mixer.Mix(samples, num_samples, true);
-    m_wiimote_speaker_mixer.Mix(samples, num_samples, true);
+    MixFifos(samples, num_samples, true);
     m_is_stretching = false;
   }
 
@@ -172,11 +555,7 @@ unsigned int Mixer::MixSurround(float* samples, unsigned int num_samples)
   // Mix() may also use m_scratch_buffer internally, but is safe because it alternates reads and
   // writes.
   unsigned int available_samples = Mix(m_scratch_buffer.data(), num_samples);
-  for (size_t i = 0; i < static_cast<size_t>(available_samples) * 2; ++i)
-  {
-    m_float_conversion_buffer[i] =
-        m_scratch_buffer[i] / static_cast<float>(std::numeric_limits<short>::max());
-  }
+  ConvertToFloat(m_scratch_buffer.data(), m_float_conversion_buffer.data(), available_samples * 2);
 
   DPL2Decode(m_float_conversion_buffer.data(), available_samples, samples);
 
@@ -185,31 +564,11 @@ unsigned int Mixer::MixSurround(float* samples, unsigned int num_samples)
 
 void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_samples)
 {
-  // Cache access in non-volatile variable
-  // indexR isn't allowed to cache in the audio throttling loop as it
-  // needs to get updates to not deadlock.
-  u32 indexW = m_indexW.load();
-
-  // Check if we have enough free space
-  // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-  if (num_samples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >= MAX_SAMPLES * 2)
-    return;
-
   // AyuanX: Actual re-sampling work has been moved to sound thread
   // to alleviate the workload on main thread
   // and we simply store raw data here to make fast mem copy
-  int over_bytes = num_samples * 4 - (MAX_SAMPLES * 2 - (indexW & INDEX_MASK)) * sizeof(short);
-  if (over_bytes > 0)
-  {
-    memcpy(&m_buffer[indexW & INDEX_MASK], samples, num_samples * 4 - over_bytes);
-    memcpy(&m_buffer[0], samples + (num_samples * 4 - over_bytes) / sizeof(short), over_bytes);
-  }
-  else
-  {
-    memcpy(&m_buffer[indexW & INDEX_MASK], samples, num_samples * 4);
-  }
-
-  m_indexW.fetch_add(num_samples * 2);
+  // The whole block is dropped and counted as an overrun if there isn't enough free space.
+  m_buffer.Push(samples, num_samples * 2);
 }
 
 void Mixer::PushSamples(const short* samples, unsigned int num_samples)
@@ -366,8 +725,18 @@ void Mixer::MixerFifo::SetVolume(unsigned int lvolume, unsigned int rvolume)
 
 unsigned int Mixer::MixerFifo::AvailableSamples() const
 {
-  unsigned int samples_in_fifo = ((m_indexW.load() - m_indexR.load()) & INDEX_MASK) / 2;
-  if (samples_in_fifo <= 1)
-    return 0;  // Mixer::MixerFifo::Mix always keeps one sample in the buffer.
-  return (samples_in_fifo - 1) * m_mixer->m_sampleRate / m_input_sample_rate;
+  unsigned int samples_in_fifo = static_cast<unsigned int>(m_buffer.Size() / 2);
+  // Mixer::MixerFifo::Mix always keeps the samples that the resampler reads ahead in the buffer.
+  const u32 lookahead = GetResamplerLookahead(SConfig::GetInstance().m_audio_polyphase_resampling);
+  if (samples_in_fifo < lookahead)
+    return 0;
+  return (samples_in_fifo - (lookahead - 1)) * m_mixer->m_sampleRate / m_input_sample_rate;
+}
+
+Mixer::FifoStatistics Mixer::MixerFifo::GetStatistics() const
+{
+  const auto statistics = m_buffer.GetStatistics();
+  // The buffer holds two samples per frame.
+  return {statistics.underruns, statistics.overruns,
+          statistics.average_fill / 2 * 1000 / m_input_sample_rate};
 }
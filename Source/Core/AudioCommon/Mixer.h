@@ -10,12 +10,30 @@
 #include "AudioCommon/AudioStretcher.h"
 #include "AudioCommon/WaveFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/SPSCRingBuffer.h"
 
 class PointerWrap;
 
 class Mixer final
 {
 public:
+  struct FifoStatistics
+  {
+    // Mixes that ran out of samples while the FIFO was playing.
+    u64 underruns;
+    // Blocks of samples that were dropped because the FIFO was full.
+    u64 overruns;
+    // Average amount of audio that was buffered when it got mixed.
+    double average_latency_ms;
+  };
+
+  struct Statistics
+  {
+    FifoStatistics dma;
+    FifoStatistics streaming;
+    FifoStatistics wiimote_speaker;
+  };
+
   explicit Mixer(unsigned int BackendSampleRate);
   ~Mixer();
 
@@ -42,11 +60,13 @@ public:
   void StartLogDSPAudio(const std::string& filename);
   void StopLogDSPAudio();
 
+  // Can be called from any thread.
+  Statistics GetStatistics() const;
+
   float GetCurrentSpeed() const { return m_speed.load(); }
   void UpdateSpeed(float val) { m_speed.store(val); }
 private:
   static constexpr u32 MAX_SAMPLES = 1024 * 4;  // 128 ms
-  static constexpr u32 INDEX_MASK = MAX_SAMPLES * 2 - 1;
   static constexpr int MAX_FREQ_SHIFT = 200;  // Per 32000 Hz
   static constexpr float CONTROL_FACTOR = 0.2f;
   static constexpr u32 CONTROL_AVG = 32;  // In freq_shift per FIFO size offset
@@ -59,25 +79,41 @@ private:
     }
     void DoState(PointerWrap& p);
     void PushSamples(const short* samples, unsigned int num_samples);
-    unsigned int Mix(short* samples, unsigned int numSamples, bool consider_framelimit = true);
+    // Resamples the queued samples to the output rate and adds them, scaled by the volume, to the
+    // given 32-bit samples. Clamping the sum of all the FIFOs is left to the caller.
+    unsigned int Mix(s32* samples, unsigned int numSamples, bool consider_framelimit = true);
     void SetInputSampleRate(unsigned int rate);
     unsigned int GetInputSampleRate() const;
     void SetVolume(unsigned int lvolume, unsigned int rvolume);
     unsigned int AvailableSamples() const;
+    FifoStatistics GetStatistics() const;
 
   private:
     Mixer* m_mixer;
     unsigned m_input_sample_rate;
-    std::array<short, MAX_SAMPLES * 2> m_buffer{};
-    std::atomic<u32> m_indexW{0};
-    std::atomic<u32> m_indexR{0};
+    // Big endian stereo samples.
+    Common::SPSCRingBuffer<short, MAX_SAMPLES * 2> m_buffer;
     // Volume ranges from 0-256
     std::atomic<s32> m_LVolume{256};
     std::atomic<s32> m_RVolume{256};
+    // The volume that the last Mix call ended at, which the next one ramps from.
+    s32 m_mixed_lvolume = 256;
+    s32 m_mixed_rvolume = 256;
     float m_numLeftI = 0.0f;
     u32 m_frac = 0;
+    // The samples that Mix reads, copied out of m_buffer in host byte order with one array per
+    // channel, so that the resampling kernels don't have to handle the wrap-around.
+    std::array<s16, MAX_SAMPLES> m_left_input;
+    std::array<s16, MAX_SAMPLES> m_right_input;
+    // The last frame that Mix consumed, which is repeated when the FIFO runs out of samples.
+    s16 m_last_left = 0;
+    s16 m_last_right = 0;
+    bool m_playing = false;
   };
 
+  // Mixes all the FIFOs into samples, in chunks of at most MAX_SAMPLES.
+  void MixFifos(short* samples, unsigned int num_samples, bool consider_framelimit);
+
   MixerFifo m_dma_mixer{this, 32000};
   MixerFifo m_streaming_mixer{this, 48000};
   MixerFifo m_wiimote_speaker_mixer{this, 3000};
@@ -85,6 +121,7 @@ private:
 
   bool m_is_stretching = false;
   AudioCommon::AudioStretcher m_stretcher;
+  std::array<s32, MAX_SAMPLES * 2> m_mix_buffer;
   std::array<short, MAX_SAMPLES * 2> m_scratch_buffer;
   std::array<float, MAX_SAMPLES * 2> m_float_conversion_buffer;
 
@@ -13,6 +13,7 @@
 // - Zero backwards/forwards compatibility
 // - Serialization code for anything complex has to be manually written.
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstring>
@@ -67,6 +68,31 @@ public:
 
 public:
   PointerWrap(u8** ptr_, Mode mode_) : ptr(ptr_), mode(mode_) {}
+  // Writes to a buffer that grows as needed, which avoids having to run a MODE_MEASURE pass to
+  // size the buffer first. The existing capacity of the buffer is reused, and the buffer is
+  // resized to the number of bytes written by FinishWrite(). std::vector zero-fills whatever it
+  // is resized to beyond its size, which after the first write is only the difference between
+  // the capacity and the size of the previous write, and the space that Grow() adds.
+  explicit PointerWrap(std::vector<u8>* buffer)
+      : ptr(&m_growable_ptr), mode(MODE_WRITE), m_growable_buffer(buffer)
+  {
+    buffer->resize(buffer->capacity());
+    m_growable_ptr = buffer->data();
+  }
+  PointerWrap(const PointerWrap&) = delete;
+  PointerWrap& operator=(const PointerWrap&) = delete;
+
+  // Returns the number of bytes written to the growable buffer so far.
+  size_t GetWrittenSize() const { return *ptr - m_growable_buffer->data(); }
+
+  // Returns the number of bytes written to the growable buffer.
+  size_t FinishWrite()
+  {
+    const size_t size = GetWrittenSize();
+    m_growable_buffer->resize(size);
+    return size;
+  }
+
   void SetMode(Mode mode_) { mode = mode_; }
   Mode GetMode() const { return mode; }
   template <typename K, class V>
@@ -269,6 +295,15 @@ private:
     DoEachElement(x, [](PointerWrap& p, typename T::value_type& elem) { p.Do(elem); });
   }
 
+  void Grow(u32 size)
+  {
+    const size_t offset = *ptr - m_growable_buffer->data();
+    const size_t minimum_size = offset + size;
+    m_growable_buffer->resize(std::max({minimum_size, m_growable_buffer->size() * 2,
+                                        static_cast<size_t>(1024 * 1024)}));
+    *ptr = m_growable_buffer->data() + offset;
+  }
+
   __forceinline void DoVoid(void* data, u32 size)
   {
     switch (mode)
@@ -278,6 +313,11 @@ private:
       break;
 
     case MODE_WRITE:
+      if (m_growable_buffer &&
+          static_cast<size_t>(*ptr - m_growable_buffer->data()) + size > m_growable_buffer->size())
+      {
+        Grow(size);
+      }
       memcpy(*ptr, data, size);
       break;
 
@@ -293,4 +333,7 @@ private:
 
     *ptr += size;
   }
+
+  u8* m_growable_ptr = nullptr;
+  std::vector<u8>* m_growable_buffer = nullptr;
 };
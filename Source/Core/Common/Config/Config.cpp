@@ -57,6 +57,7 @@ void AddConfigChangedCallback(ConfigChangedCallback func)
 
 void InvokeConfigChangedCallbacks()
 {
+  detail::InvalidateCachedValues();
   for (const auto& callback : s_callbacks)
     callback();
 }
@@ -84,11 +85,13 @@ void Shutdown()
 {
   s_layers.clear();
   s_callbacks.clear();
+  detail::InvalidateCachedValues();
 }
 
 void ClearCurrentRunLayer()
 {
   s_layers[LayerType::CurrentRun] = std::make_unique<Layer>(LayerType::CurrentRun);
+  detail::InvalidateCachedValues();
 }
 
 static const std::map<System, std::string> system_to_name = {
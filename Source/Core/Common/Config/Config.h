@@ -54,7 +54,15 @@ T Get(LayerType layer, const ConfigInfo<T>& info)
 template <typename T>
 T Get(const ConfigInfo<T>& info)
 {
-  return GetLayer(GetActiveLayerForConfig(info.location))->Get(info);
+  // The version has to be read before the layers, so that a concurrent change can't be cached
+  // under the new version with the old value.
+  const u32 version = detail::GetConfigVersion();
+  if (const std::optional<T> cached = info.cached_value.Get(version))
+    return *cached;
+
+  const T value = GetLayer(GetActiveLayerForConfig(info.location))->Get(info);
+  info.cached_value.Set(version, value);
+  return value;
 }
 
 template <typename T>
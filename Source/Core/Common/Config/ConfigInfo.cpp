@@ -9,6 +9,18 @@
 
 namespace Config
 {
+namespace detail
+{
+std::atomic<u32> g_config_version{1};
+
+void InvalidateCachedValues()
+{
+  // Skip 0, which marks empty caches.
+  if (g_config_version.fetch_add(1, std::memory_order_release) + 1 == 0)
+    g_config_version.fetch_add(1, std::memory_order_release);
+}
+}
+
 bool ConfigLocation::operator==(const ConfigLocation& other) const
 {
   return system == other.system && strcasecmp(section.c_str(), other.section.c_str()) == 0 &&
@@ -4,12 +4,78 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstring>
+#include <optional>
 #include <string>
+#include <type_traits>
 
+#include "Common/CommonTypes.h"
 #include "Common/Config/Enums.h"
 
 namespace Config
 {
+namespace detail
+{
+// Incremented whenever a layer may have changed, which invalidates every cached value.
+extern std::atomic<u32> g_config_version;
+
+inline u32 GetConfigVersion()
+{
+  return g_config_version.load(std::memory_order_acquire);
+}
+
+void InvalidateCachedValues();
+
+// The value of a ConfigInfo as of a given config version. The version and the value are packed
+// together, so that a cache hit is a single atomic load. Values that don't fit (strings) are never
+// cached. Copies start out empty.
+template <typename T>
+class CachedValue
+{
+public:
+  static constexpr bool IS_CACHEABLE = std::is_trivially_copyable<T>::value && sizeof(T) <= 4;
+
+  CachedValue() = default;
+  CachedValue(const CachedValue&) {}
+  CachedValue& operator=(const CachedValue&)
+  {
+    m_data.store(0, std::memory_order_relaxed);
+    return *this;
+  }
+
+  std::optional<T> Get(u32 version) const
+  {
+    if constexpr (IS_CACHEABLE)
+    {
+      const u64 data = m_data.load(std::memory_order_relaxed);
+      if (static_cast<u32>(data >> 32) == version)
+      {
+        T value;
+        const u32 bits = static_cast<u32>(data);
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+      }
+    }
+    return std::nullopt;
+  }
+
+  void Set(u32 version, const T& value) const
+  {
+    if constexpr (IS_CACHEABLE)
+    {
+      u32 bits = 0;
+      std::memcpy(&bits, &value, sizeof(T));
+      m_data.store(static_cast<u64>(version) << 32 | bits, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  // Version 0 is never used, so a zero-initialized cache is empty.
+  mutable std::atomic<u64> m_data{0};
+};
+}
+
 struct ConfigLocation
 {
   System system;
@@ -26,5 +92,7 @@ struct ConfigInfo
 {
   ConfigLocation location;
   T default_value;
+  // Used by Config::Get.
+  detail::CachedValue<T> cached_value;
 };
 }
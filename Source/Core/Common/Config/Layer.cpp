@@ -86,6 +86,7 @@ bool Layer::DeleteKey(const ConfigLocation& location)
   m_is_dirty = true;
   bool had_value = m_map[location].has_value();
   m_map[location].reset();
+  detail::InvalidateCachedValues();
   return had_value;
 }
 
@@ -96,10 +97,13 @@ void Layer::DeleteAllKeys()
   {
     pair.second.reset();
   }
+  detail::InvalidateCachedValues();
 }
 
 Section Layer::GetSection(System system, const std::string& section)
 {
+  // The section can be modified through its iterators.
+  detail::InvalidateCachedValues();
   return Section{m_map.lower_bound(ConfigLocation{system, section, ""}),
                  m_map.lower_bound(ConfigLocation{system, section + '\001', ""})};
 }
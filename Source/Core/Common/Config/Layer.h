@@ -128,6 +128,7 @@ public:
       return;
     m_is_dirty = true;
     current_value = new_value;
+    detail::InvalidateCachedValues();
   }
 
   Section GetSection(System system, const std::string& section);
@@ -2,19 +2,31 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
 #include <cstdarg>
 #include <cstring>
+#include <ctime>
+#include <memory>
 #include <mutex>
 #include <ostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/CommonPaths.h"
 #include "Common/Config/Config.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/FileUtil.h"
 #include "Common/Logging/ConsoleListener.h"
 #include "Common/Logging/Log.h"
 #include "Common/Logging/LogManager.h"
+#include "Common/Logging/LogRing.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
 #include "Common/Timer.h"
 
 constexpr size_t MAX_MSGLEN = 1024;
@@ -26,6 +38,7 @@ const Config::ConfigInfo<bool> LOGGER_WRITE_TO_CONSOLE{
 const Config::ConfigInfo<bool> LOGGER_WRITE_TO_WINDOW{
     {Config::System::Logger, "Options", "WriteToWindow"}, true};
 const Config::ConfigInfo<int> LOGGER_VERBOSITY{{Config::System::Logger, "Options", "Verbosity"}, 0};
+const Config::ConfigInfo<bool> LOGGER_ASYNC{{Config::System::Logger, "Options", "Async"}, false};
 
 class FileLogListener : public LogListener
 {
@@ -54,6 +67,202 @@ private:
   bool m_enable;
 };
 
+// Queues messages in a ring per logging thread and passes them to the listeners on a background
+// thread, so that logging threads only pay for formatting the message text.
+class LogManager::AsyncLogger final
+{
+public:
+  explicit AsyncLogger(LogManager* manager) : m_manager(manager)
+  {
+    m_thread = std::thread(&AsyncLogger::ThreadFunc, this);
+  }
+
+  ~AsyncLogger()
+  {
+    m_exiting.Set();
+    m_wakeup.Set();
+    m_thread.join();
+  }
+
+  void Push(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
+            const char* text)
+  {
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    LogRing::Record record;
+    record.sequence = m_next_sequence.fetch_add(1, std::memory_order_relaxed);
+    record.timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+    record.file = file;
+    record.line = static_cast<u32>(line);
+    record.level = static_cast<u8>(level);
+    record.type = static_cast<u8>(type);
+    record.text_length = static_cast<u16>(strnlen(text, MAX_MSGLEN));
+
+    GetThreadRing()->ring.Push(record, text);
+
+    // Only wake up the background thread once per batch of messages.
+    if (!m_wakeup_pending.load(std::memory_order_relaxed) && !m_wakeup_pending.exchange(true))
+      m_wakeup.Set();
+  }
+
+  u64 GetLostMessageCount() const { return m_lost_messages.load(); }
+
+private:
+  struct ThreadRing
+  {
+    LogRing ring;
+    // Cleared when the thread exits. The ring is removed once it has been drained.
+    std::atomic<bool> owned{true};
+  };
+
+  struct ThreadHandle
+  {
+    ~ThreadHandle()
+    {
+      if (ring)
+        ring->owned.store(false, std::memory_order_release);
+    }
+
+    std::shared_ptr<ThreadRing> ring;
+    u32 logger_id = 0;
+  };
+
+  struct Message
+  {
+    LogRing::Record record;
+    std::string text;
+  };
+
+  ThreadRing* GetThreadRing()
+  {
+    static thread_local ThreadHandle s_handle;
+    if (s_handle.logger_id == m_id)
+      return s_handle.ring.get();
+
+    auto ring = std::make_shared<ThreadRing>();
+    {
+      std::lock_guard<std::mutex> lk(m_rings_mutex);
+      m_rings.push_back(ring);
+    }
+    if (s_handle.ring)
+      s_handle.ring->owned.store(false, std::memory_order_release);
+    s_handle.ring = std::move(ring);
+    s_handle.logger_id = m_id;
+    return s_handle.ring.get();
+  }
+
+  void ThreadFunc()
+  {
+    Common::SetCurrentThreadName("Logger thread");
+
+    while (!m_exiting.IsSet())
+    {
+      // The timeout only matters if a wakeup raced with the previous drain.
+      m_wakeup.WaitFor(std::chrono::milliseconds(100));
+      m_wakeup_pending.store(false);
+      Drain();
+    }
+
+    // Pick up whatever was logged while exiting.
+    Drain();
+  }
+
+  void Drain()
+  {
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    {
+      std::lock_guard<std::mutex> lk(m_rings_mutex);
+      rings = m_rings;
+    }
+
+    for (const auto& thread_ring : rings)
+    {
+      thread_ring->ring.PopAll([this](const LogRing::Record& record, const char* text) {
+        m_messages.push_back({record, std::string(text, record.text_length)});
+      });
+    }
+
+    // The dropped counts of the rings only ever grow, so the total is compared to the last one.
+    u64 lost = 0;
+    {
+      std::lock_guard<std::mutex> lk(m_rings_mutex);
+      for (auto it = m_rings.begin(); it != m_rings.end();)
+      {
+        const LogRing& ring = (*it)->ring;
+        if (!(*it)->owned.load(std::memory_order_acquire) && ring.Empty())
+        {
+          m_dropped_by_removed_rings += ring.GetDroppedCount();
+          it = m_rings.erase(it);
+        }
+        else
+        {
+          lost += ring.GetDroppedCount();
+          ++it;
+        }
+      }
+      lost += m_dropped_by_removed_rings;
+    }
+
+    std::sort(m_messages.begin(), m_messages.end(), [](const Message& a, const Message& b) {
+      return a.record.sequence < b.record.sequence;
+    });
+    for (const Message& message : m_messages)
+    {
+      const auto level = static_cast<LogTypes::LOG_LEVELS>(message.record.level);
+      const auto type = static_cast<LogTypes::LOG_TYPE>(message.record.type);
+      const std::string msg = StringFromFormat(
+          "%s %s:%u %c[%s]: %s\n", FormatTimestamp(message.record.timestamp_ms).c_str(),
+          message.record.file, message.record.line, LogTypes::LOG_LEVEL_TO_CHAR[(int)level],
+          m_manager->GetShortName(type), message.text.c_str());
+      m_manager->DispatchMessage(level, msg.c_str());
+    }
+    m_messages.clear();
+
+    const u64 newly_lost = lost - m_lost_messages.exchange(lost);
+    if (newly_lost)
+    {
+      const std::string msg = StringFromFormat(
+          "%s %c[%s]: %" PRIu64 " log messages were lost because the log queue was full\n",
+          FormatTimestamp(std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count())
+              .c_str(),
+          LogTypes::LOG_LEVEL_TO_CHAR[LogTypes::LWARNING],
+          m_manager->GetShortName(LogTypes::MASTER_LOG), newly_lost);
+      m_manager->DispatchMessage(LogTypes::LWARNING, msg.c_str());
+    }
+  }
+
+  // Same format as Common::Timer::GetTimeFormatted, for the time the message was logged.
+  static std::string FormatTimestamp(u64 timestamp_ms)
+  {
+    const time_t seconds = static_cast<time_t>(timestamp_ms / 1000);
+    char tmp[6];
+    strftime(tmp, sizeof(tmp), "%M:%S", localtime(&seconds));
+    return StringFromFormat("%s:%03d", tmp, static_cast<int>(timestamp_ms % 1000));
+  }
+
+  static std::atomic<u32> s_next_id;
+
+  // Distinguishes the rings of this logger from those of a previous one in the thread handles.
+  const u32 m_id = ++s_next_id;
+  LogManager* m_manager;
+  std::thread m_thread;
+  Common::Event m_wakeup;
+  std::atomic<bool> m_wakeup_pending{false};
+  Common::Flag m_exiting;
+  std::atomic<u64> m_next_sequence{0};
+  std::atomic<u64> m_lost_messages{0};
+
+  std::mutex m_rings_mutex;
+  std::vector<std::shared_ptr<ThreadRing>> m_rings;
+
+  // Only used by the background thread.
+  std::vector<Message> m_messages;
+  u64 m_dropped_by_removed_rings = 0;
+};
+
+std::atomic<u32> LogManager::AsyncLogger::s_next_id{0};
+
 void GenericLog(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
                 const char* fmt, ...)
 {
@@ -149,10 +358,16 @@ LogManager::LogManager()
         Config::ConfigInfo<bool>{{Config::System::Logger, "Logs", container.m_short_name}, false});
 
   m_path_cutoff_point = DeterminePathCutOffPoint();
+
+  if (Config::Get(LOGGER_ASYNC))
+    m_async_logger = std::make_unique<AsyncLogger>(this);
 }
 
 LogManager::~LogManager()
 {
+  // Flush the queued messages while the listeners are still alive.
+  m_async_logger.reset();
+
   // The log window listener pointer is owned by the GUI code.
   delete m_listeners[LogListener::CONSOLE_LISTENER];
   delete m_listeners[LogListener::FILE_LISTENER];
@@ -189,6 +404,12 @@ void LogManager::LogWithFullPath(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE
   char temp[MAX_MSGLEN];
   CharArrayFromFormatV(temp, MAX_MSGLEN, format, args);
 
+  if (m_async_logger)
+  {
+    m_async_logger->Push(level, type, file, line, temp);
+    return;
+  }
+
   std::string msg =
       StringFromFormat("%s %s:%u %c[%s]: %s\n", Common::Timer::GetTimeFormatted().c_str(), file,
                        line, LogTypes::LOG_LEVEL_TO_CHAR[(int)level], GetShortName(type), temp);
@@ -198,6 +419,14 @@ void LogManager::LogWithFullPath(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE
       m_listeners[listener_id]->Log(level, msg.c_str());
 }
 
+void LogManager::DispatchMessage(LogTypes::LOG_LEVELS level, const char* msg)
+{
+  std::lock_guard<std::mutex> lk(m_listener_mutex);
+  for (auto listener_id : m_listener_ids)
+    if (m_listeners[listener_id])
+      m_listeners[listener_id]->Log(level, msg);
+}
+
 LogTypes::LOG_LEVELS LogManager::GetLogLevel() const
 {
   return m_level;
@@ -230,6 +459,7 @@ const char* LogManager::GetFullName(LogTypes::LOG_TYPE type) const
 
 void LogManager::RegisterListener(LogListener::LISTENER id, LogListener* listener)
 {
+  std::lock_guard<std::mutex> lk(m_listener_mutex);
   m_listeners[id] = listener;
 }
 
@@ -243,6 +473,16 @@ bool LogManager::IsListenerEnabled(LogListener::LISTENER id) const
   return m_listener_ids[id];
 }
 
+bool LogManager::IsAsync() const
+{
+  return m_async_logger != nullptr;
+}
+
+u64 LogManager::GetLostMessageCount() const
+{
+  return m_async_logger ? m_async_logger->GetLostMessageCount() : 0;
+}
+
 // Singleton. Ugh.
 static LogManager* s_log_manager;
 
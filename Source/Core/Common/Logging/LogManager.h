@@ -6,8 +6,11 @@
 
 #include <array>
 #include <cstdarg>
+#include <memory>
+#include <mutex>
 
 #include "Common/BitSet.h"
+#include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 
 // pure virtual interface
@@ -52,9 +55,17 @@ public:
   void EnableListener(LogListener::LISTENER id, bool enable);
   bool IsListenerEnabled(LogListener::LISTENER id) const;
 
+  // In asynchronous mode, messages are queued by the logging thread and passed to the listeners
+  // by a background thread. The mode is read from the config when the LogManager is created.
+  bool IsAsync() const;
+  // Number of messages that were dropped in asynchronous mode because a queue was full.
+  u64 GetLostMessageCount() const;
+
   void SaveSettings();
 
 private:
+  class AsyncLogger;
+
   struct LogContainer
   {
     const char* m_short_name;
@@ -70,9 +81,15 @@ private:
   LogManager(LogManager&&) = delete;
   LogManager& operator=(LogManager&&) = delete;
 
+  void DispatchMessage(LogTypes::LOG_LEVELS level, const char* msg);
+
   LogTypes::LOG_LEVELS m_level;
   std::array<LogContainer, LogTypes::NUMBER_OF_LOGS> m_log{};
   std::array<LogListener*, LogListener::NUMBER_OF_LISTENERS> m_listeners{};
   BitSet32 m_listener_ids;
   size_t m_path_cutoff_point = 0;
+  // Held while passing messages to listeners in asynchronous mode, so that a listener isn't
+  // unregistered while the background thread is using it.
+  std::mutex m_listener_mutex;
+  std::unique_ptr<AsyncLogger> m_async_logger;
 };
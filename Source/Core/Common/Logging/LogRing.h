@@ -0,0 +1,121 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// A lockless single producer, single consumer ring of variable-length log records, used by the
+// asynchronous logging mode of LogManager. The producer never blocks: records that don't fit are
+// dropped and counted.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+
+#include "Common/CommonTypes.h"
+
+class LogRing final
+{
+public:
+  struct Record
+  {
+    // Global order of the record, used to merge the rings of several threads.
+    u64 sequence;
+    u64 timestamp_ms;
+    // Must outlive the record, which is the case for __FILE__.
+    const char* file;
+    u32 line;
+    u8 level;
+    u8 type;
+    u16 text_length;
+  };
+
+  static constexpr size_t SIZE = 64 * 1024;
+
+  // Producer side. Returns false and counts the record as dropped if the ring is full.
+  bool Push(const Record& record, const char* text)
+  {
+    const size_t entry_size = GetEntrySize(record.text_length);
+    const u64 write = m_write.load(std::memory_order_relaxed);
+    const u64 read = m_read.load(std::memory_order_acquire);
+
+    // Records are never split, so skip the end of the buffer if the record doesn't fit there.
+    const size_t offset = write % SIZE;
+    const size_t skip = SIZE - offset < entry_size ? SIZE - offset : 0;
+    if (write - read + skip + entry_size > SIZE)
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    if (skip >= sizeof(Record))
+    {
+      Record padding{};
+      std::memcpy(&m_data[offset], &padding, sizeof(Record));
+    }
+
+    const size_t record_offset = (write + skip) % SIZE;
+    std::memcpy(&m_data[record_offset], &record, sizeof(Record));
+    std::memcpy(&m_data[record_offset + sizeof(Record)], text, record.text_length);
+    m_write.store(write + skip + entry_size, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Calls f(const Record&, const char* text) for every available record. The text
+  // is not null terminated and is only valid during the call.
+  template <typename Function>
+  size_t PopAll(Function f)
+  {
+    u64 read = m_read.load(std::memory_order_relaxed);
+    const u64 write = m_write.load(std::memory_order_acquire);
+
+    size_t count = 0;
+    while (read != write)
+    {
+      const size_t offset = read % SIZE;
+      if (SIZE - offset < sizeof(Record))
+      {
+        read += SIZE - offset;
+        continue;
+      }
+
+      Record record;
+      std::memcpy(&record, &m_data[offset], sizeof(Record));
+      // Padding written by Push before a wrap-around.
+      if (!record.file)
+      {
+        read += SIZE - offset;
+        continue;
+      }
+
+      f(static_cast<const Record&>(record),
+        reinterpret_cast<const char*>(&m_data[offset + sizeof(Record)]));
+      read += GetEntrySize(record.text_length);
+      ++count;
+    }
+
+    m_read.store(read, std::memory_order_release);
+    return count;
+  }
+
+  bool Empty() const
+  {
+    return m_read.load(std::memory_order_acquire) == m_write.load(std::memory_order_acquire);
+  }
+
+  u64 GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr size_t GetEntrySize(size_t text_length)
+  {
+    return (sizeof(Record) + text_length + alignof(Record) - 1) & ~(alignof(Record) - 1);
+  }
+
+  // Keep the indices on separate cache lines so that the producer and consumer don't keep
+  // invalidating each other's cache.
+  alignas(64) std::atomic<u64> m_write{0};
+  alignas(64) std::atomic<u64> m_read{0};
+  std::atomic<u64> m_dropped{0};
+  alignas(alignof(Record)) std::array<u8, SIZE> m_data;
+};
@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <chrono>
+#include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
@@ -61,3 +63,23 @@ void PCAP::AddPacket(const u8* bytes, size_t size)
   m_fp->WriteBytes(&rec_hdr, sizeof(rec_hdr));
   m_fp->WriteBytes(bytes, size);
 }
+
+bool ReadPCAPFile(const std::string& filename,
+                  const std::function<void(const u8* bytes, size_t size)>& callback)
+{
+  File::IOFile file(filename, "rb");
+  PCAPHeader hdr;
+  if (!file.ReadArray(&hdr, 1) || hdr.magic_number != PCAP_MAGIC)
+    return false;
+
+  std::vector<u8> packet;
+  PCAPRecordHeader rec_hdr;
+  while (file.ReadArray(&rec_hdr, 1))
+  {
+    packet.resize(rec_hdr.size_in_file);
+    if (!file.ReadBytes(packet.data(), packet.size()))
+      return false;
+    callback(packet.data(), packet.size());
+  }
+  return file.Tell() == file.GetSize();
+}
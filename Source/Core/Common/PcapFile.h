@@ -5,7 +5,8 @@
 // PCAP is a standard file format for network capture files. This also extends
 // to any capture of packetized intercommunication data. This file provides a
 // class called PCAP which is a very light wrapper around the file format,
-// allowing only creating a new PCAP capture file and appending packets to it.
+// allowing creating a new PCAP capture file and appending packets to it, and reading the packets
+// of such a file back.
 //
 // Example use:
 //   PCAP pcap(new IOFile("test.pcap", "wb"));
@@ -14,7 +15,9 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include <memory>
+#include <string>
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
@@ -38,3 +41,8 @@ private:
 
   std::unique_ptr<File::IOFile> m_fp;
 };
+
+// Calls the callback with the contents of each packet of a PCAP file written by the PCAP class.
+// Returns false if the file couldn't be opened or isn't a PCAP file, or if it is truncated.
+bool ReadPCAPFile(const std::string& filename,
+                  const std::function<void(const u8* bytes, size_t size)>& callback);
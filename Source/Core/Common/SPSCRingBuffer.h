@@ -0,0 +1,122 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// A lockless single producer, single consumer ring buffer of trivially copyable elements, meant
+// for streams like audio where the producer pushes blocks of elements and the consumer reads them
+// in place. Each side publishes a whole batch with a single store, and the indices live on
+// separate cache lines so that the two threads don't keep invalidating each other's cache.
+//
+// The ring also counts the pushes that didn't fit (overruns), the reads that the consumer reports
+// as having run out of data (underruns) and the average amount of buffered data, which the owner
+// can read from any thread.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+template <typename T, size_t Capacity>
+class SPSCRingBuffer final
+{
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+
+public:
+  struct Statistics
+  {
+    u64 overruns;
+    u64 underruns;
+    // Average number of elements that were buffered when the consumer popped, or 0 if it never
+    // did.
+    double average_fill;
+  };
+
+  static constexpr size_t CAPACITY = Capacity;
+
+  // Producer side. Copies all the elements or, if they don't fit, none of them and counts an
+  // overrun.
+  bool Push(const T* elements, size_t count)
+  {
+    const u64 write = m_write.load(std::memory_order_relaxed);
+    const u64 read = m_read.load(std::memory_order_acquire);
+    if (count > Capacity - static_cast<size_t>(write - read))
+    {
+      m_overruns.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    const size_t offset = static_cast<size_t>(write) & MASK;
+    const size_t first_part = std::min(count, Capacity - offset);
+    std::copy_n(elements, first_part, &m_data[offset]);
+    std::copy_n(elements + first_part, count - first_part, m_data.begin());
+    m_write.store(write + count, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns the number of elements that can be read.
+  size_t Size() const
+  {
+    return static_cast<size_t>(m_write.load(std::memory_order_acquire) -
+                               m_read.load(std::memory_order_relaxed));
+  }
+
+  // Consumer side. Returns a pointer to the element at the given offset from the read position,
+  // and the number of elements that are contiguous in memory from there, which is at least 1.
+  const T* Peek(size_t offset, size_t* contiguous) const
+  {
+    const u64 read = m_read.load(std::memory_order_relaxed);
+    const size_t index = static_cast<size_t>(read + offset) & MASK;
+    *contiguous = Capacity - index;
+    return &m_data[index];
+  }
+
+  // Consumer side. Releases the given number of elements to the producer, which must not be more
+  // than Size(). Every call counts as a read for the average fill level, so it should be called
+  // once per batch, even when nothing was read.
+  void Pop(size_t count)
+  {
+    const u64 read = m_read.load(std::memory_order_relaxed);
+    const u64 fill = m_write.load(std::memory_order_acquire) - read;
+    m_fill_sum.fetch_add(fill, std::memory_order_relaxed);
+    m_reads.fetch_add(1, std::memory_order_relaxed);
+    m_read.store(read + count, std::memory_order_release);
+  }
+
+  // Consumer side. Reports that the consumer wanted more elements than were available.
+  void CountUnderrun() { m_underruns.fetch_add(1, std::memory_order_relaxed); }
+
+  // Can be called from any thread.
+  Statistics GetStatistics() const
+  {
+    const u64 reads = m_reads.load(std::memory_order_relaxed);
+    const u64 fill_sum = m_fill_sum.load(std::memory_order_relaxed);
+    return {m_overruns.load(std::memory_order_relaxed),
+            m_underruns.load(std::memory_order_relaxed),
+            reads != 0 ? static_cast<double>(fill_sum) / reads : 0.0};
+  }
+
+private:
+  static constexpr size_t MASK = Capacity - 1;
+
+  // Written by the producer.
+  alignas(64) std::atomic<u64> m_write{0};
+  std::atomic<u64> m_overruns{0};
+
+  // Written by the consumer.
+  alignas(64) std::atomic<u64> m_read{0};
+  std::atomic<u64> m_underruns{0};
+  std::atomic<u64> m_fill_sum{0};
+  std::atomic<u64> m_reads{0};
+
+  alignas(64) std::array<T, Capacity> m_data{};
+};
+}  // namespace Common
@@ -0,0 +1,309 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+
+namespace Common::Trace
+{
+std::atomic<bool> g_enabled{false};
+
+// Number of events kept per thread (8 MiB), which covers a few seconds of emulation for the
+// busiest threads. Must be a power of two.
+constexpr u64 BUFFER_SIZE = 1 << 18;
+
+enum class EventType : u8
+{
+  Slice,
+  Instant,
+  FlowStart,
+  FlowStep,
+  FlowEnd,
+};
+
+struct Event
+{
+  const char* name;
+  u64 timestamp_ns;
+  // Duration for slices, id for flows.
+  u64 arg;
+  EventType type;
+};
+
+struct ThreadBuffer
+{
+  std::array<Event, BUFFER_SIZE> events;
+  // Total number of events written in this session. Only the owning thread writes it.
+  std::atomic<u64> write_index{0};
+  // Cleared when the owning thread exits, after which the buffer may be handed to a new thread.
+  std::atomic<bool> owned{true};
+
+  // The following are guarded by s_registry_mutex.
+  u32 session = 0;
+  u32 tid = 0;
+  std::string thread_name;
+};
+
+struct ThreadHandle
+{
+  ~ThreadHandle()
+  {
+    if (buffer)
+      buffer->owned.store(false, std::memory_order_release);
+  }
+
+  ThreadBuffer* buffer = nullptr;
+  u32 session = 0;
+};
+
+static std::mutex s_registry_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+static u32 s_next_tid;
+static u64 s_session_start_ns;
+// Bumped by Start() so that threads stop writing into the buffers of the previous session.
+static std::atomic<u32> s_session{0};
+static std::atomic<u64> s_next_flow_id{0};
+
+static thread_local ThreadHandle s_thread;
+static thread_local std::string s_thread_name;
+
+u64 GetTimeNs()
+{
+  return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch())
+                              .count());
+}
+
+u64 NewFlowId()
+{
+  return ++s_next_flow_id;
+}
+
+const char* InternString(const std::string& str)
+{
+  static std::mutex mutex;
+  static std::unordered_set<std::string> strings;
+
+  std::lock_guard<std::mutex> lk(mutex);
+  return strings.insert(str).first->c_str();
+}
+
+static ThreadBuffer* AcquireBuffer(u32 session)
+{
+  std::lock_guard<std::mutex> lk(s_registry_mutex);
+
+  if (s_thread.buffer)
+    s_thread.buffer->owned.store(false, std::memory_order_release);
+
+  ThreadBuffer* buffer = nullptr;
+  for (const auto& candidate : s_buffers)
+  {
+    // Buffers left behind by exited threads still hold events of this session, which would be
+    // attributed to the wrong thread if the buffer was reused.
+    if (!candidate->owned.load(std::memory_order_acquire) &&
+        (candidate->session != session || candidate->write_index.load() == 0))
+    {
+      buffer = candidate.get();
+      break;
+    }
+  }
+  if (!buffer)
+  {
+    s_buffers.push_back(std::make_unique<ThreadBuffer>());
+    buffer = s_buffers.back().get();
+  }
+
+  buffer->write_index.store(0, std::memory_order_relaxed);
+  buffer->owned.store(true, std::memory_order_relaxed);
+  buffer->session = session;
+  buffer->tid = ++s_next_tid;
+  buffer->thread_name = s_thread_name;
+
+  s_thread.buffer = buffer;
+  s_thread.session = session;
+  return buffer;
+}
+
+static void Record(EventType type, const char* name, u64 timestamp_ns, u64 arg)
+{
+  if (!IsEnabled())
+    return;
+
+  ThreadBuffer* buffer = s_thread.buffer;
+  const u32 session = s_session.load(std::memory_order_acquire);
+  if (!buffer || s_thread.session != session)
+    buffer = AcquireBuffer(session);
+
+  const u64 index = buffer->write_index.load(std::memory_order_relaxed);
+  buffer->events[index & (BUFFER_SIZE - 1)] = {name, timestamp_ns, arg, type};
+  buffer->write_index.store(index + 1, std::memory_order_release);
+}
+
+void Slice(const char* name, u64 start_ns, u64 end_ns)
+{
+  Record(EventType::Slice, name, start_ns, end_ns - start_ns);
+}
+
+void Instant(const char* name)
+{
+  Record(EventType::Instant, name, GetTimeNs(), 0);
+}
+
+void FlowStart(const char* name, u64 id)
+{
+  Record(EventType::FlowStart, name, GetTimeNs(), id);
+}
+
+void FlowStep(const char* name, u64 id)
+{
+  Record(EventType::FlowStep, name, GetTimeNs(), id);
+}
+
+void FlowEnd(const char* name, u64 id)
+{
+  Record(EventType::FlowEnd, name, GetTimeNs(), id);
+}
+
+void SetThreadName(const char* name)
+{
+  s_thread_name = name;
+
+  if (s_thread.buffer)
+  {
+    std::lock_guard<std::mutex> lk(s_registry_mutex);
+    s_thread.buffer->thread_name = name;
+  }
+}
+
+void Start()
+{
+  {
+    std::lock_guard<std::mutex> lk(s_registry_mutex);
+    s_session_start_ns = GetTimeNs();
+    s_next_tid = 0;
+    s_session++;
+  }
+  g_enabled.store(true);
+}
+
+void Stop()
+{
+  g_enabled.store(false);
+}
+
+static std::string EscapeJSON(const char* str)
+{
+  std::string escaped;
+  for (; *str; ++str)
+  {
+    if (*str == '"' || *str == '\\')
+      escaped += '\\';
+    if (static_cast<unsigned char>(*str) >= 0x20)
+      escaped += *str;
+  }
+  return escaped;
+}
+
+static std::string FormatEvent(const Event& event, u32 tid)
+{
+  static constexpr std::array<char, 5> phases = {{'X', 'i', 's', 't', 'f'}};
+
+  const double ts = static_cast<s64>(event.timestamp_ns - s_session_start_ns) / 1000.0;
+  std::string str =
+      StringFromFormat("{\"name\":\"%s\",\"cat\":\"dolphin\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,"
+                       "\"tid\":%u",
+                       EscapeJSON(event.name).c_str(), phases[static_cast<size_t>(event.type)], ts,
+                       tid);
+
+  switch (event.type)
+  {
+  case EventType::Slice:
+    str += StringFromFormat(",\"dur\":%.3f", event.arg / 1000.0);
+    break;
+  case EventType::Instant:
+    str += ",\"s\":\"t\"";
+    break;
+  case EventType::FlowStart:
+    str += StringFromFormat(",\"id\":%" PRIu64, event.arg);
+    break;
+  case EventType::FlowStep:
+  case EventType::FlowEnd:
+    // Bind to the enclosing slice rather than to the next one.
+    str += StringFromFormat(",\"id\":%" PRIu64 ",\"bp\":\"e\"", event.arg);
+    break;
+  }
+
+  return str + "}";
+}
+
+bool WriteChromeTrace(const std::string& path)
+{
+  std::ofstream file;
+  File::OpenFStream(file, path, std::ios_base::out | std::ios_base::trunc);
+  if (!file.is_open())
+  {
+    ERROR_LOG(COMMON, "Failed to open trace file %s", path.c_str());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lk(s_registry_mutex);
+  const u32 session = s_session.load();
+
+  file << "{\"traceEvents\":[\n";
+  file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Dolphin\"}}";
+
+  u64 dropped_events = 0;
+  std::vector<Event> events;
+  for (const auto& buffer : s_buffers)
+  {
+    if (buffer->session != session)
+      continue;
+
+    const std::string thread_name = buffer->thread_name.empty() ?
+                                        StringFromFormat("Thread %u", buffer->tid) :
+                                        buffer->thread_name;
+    file << StringFromFormat(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                             "\"args\":{\"name\":\"%s\"}}",
+                             buffer->tid, EscapeJSON(thread_name.c_str()).c_str());
+
+    // The owning thread may still be running, so copy the events out first and drop the ones
+    // that it overwrote in the meantime.
+    const u64 end = buffer->write_index.load(std::memory_order_acquire);
+    const u64 begin = end > BUFFER_SIZE ? end - BUFFER_SIZE : 0;
+    events.clear();
+    for (u64 i = begin; i < end; ++i)
+      events.push_back(buffer->events[i & (BUFFER_SIZE - 1)]);
+
+    // The owning thread may be writing event new_end, which goes in the slot of event
+    // new_end - BUFFER_SIZE, so that one isn't valid either.
+    const u64 new_end = buffer->write_index.load(std::memory_order_acquire);
+    const u64 valid_begin =
+        new_end + 1 > BUFFER_SIZE ? std::max(begin, new_end + 1 - BUFFER_SIZE) : 0;
+    dropped_events += valid_begin;
+
+    for (u64 i = valid_begin; i < end; ++i)
+      file << ",\n" << FormatEvent(events[i - begin], buffer->tid);
+  }
+
+  file << StringFromFormat("\n],\"otherData\":{\"dropped_events\":\"%" PRIu64 "\"}}\n",
+                           dropped_events);
+
+  INFO_LOG(COMMON, "Wrote trace to %s (%" PRIu64 " events dropped)", path.c_str(),
+           dropped_events);
+  return file.good();
+}
+}  // namespace Common::Trace
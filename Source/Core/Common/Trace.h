@@ -0,0 +1,76 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Timeline tracer that records what the emulator threads (CPU, GPU, DSP, DVD...) are doing and
+// how they hand work to each other, for viewing in chrome://tracing or ui.perfetto.dev.
+//
+// Every thread writes into its own fixed-size ring buffer without taking any lock; when a ring
+// is full the oldest events of that thread are overwritten. Event names are stored as raw
+// pointers, so they must be string literals or strings returned by InternString().
+//
+// Flows draw an arrow from the slice enclosing FlowStart() to the slices enclosing the matching
+// FlowStep()/FlowEnd() calls. Flows are matched by name and id.
+namespace Common::Trace
+{
+extern std::atomic<bool> g_enabled;
+
+inline bool IsEnabled()
+{
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+// Discards the events of the previous session and starts recording.
+void Start();
+void Stop();
+
+// Writes the recorded events in the Chrome JSON trace event format. Should be called after
+// Stop(), once the traced threads are idle.
+bool WriteChromeTrace(const std::string& path);
+
+// Called by Common::SetCurrentThreadName.
+void SetThreadName(const char* name);
+
+// Returns a pointer to a copy of the string that stays valid until the process exits.
+const char* InternString(const std::string& str);
+
+u64 GetTimeNs();
+// Returns a process-wide unique, non-zero id for flows that don't have a natural id.
+u64 NewFlowId();
+
+void Slice(const char* name, u64 start_ns, u64 end_ns);
+void Instant(const char* name);
+void FlowStart(const char* name, u64 id);
+void FlowStep(const char* name, u64 id);
+void FlowEnd(const char* name, u64 id);
+
+// Records the enclosing scope as a slice.
+class ScopedSlice final
+{
+public:
+  explicit ScopedSlice(const char* name) : m_name(name)
+  {
+    if (IsEnabled())
+      m_start_ns = GetTimeNs();
+  }
+  ~ScopedSlice()
+  {
+    if (m_start_ns)
+      Slice(m_name, m_start_ns, GetTimeNs());
+  }
+
+  ScopedSlice(const ScopedSlice&) = delete;
+  ScopedSlice& operator=(const ScopedSlice&) = delete;
+
+private:
+  const char* m_name;
+  u64 m_start_ns = 0;
+};
+}  // namespace Common::Trace
@@ -28,6 +28,7 @@ extern const ConfigInfo<bool> MAIN_DPL2_DECODER;
 extern const ConfigInfo<int> MAIN_AUDIO_LATENCY;
 extern const ConfigInfo<bool> MAIN_AUDIO_STRETCH;
 extern const ConfigInfo<int> MAIN_AUDIO_STRETCH_LATENCY;
+extern const ConfigInfo<bool> MAIN_AUDIO_POLYPHASE_RESAMPLING;
 extern const ConfigInfo<std::string> MAIN_MEMCARD_A_PATH;
 extern const ConfigInfo<std::string> MAIN_MEMCARD_B_PATH;
 extern const ConfigInfo<std::string> MAIN_AGP_CART_A_PATH;
@@ -64,6 +65,10 @@ extern const ConfigInfo<bool> MAIN_OVERCLOCK_ENABLE;
 extern const ConfigInfo<std::string> MAIN_GFX_BACKEND;
 extern const ConfigInfo<std::string> MAIN_GPU_DETERMINISM_MODE;
 extern const ConfigInfo<std::string> MAIN_PERF_MAP_DIR;
+// Path of the Chrome trace file the thread timeline is written to. Tracing is off when empty.
+extern const ConfigInfo<std::string> MAIN_TRACE_FILE;
+// Serialize the emulated memory of save states from a copy-on-write snapshot, in the background.
+extern const ConfigInfo<bool> MAIN_BACKGROUND_SAVE_STATES;
 extern const ConfigInfo<bool> MAIN_CUSTOM_RTC_ENABLE;
 extern const ConfigInfo<u32> MAIN_CUSTOM_RTC_VALUE;
 extern const ConfigInfo<bool> MAIN_ENABLE_SIGNATURE_CHECKS;
@@ -21,6 +21,7 @@
 #include "Common/CPUDetect.h"
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/FileUtil.h"
 #include "Common/Flag.h"
 #include "Common/Logging/LogManager.h"
@@ -30,9 +31,11 @@
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/Trace.h"
 
 #include "Core/Analytics.h"
 #include "Core/BootManager.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/DSPEmulator.h"
@@ -50,6 +53,7 @@
 #include "Core/HW/GCKeyboard.h"
 #include "Core/HW/GCPad.h"
 #include "Core/HW/HW.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/Wiimote.h"
@@ -334,7 +338,10 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
   // This needs to be delayed until after the video backend is ready.
   DolphinAnalytics::Instance()->ReportGameStart();
 
-  if (_CoreParameter.bFastmem)
+  // Background save states write-protect the emulated memory and rely on the handler too.
+  const bool exception_handler =
+      _CoreParameter.bFastmem || Config::Get(Config::MAIN_BACKGROUND_SAVE_STATES);
+  if (exception_handler)
     EMM::InstallExceptionHandler();  // Let's run under memory watch
 
 #ifdef USE_MEMORYWATCHER
@@ -373,8 +380,11 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
 
   s_is_started = false;
 
-  if (_CoreParameter.bFastmem)
+  if (exception_handler)
+  {
+    Memory::FinishSnapshotCapture();
     EMM::UninstallExceptionHandler();
+  }
 }
 
 static void FifoPlayerThread(const std::optional<std::string>& savestate_path,
@@ -431,6 +441,18 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
     INFO_LOG(CONSOLE, "Stop\t\t---- Shutdown complete ----");
   }};
 
+  const std::string trace_file = Config::Get(Config::MAIN_TRACE_FILE);
+  if (!trace_file.empty())
+    Common::Trace::Start();
+  // Declared early so that all the emulation threads have been joined when the trace is written.
+  Common::ScopeGuard trace_guard{[trace_file] {
+    if (trace_file.empty())
+      return;
+
+    Common::Trace::Stop();
+    Common::Trace::WriteChromeTrace(trace_file);
+  }};
+
   Common::SetCurrentThreadName("Emuthread - Starting");
 
   // For a time this acts as the CPU thread...
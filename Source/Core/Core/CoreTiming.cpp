@@ -17,6 +17,7 @@
 #include "Common/SPSCQueue.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
+#include "Common/Trace.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -31,6 +32,8 @@ struct EventType
 {
   TimedCallback callback;
   const std::string* name;
+  // Copy of the name that outlives the event type, for the trace timeline.
+  const char* trace_name;
 };
 
 struct Event
@@ -39,6 +42,9 @@ struct Event
   u64 fifo_order;
   u64 userdata;
   EventType* type;
+  // Links the dispatch of events scheduled from other threads to where they were scheduled.
+  // Not saved in save states.
+  u64 trace_flow_id = 0;
 };
 
 // Sort by time, unless the times are the same, in which case sort by the order added to the queue
@@ -109,7 +115,8 @@ EventType* RegisterEvent(const std::string& name, TimedCallback callback)
              "during Init to avoid breaking save states.",
              name.c_str());
 
-  auto info = s_event_types.emplace(name, EventType{callback, nullptr});
+  auto info =
+      s_event_types.emplace(name, EventType{callback, nullptr, Common::Trace::InternString(name)});
   EventType* event_type = &info.first->second;
   event_type->name = &info.first->first;
   return event_type;
@@ -265,8 +272,16 @@ void ScheduleEvent(s64 cycles_into_future, EventType* event_type, u64 userdata,
                 event_type->name->c_str());
     }
 
+    u64 trace_flow_id = 0;
+    if (Common::Trace::IsEnabled())
+    {
+      trace_flow_id = Common::Trace::NewFlowId();
+      Common::Trace::FlowStart("ScheduleEvent", trace_flow_id);
+    }
+
     std::lock_guard<std::mutex> lk(s_ts_write_lock);
-    s_ts_queue.Push(Event{g.global_timer + cycles_into_future, 0, userdata, event_type});
+    s_ts_queue.Push(
+        Event{g.global_timer + cycles_into_future, 0, userdata, event_type, trace_flow_id});
   }
 }
 
@@ -330,6 +345,9 @@ void Advance()
     s_event_queue.pop_back();
     // NOTICE_LOG(POWERPC, "[Scheduler] %-20s (%lld, %lld)", evt.type->name->c_str(),
     //            g.global_timer, evt.time);
+    Common::Trace::ScopedSlice trace_slice(evt.type->trace_name);
+    if (evt.trace_flow_id)
+      Common::Trace::FlowEnd("ScheduleEvent", evt.trace_flow_id);
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
   }
 
@@ -4,6 +4,9 @@
 
 #include "Core/DSP/DSPAccelerator.h"
 
+#include <algorithm>
+#include <array>
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -160,6 +163,68 @@ u16 Accelerator::Read(s16* coefs)
   return val;
 }
 
+void Accelerator::ReadSamples(s16* coefs, u16* samples, u32 count)
+{
+  u32 i = 0;
+  while (i < count)
+  {
+    if (m_sample_format == 0x00 && !m_reads_stopped)
+    {
+      // The last sample of a frame loads the header of the next one, and the samples around the
+      // end address trigger the loop handling, so these go through Read().
+      const u32 frame_last = m_current_address | 0xf;
+      if (m_end_address + 1 < m_current_address || m_end_address > frame_last + 1)
+      {
+        const u32 run = std::min(count - i, frame_last - m_current_address);
+        if (run != 0)
+        {
+          DecodeADPCMSamples(coefs, samples + i, run);
+          i += run;
+          continue;
+        }
+      }
+    }
+
+    samples[i++] = Read(coefs);
+  }
+}
+
+void Accelerator::DecodeADPCMSamples(const s16* coefs, u16* samples, u32 count)
+{
+  const s32 scale = 1 << (m_pred_scale & 0xF);
+  const int coef_idx = (m_pred_scale >> 4) & 0x7;
+  const s32 coef1 = coefs[coef_idx * 2 + 0];
+  const s32 coef2 = coefs[coef_idx * 2 + 1];
+
+  // A frame is 8 bytes, so this reads each byte once instead of once per nibble.
+  const u32 first_byte = m_current_address >> 1;
+  const u32 byte_count = ((m_current_address + count - 1) >> 1) - first_byte + 1;
+  std::array<u8, 8> bytes;
+  for (u32 i = 0; i < byte_count; ++i)
+    bytes[i] = ReadMemory(first_byte + i);
+
+  s32 yn1 = m_yn1;
+  s32 yn2 = m_yn2;
+  for (u32 i = 0; i < count; ++i)
+  {
+    const u32 address = m_current_address + i;
+    // High nibble first, then sign extended.
+    const u32 nibble = (bytes[(address >> 1) - first_byte] >> (~address & 1) * 4) & 0xF;
+    const s32 temp = static_cast<s32>(nibble << 28) >> 28;
+
+    const s32 val32 = (scale * temp) + ((0x400 + coef1 * yn1 + coef2 * yn2) >> 11);
+    const s16 val = static_cast<s16>(MathUtil::Clamp<s32>(val32, -0x7FFF, 0x7FFF));
+    samples[i] = static_cast<u16>(val);
+
+    yn2 = yn1;
+    yn1 = val;
+  }
+
+  m_yn1 = static_cast<s16>(yn1);
+  m_yn2 = static_cast<s16>(yn2);
+  SetCurrentAddress(m_current_address + count);
+}
+
 void Accelerator::DoState(PointerWrap& p)
 {
   p.Do(m_start_address);
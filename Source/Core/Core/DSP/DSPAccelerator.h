@@ -16,6 +16,9 @@ public:
   virtual ~Accelerator() = default;
 
   u16 Read(s16* coefs);
+  // Reads count samples, exactly like calling Read() count times would. ADPCM samples that
+  // can't reach the end address or the next frame header are decoded a frame at a time.
+  void ReadSamples(s16* coefs, u16* samples, u32 count);
   // Zelda ucode reads ARAM through 0xffd3.
   u16 ReadD3();
   void WriteD3(u16 value);
@@ -38,6 +41,9 @@ public:
   void DoState(PointerWrap& p);
 
 protected:
+  // Decodes count ADPCM samples that stay within the current frame and before the end address.
+  void DecodeADPCMSamples(const s16* coefs, u16* samples, u32 count);
+
   virtual void OnEndException() = 0;
   virtual u8 ReadMemory(u32 address) = 0;
   virtual void WriteMemory(u32 address, u8 value) = 0;
@@ -6,11 +6,14 @@
 
 #include <cstring>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
 #include "Common/PcapFile.h"
+#include "Core/DSP/DSPCore.h"
 
 namespace DSP
 {
@@ -80,4 +83,58 @@ void PCAPDSPCaptureLogger::LogDMA(u16 control, u32 gc_address, u16 dsp_address,
 
   m_pcap->AddPacket(buffer, sizeof(DMAPacket) + length);
 }
+
+std::optional<DSPCaptureTrace> ReadDSPCaptureTrace(const std::string& pcap_filename)
+{
+  DSPCaptureTrace trace;
+  bool ucode_uploaded = false;
+  u16 cpu_mail_high = 0;
+
+  const auto parse_packet = [&](const u8* bytes, size_t size) {
+    if (size >= sizeof(IFXAccessPacket) && bytes[0] == IFX_ACCESS_PACKET_MAGIC)
+    {
+      IFXAccessPacket pkt;
+      std::memcpy(&pkt, bytes, sizeof(pkt));
+      if (!pkt.is_read || !ucode_uploaded)
+        return;
+
+      // The DSP polls the high half of the CPU mailbox until it has a mail, then reads the low
+      // half, which acknowledges the mail.
+      if ((pkt.address & 0xff) == DSP_CMBH)
+        cpu_mail_high = pkt.value;
+      else if ((pkt.address & 0xff) == DSP_CMBL && (cpu_mail_high & 0x8000))
+        trace.cpu_mails.push_back(static_cast<u32>(cpu_mail_high) << 16 | pkt.value);
+    }
+    else if (size >= sizeof(DMAPacket) && bytes[0] == DMA_PACKET_MAGIC)
+    {
+      DMAPacket pkt;
+      std::memcpy(&pkt, bytes, sizeof(pkt));
+      if (pkt.dma_control & DSP_CR_TO_CPU || size - sizeof(pkt) < pkt.length)
+        return;
+
+      if (ucode_uploaded)
+      {
+        const u8* data = bytes + sizeof(pkt);
+        trace.dmas_from_cpu.push_back({pkt.dma_control, pkt.gc_address, pkt.dsp_address,
+                                       std::vector<u8>(data, data + pkt.length)});
+      }
+      else if (pkt.dma_control & DSP_CR_IMEM)
+      {
+        ucode_uploaded = true;
+      }
+    }
+  };
+
+  if (!ReadPCAPFile(pcap_filename, parse_packet))
+    return std::nullopt;
+
+  // Captures that don't include the upload of the ucode are replayed from their start.
+  if (!ucode_uploaded)
+  {
+    ucode_uploaded = true;
+    ReadPCAPFile(pcap_filename, parse_packet);
+  }
+
+  return trace;
+}
 }  // namespace DSP
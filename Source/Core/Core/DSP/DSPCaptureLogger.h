@@ -5,7 +5,9 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
@@ -71,4 +73,28 @@ private:
 
   std::unique_ptr<PCAP> m_pcap;
 };
+
+struct CapturedDMA
+{
+  u16 control;
+  u32 gc_address;
+  u16 dsp_address;
+  // The copied data as it is in the DSP memory, which is in host byte order.
+  std::vector<u8> data;
+};
+
+// What the CPU sent to the DSP during a capture, which is what has to be fed back to the DSP to
+// replay it.
+struct DSPCaptureTrace
+{
+  // Mails from the CPU, in the order in which the DSP read them.
+  std::vector<u32> cpu_mails;
+  // DMAs from the main memory to the DSP memory, in order.
+  std::vector<CapturedDMA> dmas_from_cpu;
+};
+
+// Reads a capture written by PCAPDSPCaptureLogger. The trace starts after the first DMA to the
+// IRAM, which is the upload of the ucode, so that it can be replayed on a freshly loaded ucode.
+// Returns std::nullopt if the file couldn't be read.
+std::optional<DSPCaptureTrace> ReadDSPCaptureTrace(const std::string& pcap_filename);
 }  // namespace DSP
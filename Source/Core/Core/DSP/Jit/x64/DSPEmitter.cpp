@@ -30,7 +30,7 @@ constexpr u16 DSP_IDLE_SKIP_CYCLES = 0x1000;
 
 DSPEmitter::DSPEmitter()
     : m_compile_status_register{SR_INT_ENABLE | SR_EXT_INT_ENABLE}, m_blocks(MAX_BLOCKS),
-      m_block_size(MAX_BLOCKS), m_block_links(MAX_BLOCKS)
+      m_block_size(MAX_BLOCKS), m_block_links(MAX_BLOCKS), m_unresolved_jumps(MAX_BLOCKS)
 {
   AllocCodeSpace(COMPILED_CODE_SIZE);
 
@@ -79,6 +79,7 @@ void DSPEmitter::ClearIRAM()
     m_block_size[i] = 0;
     m_unresolved_jumps[i].clear();
   }
+  ForgetResolvedBlocks();
   g_dsp.reset_dspjit_codespace = true;
 }
 
@@ -95,6 +96,7 @@ void DSPEmitter::ClearIRAMandDSPJITCodespaceReset()
     m_block_size[i] = 0;
     m_unresolved_jumps[i].clear();
   }
+  m_blocks_with_unresolved_jumps.clear();
   g_dsp.reset_dspjit_codespace = false;
 }
 
@@ -118,6 +120,57 @@ void DSPEmitter::checkExceptions(u32 retval)
   SetJumpTarget(skipCheck);
 }
 
+// Runs the block being compiled again without going through the dispatcher if it would run it
+// next. The register cache must have been flushed, which keeps the accumulators in host registers.
+void DSPEmitter::WriteBlockLoopBack()
+{
+  TEST(8, M_SDSP_cr(), Imm8(CR_HALT));
+  FixupBranch halted = J_CC(CC_NZ);
+  FixupBranch interrupted;
+  if (Host::OnThread())
+  {
+    CMP(8, M_SDSP_external_interrupt_waiting(), Imm8(0));
+    interrupted = J_CC(CC_NE);
+  }
+
+  // The final size of the block isn't known yet, so make sure that a run of the largest possible
+  // block fits in the remaining cycles.
+  MOV(64, R(RAX), ImmPtr(&m_cycles_left));
+  MOV(16, R(ECX), MatR(RAX));
+  CMP(16, R(ECX), Imm16(static_cast<u16>(m_block_size[m_start_address] + MAX_BLOCK_SIZE)));
+  FixupBranch not_enough_cycles = J_CC(CC_BE);
+
+  SUB(16, R(ECX), Imm16(m_block_size[m_start_address]));
+  MOV(16, MatR(RAX), R(ECX));
+  JMP(m_block_link_entry, true);
+
+  SetJumpTarget(not_enough_cycles);
+  SetJumpTarget(halted);
+  if (Host::OnThread())
+    SetJumpTarget(interrupted);
+}
+
+void DSPEmitter::AddUnresolvedJump(u16 dest)
+{
+  std::vector<u16>& jumps = m_unresolved_jumps[m_start_address];
+  if (jumps.empty() && std::find(m_blocks_with_unresolved_jumps.begin(),
+                                 m_blocks_with_unresolved_jumps.end(),
+                                 m_start_address) == m_blocks_with_unresolved_jumps.end())
+  {
+    m_blocks_with_unresolved_jumps.push_back(m_start_address);
+  }
+  jumps.push_back(dest);
+}
+
+void DSPEmitter::ForgetResolvedBlocks()
+{
+  const auto is_resolved = [this](u16 block) { return m_unresolved_jumps[block].empty(); };
+  m_blocks_with_unresolved_jumps.erase(std::remove_if(m_blocks_with_unresolved_jumps.begin(),
+                                                      m_blocks_with_unresolved_jumps.end(),
+                                                      is_resolved),
+                                       m_blocks_with_unresolved_jumps.end());
+}
+
 bool DSPEmitter::FlagsNeeded() const
 {
   const u8 flags = Analyzer::GetCodeFlags(m_compile_pc);
@@ -239,7 +292,8 @@ void DSPEmitter::Compile(u16 start_addr)
     m_compile_pc += opcode->size;
 
     // If the block was trying to link into itself, remove the link
-    m_unresolved_jumps[start_addr].remove(m_compile_pc);
+    std::vector<u16>& jumps = m_unresolved_jumps[start_addr];
+    jumps.erase(std::remove(jumps.begin(), jumps.end(), m_compile_pc), jumps.end());
 
     fixup_pc = true;
 
@@ -265,6 +319,16 @@ void DSPEmitter::Compile(u16 start_addr)
       // end of each block and in this order
       DSPJitRegCache c(m_gpr);
       HandleLoop();
+      if (!(Analyzer::GetCodeFlags(start_addr) & Analyzer::CODE_IDLE_SKIP))
+      {
+        // Loops usually start at the beginning of the block (right after the BLOOP), so keep
+        // running their body here instead of returning to the dispatcher on every iteration.
+        m_gpr.FlushRegs();
+        CMP(16, M_SDSP_pc(), Imm16(start_addr));
+        FixupBranch not_block_start = J_CC(CC_NE, true);
+        WriteBlockLoopBack();
+        SetJumpTarget(not_block_start);
+      }
       m_gpr.SaveRegs();
       if (!Host::OnThread() && Analyzer::GetCodeFlags(start_addr) & Analyzer::CODE_IDLE_SKIP)
       {
@@ -336,22 +400,21 @@ void DSPEmitter::Compile(u16 start_addr)
   {
     m_block_links[start_addr] = m_block_link_entry;
 
-    for (size_t i = 0; i < 0xffff; ++i)
+    for (u16 block : m_blocks_with_unresolved_jumps)
     {
-      if (!m_unresolved_jumps[i].empty())
+      // Check if there were any blocks waiting for this block to be linkable
+      std::vector<u16>& jumps = m_unresolved_jumps[block];
+      const auto new_end = std::remove(jumps.begin(), jumps.end(), start_addr);
+      if (new_end != jumps.end())
       {
-        // Check if there were any blocks waiting for this block to be linkable
-        size_t size = m_unresolved_jumps[i].size();
-        m_unresolved_jumps[i].remove(start_addr);
-        if (m_unresolved_jumps[i].size() < size)
-        {
-          // Mark the block to be recompiled again
-          m_blocks[i] = (DSPCompiledCode)m_stub_entry_point;
-          m_block_links[i] = nullptr;
-          m_block_size[i] = 0;
-        }
+        jumps.erase(new_end, jumps.end());
+        // Mark the block to be recompiled again
+        m_blocks[block] = (DSPCompiledCode)m_stub_entry_point;
+        m_block_links[block] = nullptr;
+        m_block_size[block] = 0;
       }
     }
+    ForgetResolvedBlocks();
   }
 
   if (m_block_size[start_addr] == 0)
@@ -374,28 +437,27 @@ void DSPEmitter::Compile(u16 start_addr)
   JMP(m_return_dispatcher, true);
 }
 
-static void CompileCurrent()
+void DSPEmitter::CompileUnresolvedJumps()
 {
-  g_dsp_jit->Compile(g_dsp.pc);
-
-  bool retry = true;
-
-  while (retry)
+  while (!m_blocks_with_unresolved_jumps.empty())
   {
-    retry = false;
-    for (size_t i = 0; i < 0xffff; ++i)
+    // Compile() updates the list of blocks, so go through a copy of it.
+    const std::vector<u16> blocks = m_blocks_with_unresolved_jumps;
+    for (u16 block : blocks)
     {
-      if (!g_dsp_jit->m_unresolved_jumps[i].empty())
-      {
-        const u16 address_to_compile = g_dsp_jit->m_unresolved_jumps[i].front();
-        g_dsp_jit->Compile(address_to_compile);
-        if (!g_dsp_jit->m_unresolved_jumps[i].empty())
-          retry = true;
-      }
+      if (!m_unresolved_jumps[block].empty())
+        Compile(m_unresolved_jumps[block].front());
     }
+    ForgetResolvedBlocks();
   }
 }
 
+static void CompileCurrent()
+{
+  g_dsp_jit->Compile(g_dsp.pc);
+  g_dsp_jit->CompileUnresolvedJumps();
+}
+
 const u8* DSPEmitter::CompileStub()
 {
   const u8* entryPoint = AlignCode16();
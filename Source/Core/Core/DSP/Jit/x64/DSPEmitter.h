@@ -6,7 +6,6 @@
 
 #include <array>
 #include <cstddef>
-#include <list>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -205,11 +204,16 @@ public:
   void madd(UDSPInstruction opc);
   void msub(UDSPInstruction opc);
 
-  std::array<std::list<u16>, MAX_BLOCKS> m_unresolved_jumps;
+  // Compiles the destinations of the jumps that couldn't be linked yet, and recompiles the
+  // blocks that were waiting on them, until every block is linked.
+  void CompileUnresolvedJumps();
 
 private:
   void WriteBranchExit();
   void WriteBlockLink(u16 dest);
+  void WriteBlockLoopBack();
+  void AddUnresolvedJump(u16 dest);
+  void ForgetResolvedBlocks();
 
   void ReJitConditional(UDSPInstruction opc, void (DSPEmitter::*conditional_fn)(UDSPInstruction));
   void r_jcc(UDSPInstruction opc);
@@ -307,6 +311,13 @@ private:
   std::vector<Block> m_block_links;
   Block m_block_link_entry;
 
+  // Destinations of the direct jumps of each block that couldn't be linked yet because they
+  // weren't compiled. These are usually a handful of entries, so a vector is cheaper than a list.
+  std::vector<std::vector<u16>> m_unresolved_jumps;
+  // Blocks with unresolved jumps, so that they don't have to be searched for in the whole
+  // address space every time a block is compiled.
+  std::vector<u16> m_blocks_with_unresolved_jumps;
+
   u16 m_cycles_left = 0;
 
   // The index of the last stored ext value (compile time).
@@ -98,6 +98,16 @@ void DSPEmitter::WriteBranchExit()
 
 void DSPEmitter::WriteBlockLink(u16 dest)
 {
+  // Loop back to the start of this block unless it is an idle loop, which must give up its time
+  // slice. An empty block would loop without using up any cycles.
+  if (dest == m_start_address && m_block_size[m_start_address] != 0 &&
+      !(Analyzer::GetCodeFlags(m_start_address) & Analyzer::CODE_IDLE_SKIP))
+  {
+    m_gpr.FlushRegs();
+    WriteBlockLoopBack();
+    return;
+  }
+
   // Jump directly to the called block if it has already been compiled.
   if (!(dest >= m_start_address && dest <= m_compile_pc))
   {
@@ -119,7 +129,7 @@ void DSPEmitter::WriteBlockLink(u16 dest)
     {
       // The destination has not been compiled yet.  Add it to the list
       // of blocks that this block is waiting on.
-      m_unresolved_jumps[m_start_address].push_back(dest);
+      AddUnresolvedJump(dest);
     }
   }
 }
@@ -12,7 +12,9 @@
 #error AXVoice.h included without specifying version
 #endif
 
+#include <algorithm>
 #include <functional>
+#include <iterator>
 #include <memory>
 
 #include "Common/CommonTypes.h"
@@ -228,16 +230,20 @@ void AcceleratorSetup(PB_TYPE* pb)
   acc_end_reached = false;
 }
 
-// Reads a sample from the accelerator. Also handles looping and
+// Reads <count> samples from the accelerator. Also handles looping and
 // disabling streams that reached the end (this is done by an exception raised
 // by the accelerator on real hardware).
-u16 AcceleratorGetSample()
+void AcceleratorGetSamples(u16* samples, u32 count)
 {
-  // See below for explanations about acc_end_reached.
+  // See below for explanations about acc_end_reached. Once the end is reached in the middle of
+  // the samples, the accelerator stops reads and returns zeros as well.
   if (acc_end_reached)
-    return 0;
+  {
+    std::fill_n(samples, count, 0);
+    return;
+  }
 
-  return s_accelerator->Read(acc_pb->adpcm.coefs);
+  s_accelerator->ReadSamples(acc_pb->adpcm.coefs, samples, count);
 }
 
 // Reads samples from the input callback, resamples them to <count> samples at
@@ -375,6 +381,22 @@ u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count
   return curr_pos;
 }
 
+// Returns how many input samples ResampleAudio reads to produce <count> samples.
+u32 GetResampleInputCount(u32 count, u32 curr_pos, u32 ratio, int srctype)
+{
+  if (srctype != SRCTYPE_LINEAR && srctype != SRCTYPE_POLYPHASE)
+    return count;
+
+  u32 input_count = 0;
+  for (u32 i = 0; i < count; ++i)
+  {
+    curr_pos += ratio;
+    input_count += curr_pos >> 16;
+    curr_pos &= 0xFFFF;
+  }
+  return input_count;
+}
+
 // Read <count> input samples from ARAM, decoding and converting rate
 // if required.
 void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
@@ -383,9 +405,28 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
 
   if (coeffs)
     coeffs += pb.coef_select * 0x200;
-  u32 curr_pos =
-      ResampleAudio([](u32) { return AcceleratorGetSample(); }, samples, count, pb.src.last_samples,
-                    pb.src.cur_addr_frac, HILO_TO_32(pb.src.ratio), pb.src_type, coeffs);
+
+  // Decode the samples needed by the resampler a block at a time rather than one at a time. The
+  // resampler reads its input in order, so the block is refilled once it has all been read.
+  u16 input_samples[MAX_SAMPLES_PER_FRAME * 2];
+  u32 input_remaining = GetResampleInputCount(count, pb.src.cur_addr_frac,
+                                              HILO_TO_32(pb.src.ratio), pb.src_type);
+  u32 input_start = 0;
+  u32 input_end = 0;
+  auto input_callback = [&](u32 i) {
+    if (i == input_end)
+    {
+      const u32 block_size = std::min<u32>(input_remaining, std::size(input_samples));
+      AcceleratorGetSamples(input_samples, block_size);
+      input_remaining -= block_size;
+      input_start = i;
+      input_end = i + block_size;
+    }
+    return static_cast<s16>(input_samples[i - input_start]);
+  };
+
+  u32 curr_pos = ResampleAudio(input_callback, samples, count, pb.src.last_samples,
+                               pb.src.cur_addr_frac, HILO_TO_32(pb.src.ratio), pb.src_type, coeffs);
   pb.src.cur_addr_frac = (curr_pos & 0xFFFF);
 
   // Update current position, YN1, YN2 and pred scale in the PB.
@@ -15,6 +15,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/Thread.h"
+#include "Common/Trace.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/DSP/DSPAccelerator.h"
@@ -98,6 +99,7 @@ void DSPLLE::DSPThread(DSPLLE* dsp_lle)
     const int cycles = static_cast<int>(dsp_lle->m_cycle_count.load());
     if (cycles > 0)
     {
+      Common::Trace::ScopedSlice trace_slice("DSP RunCycles");
       std::lock_guard<std::mutex> dsp_thread_lock(dsp_lle->m_dsp_thread_mutex);
       if (g_dsp_jit)
       {
@@ -315,12 +317,16 @@ void DSPLLE::DSP_Update(int cycles)
   if (!m_is_dsp_on_thread)
   {
     // ~1/6th as many cycles as the period PPC-side.
+    Common::Trace::ScopedSlice trace_slice("DSP RunCycles");
     DSPCore_RunCycles(dsp_cycles);
   }
   else
   {
     // Wait for DSP thread to complete its cycle. Note: this logic should be thought through.
-    s_ppc_event.Wait();
+    {
+      Common::Trace::ScopedSlice trace_slice("DSP wait");
+      s_ppc_event.Wait();
+    }
     m_cycle_count.fetch_add(dsp_cycles);
     s_dsp_event.Set();
   }
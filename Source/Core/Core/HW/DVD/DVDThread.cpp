@@ -22,6 +22,7 @@
 #include "Common/SPSCQueue.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
+#include "Common/Trace.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -253,6 +254,8 @@ static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offs
 {
   ASSERT(Core::IsCPUThread());
 
+  Common::Trace::ScopedSlice trace_slice("DVD read request");
+
   ReadRequest request;
 
   request.copy_to_ram = copy_to_ram;
@@ -268,6 +271,8 @@ static void StartReadInternal(bool copy_to_ram, u32 output_address, u64 dvd_offs
   request.time_started_ticks = CoreTiming::GetTicks();
   request.realtime_started_us = Common::Timer::GetTimeUs();
 
+  Common::Trace::FlowStart("DVD read", id);
+
   s_request_queue.Push(std::move(request));
   s_request_queue_expanded.Set();
 
@@ -308,6 +313,8 @@ static void FinishRead(u64 id, s64 cycles_late)
   }
   // We have now obtained the right ReadResult.
 
+  Common::Trace::FlowEnd("DVD read", id);
+
   const ReadRequest& request = result.first;
   const std::vector<u8>& buffer = result.second;
 
@@ -349,6 +356,9 @@ static void DVDThread()
     ReadRequest request;
     while (s_request_queue.Pop(request))
     {
+      Common::Trace::ScopedSlice trace_slice("DVD read");
+      Common::Trace::FlowStep("DVD read", request.id);
+
       FileMonitor::Log(*s_disc, request.partition, request.dvd_offset);
 
       std::vector<u8> buffer(request.length);
@@ -10,14 +10,21 @@
 #include "Core/HW/Memmap.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/DSP.h"
@@ -29,6 +36,7 @@
 #include "Core/HW/SI/SI.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/WII_IPC.h"
+#include "Core/MemTools.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "VideoCommon/CommandProcessor.h"
@@ -113,6 +121,7 @@ struct LogicalMemoryView
 {
   void* mapped_pointer;
   u32 mapped_size;
+  u32 shm_position;
 };
 
 // Dolphin allocates memory to represent four regions:
@@ -164,6 +173,8 @@ static PhysicalMemoryRegion physical_regions[] = {
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
 
+static u32 s_shm_size = 0;
+
 void Init()
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -190,6 +201,7 @@ void Init()
     mem_size += region.size;
   }
   g_arena.GrabSHMSegment(mem_size);
+  s_shm_size = mem_size;
   physical_base = MemArena::FindMemoryBase();
 
   for (PhysicalMemoryRegion& region : physical_regions)
@@ -224,6 +236,8 @@ void Init()
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 {
+  FinishSnapshotCapture();
+
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
@@ -256,15 +270,278 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
             PanicAlert("MemoryMap_Setup: Failed finding a memory base.");
             exit(0);
           }
-          logical_mapped_entries.push_back({mapped_pointer, mapped_size});
+          logical_mapped_entries.push_back({mapped_pointer, mapped_size, position});
         }
       }
     }
   }
 }
 
+// Snapshots work on pages of the shared memory segment. Each page is copied exactly once, either
+// by the thread that first writes to it (to s_snapshot_data) or by WriteSnapshot.
+constexpr u32 SNAPSHOT_PAGE_SIZE = 0x1000;
+
+enum class SnapshotState
+{
+  Idle,
+  // The views are write-protected.
+  Active,
+  // The write protection was removed again. Faults that raced with that are simply retried.
+  Released,
+};
+
+enum SnapshotPageState : u8
+{
+  PAGE_PENDING,
+  PAGE_COPYING,
+  // Copied to s_snapshot_data.
+  PAGE_CAPTURED,
+  // Written to the save state by WriteSnapshot.
+  PAGE_WRITTEN,
+};
+
+struct SnapshotView
+{
+  u8* pointer;
+  u32 size;
+  u32 shm_position;
+};
+
+static std::atomic<SnapshotState> s_snapshot_state{SnapshotState::Idle};
+// Every mapping of the memory (physical and logical), which all have to be protected.
+static std::vector<SnapshotView> s_snapshot_views;
+// The physical regions, indexed like physical_regions. Absent regions have a size of 0.
+static std::array<SnapshotView, 4> s_snapshot_regions;
+static std::unique_ptr<std::atomic<u8>[]> s_snapshot_page_states;
+static u8* s_snapshot_data = nullptr;
+static u32 s_snapshot_size = 0;
+// Offset in the state buffer at which WriteSnapshot inserts the memory.
+static size_t s_snapshot_offset = 0;
+static bool s_snapshot_capture_pending = false;
+// Serializes the snapshot lifetime. Never taken by the exception handler.
+static std::mutex s_snapshot_mutex;
+// The number of exception handlers that may be walking s_snapshot_views. The views are only
+// changed once the state is Idle and this dropped to 0, as a fault can be in flight while the
+// snapshot ends.
+static std::atomic<int> s_snapshot_faults_in_flight{0};
+
+static_assert(std::size(physical_regions) == std::tuple_size<decltype(s_snapshot_regions)>::value,
+              "Every physical region needs a snapshot region");
+
+// Returns once the page has been copied, by this thread or by another one.
+static void CapturePage(u32 page, const u8* source)
+{
+  std::atomic<u8>& state = s_snapshot_page_states[page];
+  u8 expected = PAGE_PENDING;
+  if (state.compare_exchange_strong(expected, PAGE_COPYING, std::memory_order_acquire))
+  {
+    std::memcpy(s_snapshot_data + page * SNAPSHOT_PAGE_SIZE, source, SNAPSHOT_PAGE_SIZE);
+    state.store(PAGE_CAPTURED, std::memory_order_release);
+    return;
+  }
+
+  // The page stays write-protected until the other thread is done with it.
+  while (state.load(std::memory_order_acquire) == PAGE_COPYING)
+    Common::YieldCPU();
+}
+
+// Must be called with s_snapshot_mutex held, before changing s_snapshot_views.
+static void StopSnapshotFaultHandling()
+{
+  // Sequentially consistent, like the accesses of HandleSnapshotFault: either the handler sees
+  // the Idle state, or this sees it in flight.
+  s_snapshot_state.store(SnapshotState::Idle);
+  while (s_snapshot_faults_in_flight.load() != 0)
+    Common::YieldCPU();
+}
+
+// Must be called with s_snapshot_mutex held.
+static void ReleaseSnapshotProtection()
+{
+  if (s_snapshot_state.load(std::memory_order_relaxed) != SnapshotState::Active)
+    return;
+
+  for (const SnapshotView& view : s_snapshot_views)
+    Common::UnWriteProtectMemory(view.pointer, view.size);
+  s_snapshot_state.store(SnapshotState::Released, std::memory_order_release);
+}
+
+// Must be called with s_snapshot_mutex held.
+static void FreeSnapshot()
+{
+  ReleaseSnapshotProtection();
+  if (s_snapshot_data)
+    Common::FreeMemoryPages(s_snapshot_data, s_snapshot_size);
+  s_snapshot_data = nullptr;
+  s_snapshot_capture_pending = false;
+}
+
+bool BeginSnapshot()
+{
+  std::lock_guard<std::mutex> lk(s_snapshot_mutex);
+  // Only one snapshot can be in flight.
+  if (s_snapshot_data || !m_IsInitialized || !EMM::IsProcessWideHandlerInstalled())
+    return false;
+
+  StopSnapshotFaultHandling();
+  s_snapshot_size = s_shm_size;
+  s_snapshot_data = static_cast<u8*>(Common::AllocateMemoryPages(s_snapshot_size));
+  const u32 page_count = s_snapshot_size / SNAPSHOT_PAGE_SIZE;
+  s_snapshot_page_states = std::make_unique<std::atomic<u8>[]>(page_count);
+  for (u32 i = 0; i < page_count; ++i)
+    s_snapshot_page_states[i].store(PAGE_PENDING, std::memory_order_relaxed);
+
+  s_snapshot_views.clear();
+  for (size_t i = 0; i < s_snapshot_regions.size(); ++i)
+  {
+    const PhysicalMemoryRegion& region = physical_regions[i];
+    if (*region.out_pointer)
+    {
+      s_snapshot_regions[i] = {*region.out_pointer, region.size, region.shm_position};
+      s_snapshot_views.push_back(s_snapshot_regions[i]);
+    }
+    else
+    {
+      s_snapshot_regions[i] = {nullptr, 0, 0};
+    }
+  }
+  for (const LogicalMemoryView& entry : logical_mapped_entries)
+  {
+    s_snapshot_views.push_back(
+        {static_cast<u8*>(entry.mapped_pointer), entry.mapped_size, entry.shm_position});
+  }
+
+  s_snapshot_capture_pending = true;
+  s_snapshot_state.store(SnapshotState::Active, std::memory_order_release);
+  for (const SnapshotView& view : s_snapshot_views)
+    Common::WriteProtectMemory(view.pointer, view.size);
+
+  return true;
+}
+
+static void DoSnapshotRegion(PointerWrap& p, const SnapshotView& region)
+{
+  if (p.GetMode() != PointerWrap::MODE_WRITE)
+  {
+    p.DoArray(region.pointer, region.size);
+    return;
+  }
+
+  for (u32 offset = 0; offset < region.size; offset += SNAPSHOT_PAGE_SIZE)
+  {
+    const u32 page = (region.shm_position + offset) / SNAPSHOT_PAGE_SIZE;
+    std::atomic<u8>& state = s_snapshot_page_states[page];
+    u8 expected = PAGE_PENDING;
+    if (state.compare_exchange_strong(expected, PAGE_COPYING, std::memory_order_acquire))
+    {
+      // Not written to since the snapshot began, so the mapping still holds the original data.
+      p.DoArray(region.pointer + offset, SNAPSHOT_PAGE_SIZE);
+      state.store(PAGE_WRITTEN, std::memory_order_release);
+    }
+    else
+    {
+      while (state.load(std::memory_order_acquire) == PAGE_COPYING)
+        Common::YieldCPU();
+      p.DoArray(s_snapshot_data + page * SNAPSHOT_PAGE_SIZE, SNAPSHOT_PAGE_SIZE);
+    }
+  }
+}
+
+// Same layout as DoState.
+static void DoSnapshotState(PointerWrap& p)
+{
+  DoSnapshotRegion(p, s_snapshot_regions[0]);
+  DoSnapshotRegion(p, s_snapshot_regions[1]);
+  p.DoMarker("Memory RAM");
+  DoSnapshotRegion(p, s_snapshot_regions[2]);
+  p.DoMarker("Memory FakeVMEM");
+  DoSnapshotRegion(p, s_snapshot_regions[3]);
+  p.DoMarker("Memory EXRAM");
+}
+
+void WriteSnapshot(std::vector<u8>* buffer)
+{
+  u8* ptr = nullptr;
+  PointerWrap measure(&ptr, PointerWrap::MODE_MEASURE);
+  DoSnapshotState(measure);
+  const size_t size = reinterpret_cast<size_t>(ptr);
+
+  buffer->insert(buffer->begin() + s_snapshot_offset, size, 0);
+  ptr = buffer->data() + s_snapshot_offset;
+  PointerWrap p(&ptr, PointerWrap::MODE_WRITE);
+  DoSnapshotState(p);
+
+  std::lock_guard<std::mutex> lk(s_snapshot_mutex);
+  FreeSnapshot();
+}
+
+void CancelSnapshot()
+{
+  std::lock_guard<std::mutex> lk(s_snapshot_mutex);
+  FreeSnapshot();
+}
+
+static bool HandleSnapshotFaultInFlight(uintptr_t address)
+{
+  const SnapshotState state = s_snapshot_state.load();
+  if (state == SnapshotState::Idle)
+    return false;
+
+  for (const SnapshotView& view : s_snapshot_views)
+  {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(view.pointer);
+    if (address < base || address - base >= view.size)
+      continue;
+
+    const u32 offset = static_cast<u32>(address - base) & ~(SNAPSHOT_PAGE_SIZE - 1);
+    if (state == SnapshotState::Active)
+      CapturePage((view.shm_position + offset) / SNAPSHOT_PAGE_SIZE, view.pointer + offset);
+    // Other mappings of the page stay protected, which is harmless since it has been copied.
+    Common::UnWriteProtectMemory(view.pointer + offset, SNAPSHOT_PAGE_SIZE);
+    return true;
+  }
+  return false;
+}
+
+bool HandleSnapshotFault(uintptr_t address)
+{
+  s_snapshot_faults_in_flight.fetch_add(1);
+  const bool handled = HandleSnapshotFaultInFlight(address);
+  s_snapshot_faults_in_flight.fetch_sub(1);
+  return handled;
+}
+
+void FinishSnapshotCapture()
+{
+  std::lock_guard<std::mutex> lk(s_snapshot_mutex);
+  if (s_snapshot_state.load(std::memory_order_relaxed) == SnapshotState::Active)
+  {
+    for (const SnapshotView& region : s_snapshot_regions)
+    {
+      for (u32 offset = 0; offset < region.size; offset += SNAPSHOT_PAGE_SIZE)
+      {
+        CapturePage((region.shm_position + offset) / SNAPSHOT_PAGE_SIZE,
+                    region.pointer + offset);
+      }
+    }
+    ReleaseSnapshotProtection();
+  }
+
+  // The views are about to change.
+  StopSnapshotFaultHandling();
+  s_snapshot_views.clear();
+}
+
 void DoState(PointerWrap& p)
 {
+  if (s_snapshot_capture_pending && p.GetMode() == PointerWrap::MODE_WRITE)
+  {
+    // WriteSnapshot inserts the memory here once emulation has resumed.
+    s_snapshot_offset = p.GetWrittenSize();
+    s_snapshot_capture_pending = false;
+    return;
+  }
+
   bool wii = SConfig::GetInstance().bWii;
   p.DoArray(m_pRAM, RAM_SIZE);
   p.DoArray(m_pL1Cache, L1_CACHE_SIZE);
@@ -279,6 +556,8 @@ void DoState(PointerWrap& p)
 
 void Shutdown()
 {
+  FinishSnapshotCapture();
+
   m_IsInitialized = false;
   u32 flags = 0;
   if (SConfig::GetInstance().bWii)
@@ -358,6 +637,21 @@ void CopyToEmu(u32 address, const void* data, size_t size)
   memcpy(pointer, data, size);
 }
 
+void PrepareForHostWrite(u32 address, size_t size)
+{
+  if (s_snapshot_state.load(std::memory_order_acquire) == SnapshotState::Idle || size == 0)
+    return;
+
+  const u8* pointer = GetPointerForRange(address, size);
+  if (!pointer)
+    return;
+
+  const uintptr_t start = reinterpret_cast<uintptr_t>(pointer) & ~uintptr_t(SNAPSHOT_PAGE_SIZE - 1);
+  const uintptr_t end = reinterpret_cast<uintptr_t>(pointer) + size;
+  for (uintptr_t page = start; page < end; page += SNAPSHOT_PAGE_SIZE)
+    HandleSnapshotFault(page);
+}
+
 void Memset(u32 address, u8 value, size_t size)
 {
   if (size == 0)
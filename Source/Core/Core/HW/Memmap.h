@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
@@ -68,6 +69,24 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
 void Clear();
 
+// Copy-on-write snapshots of the emulated memory, used to save states in the background.
+//
+// BeginSnapshot write-protects the memory, after which the first write to each page copies it
+// aside. The next DoState in MODE_WRITE (which must use a growable buffer) leaves the memory out,
+// and WriteSnapshot inserts the memory as it was when the snapshot began into that buffer, from
+// any thread, while emulation keeps running. Requires EMM::IsProcessWideHandlerInstalled().
+bool BeginSnapshot();
+void WriteSnapshot(std::vector<u8>* buffer);
+void CancelSnapshot();
+// Called by the exception handler. Returns true if the fault was caused by a snapshot.
+bool HandleSnapshotFault(uintptr_t address);
+// Writes done by the host OS (e.g. reading a file directly into emulated memory) don't raise
+// faults, so the pages they touch have to be copied beforehand.
+void PrepareForHostWrite(u32 address, size_t size);
+// Copies the pages that haven't been copied yet and removes the write protection. Must be called
+// before the memory mappings change or the exception handler is uninstalled.
+void FinishSnapshotCapture();
+
 // Routines to access physically addressed memory, designed for use by
 // emulated hardware outside the CPU. Use "Device_" prefix.
 std::string GetString(u32 em_address, size_t size = 0);
@@ -625,6 +625,7 @@ IPCCommandResult ES::DIVerify(const IOCtlVRequest& request)
 
 s32 ES::DIVerify(const IOS::ES::TMDReader& tmd, const IOS::ES::TicketReader& ticket)
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   m_title_context.Clear();
   INFO_LOG(IOS_ES, "ES_DIVerify: Title context changed: (none)");
 
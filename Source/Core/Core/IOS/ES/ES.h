@@ -11,6 +11,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
+#include "Common/ScopeGuard.h"
 #include "Core/IOS/Device.h"
 #include "Core/IOS/ES/Formats.h"
 #include "Core/IOS/IOS.h"
@@ -335,6 +336,11 @@ private:
   void FinishStaleImport(u64 title_id);
   void FinishAllStaleImports();
 
+  // For the functions that modify titles, contents or tickets: the returned guard clears the
+  // NAND metadata cache when the function returns. These changes are rare enough that clearing
+  // everything is simpler than tracking which entries were affected.
+  Common::ScopeGuard InvalidateNANDMetadataOnReturn() const;
+
   std::string GetContentPath(u64 title_id, const IOS::ES::Content& content,
                              const IOS::ES::SharedContentMap& map = IOS::ES::SharedContentMap{
                                  Common::FROM_SESSION_ROOT}) const;
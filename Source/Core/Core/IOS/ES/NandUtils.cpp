@@ -20,6 +20,7 @@
 #include "Common/StringUtil.h"
 #include "Core/IOS/ES/ES.h"
 #include "Core/IOS/ES/Formats.h"
+#include "Core/IOS/NANDMetadataCache.h"
 
 namespace IOS
 {
@@ -47,21 +48,25 @@ IOS::ES::TMDReader ES::FindImportTMD(u64 title_id) const
 
 IOS::ES::TMDReader ES::FindInstalledTMD(u64 title_id) const
 {
-  return FindTMD(title_id, Common::GetTMDFileName(title_id, Common::FROM_SESSION_ROOT));
+  return m_ios.GetNANDMetadataCache().GetInstalledTMD(title_id, [title_id] {
+    return FindTMD(title_id, Common::GetTMDFileName(title_id, Common::FROM_SESSION_ROOT));
+  });
 }
 
 IOS::ES::TicketReader ES::FindSignedTicket(u64 title_id) const
 {
-  const std::string path = Common::GetTicketFileName(title_id, Common::FROM_SESSION_ROOT);
-  File::IOFile ticket_file(path, "rb");
-  if (!ticket_file)
-    return {};
-
-  std::vector<u8> signed_ticket(ticket_file.GetSize());
-  if (!ticket_file.ReadBytes(signed_ticket.data(), signed_ticket.size()))
-    return {};
-
-  return IOS::ES::TicketReader{std::move(signed_ticket)};
+  return m_ios.GetNANDMetadataCache().GetTicket(title_id, [title_id]() -> IOS::ES::TicketReader {
+    const std::string path = Common::GetTicketFileName(title_id, Common::FROM_SESSION_ROOT);
+    File::IOFile ticket_file(path, "rb");
+    if (!ticket_file)
+      return {};
+
+    std::vector<u8> signed_ticket(ticket_file.GetSize());
+    if (!ticket_file.ReadBytes(signed_ticket.data(), signed_ticket.size()))
+      return {};
+
+    return IOS::ES::TicketReader{std::move(signed_ticket)};
+  });
 }
 
 static bool IsValidPartOfTitleID(const std::string& string)
@@ -115,15 +120,19 @@ static std::vector<u64> GetTitlesInTitleOrImport(const std::string& titles_dir)
 
 std::vector<u64> ES::GetInstalledTitles() const
 {
-  return GetTitlesInTitleOrImport(Common::RootUserPath(Common::FROM_SESSION_ROOT) + "/title");
+  return m_ios.GetNANDMetadataCache().GetTitleList(NANDMetadataCache::TitleList::Installed, [] {
+    return GetTitlesInTitleOrImport(Common::RootUserPath(Common::FROM_SESSION_ROOT) + "/title");
+  });
 }
 
 std::vector<u64> ES::GetTitleImports() const
 {
-  return GetTitlesInTitleOrImport(Common::RootUserPath(Common::FROM_SESSION_ROOT) + "/import");
+  return m_ios.GetNANDMetadataCache().GetTitleList(NANDMetadataCache::TitleList::Imports, [] {
+    return GetTitlesInTitleOrImport(Common::RootUserPath(Common::FROM_SESSION_ROOT) + "/import");
+  });
 }
 
-std::vector<u64> ES::GetTitlesWithTickets() const
+static std::vector<u64> GetTitlesWithTicketsFromNAND()
 {
   const std::string tickets_dir = Common::RootUserPath(Common::FROM_SESSION_ROOT) + "/ticket";
   if (!File::IsDirectory(tickets_dir))
@@ -163,6 +172,12 @@ std::vector<u64> ES::GetTitlesWithTickets() const
   return title_ids;
 }
 
+std::vector<u64> ES::GetTitlesWithTickets() const
+{
+  return m_ios.GetNANDMetadataCache().GetTitleList(NANDMetadataCache::TitleList::Tickets,
+                                                   GetTitlesWithTicketsFromNAND);
+}
+
 std::vector<IOS::ES::Content> ES::GetStoredContentsFromTMD(const IOS::ES::TMDReader& tmd) const
 {
   if (!tmd.IsValid())
@@ -201,6 +216,7 @@ std::vector<std::array<u8, 20>> ES::GetSharedContents() const
 
 bool ES::InitImport(u64 title_id)
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   const std::string content_dir = Common::GetTitleContentPath(title_id, Common::FROM_SESSION_ROOT);
   const std::string data_dir = Common::GetTitleDataPath(title_id, Common::FROM_SESSION_ROOT);
   for (const auto& dir : {content_dir, data_dir})
@@ -232,6 +248,7 @@ bool ES::InitImport(u64 title_id)
 
 bool ES::FinishImport(const IOS::ES::TMDReader& tmd)
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   const u64 title_id = tmd.GetTitleId();
   const std::string import_content_dir = Common::GetImportTitlePath(title_id) + "/content";
 
@@ -265,6 +282,7 @@ bool ES::FinishImport(const IOS::ES::TMDReader& tmd)
 
 bool ES::WriteImportTMD(const IOS::ES::TMDReader& tmd)
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   const std::string tmd_path = Common::RootUserPath(Common::FROM_SESSION_ROOT) + "/tmp/title.tmd";
   File::CreateFullPath(tmd_path);
 
@@ -280,6 +298,7 @@ bool ES::WriteImportTMD(const IOS::ES::TMDReader& tmd)
 
 void ES::FinishStaleImport(u64 title_id)
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   const auto import_tmd = FindImportTMD(title_id);
   if (!import_tmd.IsValid())
     File::DeleteDirRecursively(Common::GetImportTitlePath(title_id) + "/content");
@@ -289,6 +308,7 @@ void ES::FinishStaleImport(u64 title_id)
 
 void ES::FinishAllStaleImports()
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   const std::vector<u64> titles = GetTitleImports();
   for (const u64& title_id : titles)
     FinishStaleImport(title_id);
@@ -298,6 +318,11 @@ void ES::FinishAllStaleImports()
   File::CreateDir(import_dir);
 }
 
+Common::ScopeGuard ES::InvalidateNANDMetadataOnReturn() const
+{
+  return Common::ScopeGuard{[this] { m_ios.GetNANDMetadataCache().Clear(); }};
+}
+
 std::string ES::GetContentPath(const u64 title_id, const IOS::ES::Content& content,
                                const IOS::ES::SharedContentMap& content_map) const
 {
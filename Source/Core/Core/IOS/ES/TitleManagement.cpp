@@ -57,6 +57,7 @@ void ES::TitleImportExportContext::DoState(PointerWrap& p)
 ReturnCode ES::ImportTicket(const std::vector<u8>& ticket_bytes, const std::vector<u8>& cert_chain,
                             TicketImportType type)
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   IOS::ES::TicketReader ticket{ticket_bytes};
   if (!ticket.IsValid())
     return ES_EINVAL;
@@ -346,6 +347,7 @@ static std::string GetImportContentPath(u64 title_id, u32 content_id)
 
 ReturnCode ES::ImportContentEnd(Context& context, u32 content_fd)
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   INFO_LOG(IOS_ES, "ImportContentEnd: content fd %08x", content_fd);
 
   if (!context.title_import_export.valid || !context.title_import_export.content.valid)
@@ -492,6 +494,7 @@ static bool CanDeleteTitle(u64 title_id)
 
 ReturnCode ES::DeleteTitle(u64 title_id)
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   if (!CanDeleteTitle(title_id))
     return ES_EINVAL;
 
@@ -519,6 +522,7 @@ IPCCommandResult ES::DeleteTitle(const IOCtlVRequest& request)
 
 ReturnCode ES::DeleteTicket(const u8* ticket_view)
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   const u64 title_id = Common::swap64(ticket_view + offsetof(IOS::ES::TicketView, title_id));
 
   if (!CanDeleteTitle(title_id))
@@ -566,6 +570,7 @@ IPCCommandResult ES::DeleteTicket(const IOCtlVRequest& request)
 
 ReturnCode ES::DeleteTitleContent(u64 title_id) const
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   if (!CanDeleteTitle(title_id))
     return ES_EINVAL;
 
@@ -591,6 +596,7 @@ IPCCommandResult ES::DeleteTitleContent(const IOCtlVRequest& request)
 
 ReturnCode ES::DeleteContent(u64 title_id, u32 content_id) const
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   if (!CanDeleteTitle(title_id))
     return ES_EINVAL;
 
@@ -783,6 +789,7 @@ IPCCommandResult ES::ExportTitleDone(Context& context, const IOCtlVRequest& requ
 
 ReturnCode ES::DeleteSharedContent(const std::array<u8, 20>& sha1) const
 {
+  const auto invalidate_metadata = InvalidateNANDMetadataOnReturn();
   IOS::ES::SharedContentMap map{Common::FromWhichRoot::FROM_SESSION_ROOT};
   const auto content_path = map.GetFilenameFromSHA1(sha1);
   if (!content_path)
@@ -24,6 +24,8 @@
 #include "Core/IOS/ES/ES.h"
 #include "Core/IOS/ES/Formats.h"
 #include "Core/IOS/FS/FileIO.h"
+#include "Core/IOS/IOS.h"
+#include "Core/IOS/NANDMetadataCache.h"
 
 namespace IOS
 {
@@ -257,6 +259,7 @@ IPCCommandResult FS::CreateDirectory(const IOCtlRequest& request)
   File::CreateFullPath(DirName);
   DEBUG_ASSERT_MSG(IOS_FILEIO, File::IsDirectory(DirName), "FS: CREATE_DIR %s failed",
                    DirName.c_str());
+  m_ios.GetNANDMetadataCache().InvalidateEntry(wii_path);
 
   return GetFSReply(IPC_SUCCESS);
 }
@@ -401,6 +404,7 @@ IPCCommandResult FS::DeleteFile(const IOCtlRequest& request)
   {
     WARN_LOG(IOS_FILEIO, "FS: DeleteFile %s - failed!!!", Filename.c_str());
   }
+  m_ios.GetNANDMetadataCache().InvalidateEntry(wii_path);
 
   return GetFSReply(IPC_SUCCESS);
 }
@@ -439,7 +443,10 @@ IPCCommandResult FS::RenameFile(const IOCtlRequest& request)
   }
 
   // finally try to rename the file
-  if (File::Rename(Filename, FilenameRename))
+  const bool renamed = File::Rename(Filename, FilenameRename);
+  m_ios.GetNANDMetadataCache().InvalidateEntry(wii_path);
+  m_ios.GetNANDMetadataCache().InvalidateEntry(wii_path_rename);
+  if (renamed)
   {
     INFO_LOG(IOS_FILEIO, "FS: Rename %s to %s", Filename.c_str(), FilenameRename.c_str());
   }
@@ -498,6 +505,7 @@ IPCCommandResult FS::CreateFile(const IOCtlRequest& request)
   // create the file
   File::CreateFullPath(Filename);  // just to be sure
   bool Result = File::CreateEmptyFile(Filename);
+  m_ios.GetNANDMetadataCache().InvalidateEntry(wii_path);
   if (!Result)
   {
     ERROR_LOG(IOS_FILEIO, "FS: couldn't create new file");
@@ -532,15 +540,32 @@ IPCCommandResult FS::ReadDirectory(const IOCtlVRequest& request)
 
   INFO_LOG(IOS_FILEIO, "FS: IOCTL_READ_DIR %s", DirName.c_str());
 
-  const File::FileInfo file_info(DirName);
+  const NANDMetadataCache::DirectoryListing listing =
+      m_ios.GetNANDMetadataCache().GetDirectoryListing(relative_path, [&DirName] {
+        NANDMetadataCache::DirectoryListing result;
+        const File::FileInfo file_info(DirName);
+        result.exists = file_info.Exists();
+        result.is_directory = file_info.IsDirectory();
+        if (!result.is_directory)
+          return result;
 
-  if (!file_info.Exists())
+        for (const File::FSTEntry& child : File::ScanDirectoryTree(DirName, false).children)
+        {
+          // Decode escaped invalid file system characters so that games (such as
+          // Harry Potter and the Half-Blood Prince) can find what they expect.
+          result.names.push_back(Common::UnescapeFileName(child.virtualName));
+        }
+        std::sort(result.names.begin(), result.names.end());
+        return result;
+      });
+
+  if (!listing.exists)
   {
     WARN_LOG(IOS_FILEIO, "FS: Search not found: %s", DirName.c_str());
     return GetFSReply(FS_ENOENT);
   }
 
-  if (!file_info.IsDirectory())
+  if (!listing.is_directory)
   {
     // It's not a directory, so error.
     // Games don't usually seem to care WHICH error they get, as long as it's <
@@ -549,30 +574,16 @@ IPCCommandResult FS::ReadDirectory(const IOCtlVRequest& request)
     return GetFSReply(FS_EINVAL);
   }
 
-  File::FSTEntry entry = File::ScanDirectoryTree(DirName, false);
-
   // it is one
   if ((request.in_vectors.size() == 1) && (request.io_vectors.size() == 1))
   {
-    size_t numFile = entry.children.size();
+    size_t numFile = listing.names.size();
     INFO_LOG(IOS_FILEIO, "\t%zu files found", numFile);
 
     Memory::Write_U32((u32)numFile, request.io_vectors[0].address);
   }
   else
   {
-    for (File::FSTEntry& child : entry.children)
-    {
-      // Decode escaped invalid file system characters so that games (such as
-      // Harry Potter and the Half-Blood Prince) can find what they expect.
-      child.virtualName = Common::UnescapeFileName(child.virtualName);
-    }
-
-    std::sort(entry.children.begin(), entry.children.end(),
-              [](const File::FSTEntry& one, const File::FSTEntry& two) {
-                return one.virtualName < two.virtualName;
-              });
-
     u32 MaxEntries = Memory::Read_U32(request.in_vectors[0].address);
 
     memset(Memory::GetPointer(request.io_vectors[0].address), 0, request.io_vectors[0].size);
@@ -580,9 +591,9 @@ IPCCommandResult FS::ReadDirectory(const IOCtlVRequest& request)
     size_t numFiles = 0;
     char* pFilename = (char*)Memory::GetPointer((u32)(request.io_vectors[0].address));
 
-    for (size_t i = 0; i < entry.children.size() && i < MaxEntries; i++)
+    for (size_t i = 0; i < listing.names.size() && i < MaxEntries; i++)
     {
-      const std::string& FileName = entry.children[i].virtualName;
+      const std::string& FileName = listing.names[i];
 
       strcpy(pFilename, FileName.c_str());
       pFilename += FileName.length();
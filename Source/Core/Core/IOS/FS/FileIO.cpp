@@ -8,6 +8,7 @@
 #include <cstdio>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 
 #include "Common/Assert.h"
@@ -19,6 +20,7 @@
 #include "Core/CommonTitles.h"
 #include "Core/HW/Memmap.h"
 #include "Core/IOS/IOS.h"
+#include "Core/IOS/NANDMetadataCache.h"
 
 namespace IOS
 {
@@ -26,15 +28,33 @@ namespace HLE
 {
 static std::map<std::string, std::weak_ptr<File::IOFile>> openFiles;
 
+// Host paths built by BuildFilename, for the session root in s_host_paths_root. Games open the
+// same few files over and over, and escaping the path is comparatively slow. Like openFiles, this
+// is only used from the CPU thread.
+static std::string s_host_paths_root;
+static std::unordered_map<std::string, std::string> s_host_paths;
+constexpr size_t MAX_CACHED_HOST_PATHS = 1024;
+
 // This is used by several of the FileIO and /dev/fs functions
 std::string BuildFilename(const std::string& wii_path)
 {
-  std::string nand_path = File::GetUserPath(D_SESSION_WIIROOT_IDX);
-  if (wii_path.compare(0, 1, "/") == 0)
-    return nand_path + Common::EscapePath(wii_path);
+  const std::string& nand_path = File::GetUserPath(D_SESSION_WIIROOT_IDX);
+  if (wii_path.compare(0, 1, "/") != 0)
+  {
+    ASSERT(false);
+    return nand_path;
+  }
+
+  if (s_host_paths_root != nand_path || s_host_paths.size() >= MAX_CACHED_HOST_PATHS)
+  {
+    s_host_paths.clear();
+    s_host_paths_root = nand_path;
+  }
 
-  ASSERT(false);
-  return nand_path;
+  const auto it = s_host_paths.find(wii_path);
+  if (it != s_host_paths.end())
+    return it->second;
+  return s_host_paths.emplace(wii_path, nand_path + Common::EscapePath(wii_path)).first->second;
 }
 
 void CreateVirtualFATFilesystem()
@@ -221,6 +241,7 @@ IPCCommandResult FileIO::Read(const ReadWriteRequest& request)
   DEBUG_LOG(IOS_FILEIO, "Read 0x%x bytes to 0x%08x from %s", request.size, request.buffer,
             m_name.c_str());
   m_file->Seek(m_SeekPos, SEEK_SET);  // File might be opened twice, need to seek before we read
+  Memory::PrepareForHostWrite(request.buffer, requested_read_length);
   const u32 number_of_bytes_read = static_cast<u32>(
       fread(Memory::GetPointer(request.buffer), 1, requested_read_length, m_file->GetHandle()));
 
@@ -252,6 +273,7 @@ IPCCommandResult FileIO::Write(const ReadWriteRequest& request)
                    SEEK_SET);  // File might be opened twice, need to seek before we write
       if (m_file->WriteBytes(Memory::GetPointer(request.buffer), request.size))
       {
+        m_ios.GetNANDMetadataCache().InvalidateContents(m_name);
         return_value = request.size;
         m_SeekPos += request.size;
       }
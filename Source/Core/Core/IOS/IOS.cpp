@@ -34,6 +34,7 @@
 #include "Core/IOS/FS/FS.h"
 #include "Core/IOS/FS/FileIO.h"
 #include "Core/IOS/MIOS.h"
+#include "Core/IOS/NANDMetadataCache.h"
 #include "Core/IOS/Network/IP/Top.h"
 #include "Core/IOS/Network/KD/NetKDRequest.h"
 #include "Core/IOS/Network/KD/NetKDTime.h"
@@ -176,7 +177,7 @@ void WriteReturnValue(s32 value, u32 address)
   Memory::Write_U32(static_cast<u32>(value), address);
 }
 
-Kernel::Kernel()
+Kernel::Kernel() : m_nand_metadata_cache(std::make_unique<NANDMetadataCache>())
 {
   // Until the Wii root and NAND path stuff is entirely managed by IOS and made non-static,
   // using more than one IOS instance at a time is not supported.
@@ -205,7 +206,8 @@ Kernel::~Kernel()
     Core::ShutdownWiiRoot();
 }
 
-Kernel::Kernel(u64 title_id) : m_title_id(title_id)
+Kernel::Kernel(u64 title_id)
+    : m_title_id(title_id), m_nand_metadata_cache(std::make_unique<NANDMetadataCache>())
 {
 }
 
@@ -692,6 +694,10 @@ void Kernel::DoState(PointerWrap& p)
 
   m_iosc.DoState(p);
 
+  // The NAND is not part of the state, and may not be the one the state was saved with.
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    m_nand_metadata_cache->Clear();
+
   if (m_title_id == Titles::MIOS)
     return;
 
@@ -766,6 +772,11 @@ IOSC& Kernel::GetIOSC()
   return m_iosc;
 }
 
+NANDMetadataCache& Kernel::GetNANDMetadataCache()
+{
+  return *m_nand_metadata_cache;
+}
+
 void Init()
 {
   s_event_enqueue = CoreTiming::RegisterEvent("IPCEvent", [](u64 userdata, s64) {
@@ -30,6 +30,7 @@ class ES;
 class FS;
 }
 
+class NANDMetadataCache;
 struct Request;
 struct OpenRequest;
 
@@ -113,6 +114,7 @@ public:
   u32 GetVersion() const;
 
   IOSC& GetIOSC();
+  NANDMetadataCache& GetNANDMetadataCache();
 
 protected:
   explicit Kernel(u64 title_id);
@@ -146,6 +148,7 @@ protected:
   u64 m_last_reply_time = 0;
 
   IOSC m_iosc;
+  std::unique_ptr<NANDMetadataCache> m_nand_metadata_cache;
 };
 
 // HLE for an IOS tied to emulation: base kernel which may have additional modules loaded.
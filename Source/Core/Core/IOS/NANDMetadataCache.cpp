@@ -0,0 +1,203 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/IOS/NANDMetadataCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <cstdlib>
+
+#include "Common/Logging/Log.h"
+
+namespace IOS
+{
+namespace HLE
+{
+namespace
+{
+constexpr char TITLE_DIR[] = "/title";
+constexpr char IMPORT_DIR[] = "/import";
+constexpr char TICKET_DIR[] = "/ticket";
+constexpr char SHARED1_DIR[] = "/shared1";
+
+bool IsInDirectory(const std::string& path, const std::string& directory)
+{
+  return path.compare(0, directory.size(), directory) == 0 &&
+         (path.size() == directory.size() || path[directory.size()] == '/');
+}
+
+std::string StripTrailingSlashes(const std::string& path)
+{
+  const size_t end = path.find_last_not_of('/');
+  return end == std::string::npos ? "/" : path.substr(0, end + 1);
+}
+
+// Parses the title ID out of paths like /title/00010002/48414241/content/title.tmd or
+// /ticket/00010002/48414241.tik.
+std::optional<u64> GetTitleIdFromPath(const std::string& path, const std::string& directory)
+{
+  const size_t type_start = directory.size() + 1;
+  const size_t identifier_start = type_start + 9;
+  if (!IsInDirectory(path, directory) || path.size() < identifier_start + 8 ||
+      path[identifier_start - 1] != '/')
+  {
+    return std::nullopt;
+  }
+
+  const auto is_hex = [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; };
+  if (!std::all_of(&path[type_start], &path[type_start + 8], is_hex) ||
+      !std::all_of(&path[identifier_start], &path[identifier_start + 8], is_hex))
+  {
+    return std::nullopt;
+  }
+
+  const u64 type = std::strtoul(path.substr(type_start, 8).c_str(), nullptr, 16);
+  const u64 identifier = std::strtoul(path.substr(identifier_start, 8).c_str(), nullptr, 16);
+  return type << 32 | identifier;
+}
+
+template <typename Map, typename Load>
+typename Map::mapped_type Lookup(Map* map, const typename Map::key_type& key, const Load& load,
+                                 NANDMetadataCache::Statistics* statistics)
+{
+  const auto it = map->find(key);
+  if (it != map->end())
+  {
+    ++statistics->hits;
+    return it->second;
+  }
+
+  ++statistics->misses;
+  return map->emplace(key, load()).first->second;
+}
+
+template <typename Map>
+void InvalidateTitle(Map* map, const std::string& path, const std::string& directory)
+{
+  const std::optional<u64> title_id = GetTitleIdFromPath(path, directory);
+  if (title_id)
+    map->erase(*title_id);
+  else
+    map->clear();
+}
+}  // namespace
+
+NANDMetadataCache::~NANDMetadataCache()
+{
+  INFO_LOG(IOS, "NAND metadata cache: %" PRIu64 " hits, %" PRIu64 " misses", m_statistics.hits,
+           m_statistics.misses);
+}
+
+std::vector<u64> NANDMetadataCache::GetTitleList(TitleList list,
+                                                 const std::function<std::vector<u64>()>& load)
+{
+  std::optional<std::vector<u64>>& titles = m_title_lists[static_cast<size_t>(list)];
+  if (titles)
+  {
+    ++m_statistics.hits;
+    return *titles;
+  }
+
+  ++m_statistics.misses;
+  titles = load();
+  return *titles;
+}
+
+IOS::ES::TMDReader
+NANDMetadataCache::GetInstalledTMD(u64 title_id, const std::function<IOS::ES::TMDReader()>& load)
+{
+  return Lookup(&m_tmds, title_id, load, &m_statistics);
+}
+
+IOS::ES::TicketReader
+NANDMetadataCache::GetTicket(u64 title_id, const std::function<IOS::ES::TicketReader()>& load)
+{
+  return Lookup(&m_tickets, title_id, load, &m_statistics);
+}
+
+NANDMetadataCache::DirectoryListing
+NANDMetadataCache::GetDirectoryListing(const std::string& wii_path,
+                                       const std::function<DirectoryListing()>& load)
+{
+  // Other parts of Dolphin write to the rest of the NAND without going through FS.
+  if (!IsInDirectory(wii_path, TITLE_DIR) && !IsInDirectory(wii_path, IMPORT_DIR) &&
+      !IsInDirectory(wii_path, TICKET_DIR) && !IsInDirectory(wii_path, SHARED1_DIR))
+  {
+    return load();
+  }
+
+  return Lookup(&m_listings, StripTrailingSlashes(wii_path), load, &m_statistics);
+}
+
+void NANDMetadataCache::InvalidateEntry(const std::string& path)
+{
+  const std::string wii_path = StripTrailingSlashes(path);
+  if (wii_path == "/")
+  {
+    Clear();
+    return;
+  }
+
+  InvalidateListings(wii_path);
+
+  if (IsInDirectory(wii_path, TITLE_DIR))
+  {
+    m_title_lists[static_cast<size_t>(TitleList::Installed)].reset();
+    InvalidateTitle(&m_tmds, wii_path, TITLE_DIR);
+  }
+  else if (IsInDirectory(wii_path, IMPORT_DIR))
+  {
+    m_title_lists[static_cast<size_t>(TitleList::Imports)].reset();
+  }
+  else if (IsInDirectory(wii_path, TICKET_DIR))
+  {
+    m_title_lists[static_cast<size_t>(TitleList::Tickets)].reset();
+    InvalidateTitle(&m_tickets, wii_path, TICKET_DIR);
+  }
+}
+
+void NANDMetadataCache::InvalidateContents(const std::string& wii_path)
+{
+  if (IsInDirectory(wii_path, TITLE_DIR))
+    InvalidateTitle(&m_tmds, wii_path, TITLE_DIR);
+  else if (IsInDirectory(wii_path, TICKET_DIR))
+    InvalidateTitle(&m_tickets, wii_path, TICKET_DIR);
+}
+
+void NANDMetadataCache::InvalidateListings(const std::string& wii_path)
+{
+  // The entry itself and everything below it.
+  for (auto it = m_listings.lower_bound(wii_path);
+       it != m_listings.end() && it->first.compare(0, wii_path.size(), wii_path) == 0;)
+  {
+    if (IsInDirectory(it->first, wii_path))
+      it = m_listings.erase(it);
+    else
+      ++it;
+  }
+
+  // FS creates missing parent directories, so any of them may have changed.
+  for (size_t end = wii_path.find('/', 1); end != std::string::npos;
+       end = wii_path.find('/', end + 1))
+  {
+    m_listings.erase(wii_path.substr(0, end));
+  }
+}
+
+void NANDMetadataCache::Clear()
+{
+  for (auto& list : m_title_lists)
+    list.reset();
+  m_tmds.clear();
+  m_tickets.clear();
+  m_listings.clear();
+}
+
+NANDMetadataCache::Statistics NANDMetadataCache::GetStatistics() const
+{
+  return m_statistics;
+}
+}  // namespace HLE
+}  // namespace IOS
@@ -0,0 +1,89 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/IOS/ES/Formats.h"
+
+namespace IOS
+{
+namespace HLE
+{
+// Keeps the NAND metadata that ES and FS keep looking up in memory: the lists of installed,
+// imported and ticketed titles, the installed TMDs, the tickets, and the listings of the
+// directories that ES manages (/title, /ticket, /import and /shared1). The System Menu and
+// channels make these IPC calls constantly, and each of them used to scan host directories and
+// reparse files.
+//
+// The cache doesn't watch the host file system. FS reports every entry that it creates, deletes
+// or renames and every file that it writes to, and ES clears the cache whenever it changes titles,
+// contents or tickets. It is owned by the kernel and only used from the thread that runs IOS.
+class NANDMetadataCache final
+{
+public:
+  enum class TitleList
+  {
+    // Titles in /title
+    Installed,
+    // Titles in /import
+    Imports,
+    // Titles with a ticket in /ticket
+    Tickets,
+  };
+
+  struct DirectoryListing
+  {
+    bool exists = false;
+    bool is_directory = false;
+    // Unescaped names of the entries, in alphabetical order.
+    std::vector<std::string> names;
+  };
+
+  struct Statistics
+  {
+    u64 hits = 0;
+    u64 misses = 0;
+  };
+
+  ~NANDMetadataCache();
+
+  // The load functions read the data from the NAND when it isn't cached yet.
+  std::vector<u64> GetTitleList(TitleList list, const std::function<std::vector<u64>()>& load);
+  IOS::ES::TMDReader GetInstalledTMD(u64 title_id,
+                                     const std::function<IOS::ES::TMDReader()>& load);
+  IOS::ES::TicketReader GetTicket(u64 title_id,
+                                  const std::function<IOS::ES::TicketReader()>& load);
+  // Only the directories that ES manages are cached, the others are always loaded.
+  DirectoryListing GetDirectoryListing(const std::string& wii_path,
+                                       const std::function<DirectoryListing()>& load);
+
+  // A file or directory was created or deleted. Renames are reported for both paths.
+  void InvalidateEntry(const std::string& wii_path);
+  // The contents of a file changed.
+  void InvalidateContents(const std::string& wii_path);
+  void Clear();
+
+  Statistics GetStatistics() const;
+
+private:
+  void InvalidateListings(const std::string& wii_path);
+
+  std::array<std::optional<std::vector<u64>>, 3> m_title_lists;
+  std::unordered_map<u64, IOS::ES::TMDReader> m_tmds;
+  std::unordered_map<u64, IOS::ES::TicketReader> m_tickets;
+  // Ordered so that the listings of a directory and of its subdirectories are next to each other.
+  std::map<std::string, DirectoryListing> m_listings;
+  Statistics m_statistics;
+};
+}  // namespace HLE
+}  // namespace IOS
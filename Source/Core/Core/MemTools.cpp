@@ -14,6 +14,7 @@
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
 
+#include "Core/HW/Memmap.h"
 #include "Core/MachineContext.h"
 #include "Core/PowerPC/JitInterface.h"
 
@@ -44,7 +45,7 @@ LONG NTAPI Handler(PEXCEPTION_POINTERS pPtrs)
     uintptr_t badAddress = (uintptr_t)pPtrs->ExceptionRecord->ExceptionInformation[1];
     CONTEXT* ctx = pPtrs->ContextRecord;
 
-    if (JitInterface::HandleFault(badAddress, ctx))
+    if (Memory::HandleSnapshotFault(badAddress) || JitInterface::HandleFault(badAddress, ctx))
     {
       return (DWORD)EXCEPTION_CONTINUE_EXECUTION;
     }
@@ -82,22 +83,28 @@ LONG NTAPI Handler(PEXCEPTION_POINTERS pPtrs)
   }
 }
 
+static bool s_handler_installed = false;
+
 void InstallExceptionHandler()
 {
   // Make sure this is only called once per process execution
   // Instead, could make a Uninstall function, but whatever..
-  static bool handlerInstalled = false;
-  if (handlerInstalled)
+  if (s_handler_installed)
     return;
 
   AddVectoredExceptionHandler(TRUE, Handler);
-  handlerInstalled = true;
+  s_handler_installed = true;
 }
 
 void UninstallExceptionHandler()
 {
 }
 
+bool IsProcessWideHandlerInstalled()
+{
+  return s_handler_installed;
+}
+
 #elif defined(__APPLE__) && !defined(USE_SIGACTION_ON_APPLE)
 
 static void CheckKR(const char* name, kern_return_t kr)
@@ -230,10 +237,17 @@ void UninstallExceptionHandler()
 {
 }
 
+bool IsProcessWideHandlerInstalled()
+{
+  // The exception port is only set for the thread that installed the handler.
+  return false;
+}
+
 #elif defined(_POSIX_VERSION) && !defined(_M_GENERIC)
 
 static struct sigaction old_sa_segv;
 static struct sigaction old_sa_bus;
+static bool s_handler_installed = false;
 
 static void sigsegv_handler(int sig, siginfo_t* info, void* raw_context)
 {
@@ -258,13 +272,14 @@ static void sigsegv_handler(int sig, siginfo_t* info, void* raw_context)
   mcontext_t* ctx = &context->uc_mcontext;
 #endif
   // assume it's not a write
-  if (!JitInterface::HandleFault(bad_address,
+  if (!Memory::HandleSnapshotFault(bad_address) &&
+      !JitInterface::HandleFault(bad_address,
 #ifdef __APPLE__
-                                 *ctx
+                                  *ctx
 #else
-                                 ctx
+                                  ctx
 #endif
-                                 ))
+                                  ))
   {
     // retry and crash
     // According to the sigaction man page, if sa_flags "SA_SIGINFO" is set to the sigaction
@@ -323,6 +338,7 @@ void InstallExceptionHandler()
 #ifdef __APPLE__
   sigaction(SIGBUS, &sa, &old_sa_bus);
 #endif
+  s_handler_installed = true;
 }
 
 void UninstallExceptionHandler()
@@ -337,6 +353,12 @@ void UninstallExceptionHandler()
 #ifdef __APPLE__
   sigaction(SIGBUS, &old_sa_bus, nullptr);
 #endif
+  s_handler_installed = false;
+}
+
+bool IsProcessWideHandlerInstalled()
+{
+  return s_handler_installed;
 }
 #else  // _M_GENERIC or unsupported platform
 
@@ -346,6 +368,10 @@ void InstallExceptionHandler()
 void UninstallExceptionHandler()
 {
 }
+bool IsProcessWideHandlerInstalled()
+{
+  return false;
+}
 
 #endif
 
@@ -8,4 +8,8 @@ namespace EMM
 {
 void InstallExceptionHandler();
 void UninstallExceptionHandler();
+
+// Whether the installed handler sees the faults of every thread, and not only the ones of the
+// thread that installed it. Memory snapshots rely on this.
+bool IsProcessWideHandlerInstalled();
 }
@@ -14,6 +14,7 @@
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/Event.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
@@ -24,11 +25,13 @@
 #include "Common/Timer.h"
 #include "Common/Version.h"
 
+#include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/GeckoCode.h"
 #include "Core/HW/HW.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/Wiimote.h"
 #include "Core/Host.h"
 #include "Core/Movie.h"
@@ -218,16 +221,9 @@ void LoadFromBuffer(std::vector<u8>& buffer)
 void SaveToBuffer(std::vector<u8>& buffer)
 {
   Core::RunAsCPUThread([&] {
-    u8* ptr = nullptr;
-    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-
-    DoState(p);
-    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
-    buffer.resize(buffer_size);
-
-    ptr = &buffer[0];
-    p.SetMode(PointerWrap::MODE_WRITE);
+    PointerWrap p(&buffer);
     DoState(p);
+    p.FinishWrite();
   });
 }
 
@@ -284,6 +280,8 @@ struct CompressAndDumpState_args
   std::mutex* buffer_mutex;
   std::string filename;
   bool wait;
+  // The emulated memory is missing from the buffer and has to be inserted from the snapshot.
+  bool memory_snapshot;
 };
 
 static void CompressAndDumpState(CompressAndDumpState_args save_args)
@@ -303,6 +301,9 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
   if (!save_args.wait)
     on_exit.Exit();
 
+  if (save_args.memory_snapshot)
+    Memory::WriteSnapshot(save_args.buffer_vector);
+
   const u8* const buffer_data = &(*(save_args.buffer_vector))[0];
   const size_t buffer_size = (save_args.buffer_vector)->size();
   std::string& filename = save_args.filename;
@@ -386,23 +387,24 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
 void SaveAs(const std::string& filename, bool wait)
 {
   Core::RunAsCPUThread([&] {
-    // Measure the size of the buffer.
-    u8* ptr = nullptr;
-    PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
-    DoState(p);
-    const size_t buffer_size = reinterpret_cast<size_t>(ptr);
+    const u64 start_time = Common::Timer::GetTimeUs();
 
-    // Then actually do the write.
-    {
-      std::lock_guard<std::mutex> lk(g_cs_current_buffer);
-      g_current_buffer.resize(buffer_size);
-      ptr = &g_current_buffer[0];
-      p.SetMode(PointerWrap::MODE_WRITE);
-      DoState(p);
-    }
+    // The buffer grows as the state is written, and keeps its capacity between saves.
+    std::unique_lock<std::mutex> lk(g_cs_current_buffer);
+    PointerWrap p(&g_current_buffer);
+
+    // With a snapshot, the emulated memory is serialized by the save thread instead.
+    const bool memory_snapshot =
+        Config::Get(Config::MAIN_BACKGROUND_SAVE_STATES) && Memory::BeginSnapshot();
+    DoState(p);
 
     if (p.GetMode() == PointerWrap::MODE_WRITE)
     {
+      const size_t buffer_size = p.FinishWrite();
+      lk.unlock();
+      INFO_LOG(CORE, "Serialized %zu bytes of state in %.2f ms", buffer_size,
+               (Common::Timer::GetTimeUs() - start_time) / 1000.0);
+
       Core::DisplayMessage("Saving State...", 1000);
 
       CompressAndDumpState_args save_args;
@@ -410,6 +412,7 @@ void SaveAs(const std::string& filename, bool wait)
       save_args.buffer_mutex = &g_cs_current_buffer;
       save_args.filename = filename;
       save_args.wait = wait;
+      save_args.memory_snapshot = memory_snapshot;
 
       Flush();
       g_save_thread = std::thread(CompressAndDumpState, save_args);
@@ -419,6 +422,9 @@ void SaveAs(const std::string& filename, bool wait)
     }
     else
     {
+      if (memory_snapshot)
+        Memory::CancelSnapshot();
+
       // someone aborted the save by changing the mode?
       Core::DisplayMessage("Unable to save: Internal DoState Error", 4000);
     }
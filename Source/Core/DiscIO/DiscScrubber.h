@@ -37,6 +37,8 @@ public:
 
   bool SetupScrub(const std::string& filename, int block_size);
   size_t GetNextBlock(File::IOFile& in, u8* buffer);
+  // Returns true if the cluster containing the given raw offset only holds garbage data.
+  bool CanBlockBeScrubbed(u64 offset) const;
 
 private:
   struct PartitionHeader final
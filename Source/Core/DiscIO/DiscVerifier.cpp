@@ -0,0 +1,333 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "DiscIO/DiscVerifier.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <mbedtls/aes.h>
+#include <mbedtls/md5.h>
+#include <mbedtls/sha1.h>
+#include <zlib.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+#include "Common/Semaphore.h"
+#include "Common/WorkQueueThread.h"
+#include "Core/IOS/ES/Formats.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/DiscScrubber.h"
+#include "DiscIO/Enums.h"
+#include "DiscIO/Volume.h"
+#include "DiscIO/VolumeWii.h"
+
+namespace DiscIO
+{
+constexpr u64 CLUSTER_SIZE = VolumeWii::BLOCK_TOTAL_SIZE;
+// One Wii hash group (which is covered by one H3 hash) per chunk.
+constexpr u64 CHUNK_SIZE = 64 * CLUSTER_SIZE;
+// Number of chunks per worker thread that may be read ahead of the hashing.
+constexpr int CHUNKS_IN_FLIGHT_PER_THREAD = 2;
+
+constexpr size_t SHA1_SIZE = 20;
+constexpr size_t H0_OFFSET = 0x000;
+constexpr size_t H0_SIZE = 31 * SHA1_SIZE;
+constexpr size_t H1_OFFSET = 0x280;
+constexpr size_t H1_SIZE = 8 * SHA1_SIZE;
+constexpr size_t H2_OFFSET = 0x340;
+constexpr size_t H2_SIZE = 8 * SHA1_SIZE;
+constexpr size_t DATA_IV_OFFSET = 0x3D0;
+constexpr u32 H3_TABLE_SIZE = 0x18000;
+
+namespace
+{
+struct PartitionInfo
+{
+  // Raw offsets of the encrypted data area.
+  u64 data_start;
+  u64 data_end;
+  std::vector<u8> h3_table;
+  mbedtls_aes_context aes_context;
+};
+
+struct Chunk
+{
+  explicit Chunk(Common::Semaphore* semaphore_) : semaphore(semaphore_) {}
+  // Chunks are shared by the checksum and hashing threads, so the last one to be done with a
+  // chunk makes room for the next one.
+  ~Chunk() { semaphore->Post(); }
+
+  Chunk(const Chunk&) = delete;
+  Chunk& operator=(const Chunk&) = delete;
+
+  Common::Semaphore* semaphore;
+  u64 offset = 0;
+  std::vector<u8> data;
+};
+
+using ChunkQueue = Common::WorkQueueThread<std::shared_ptr<Chunk>>;
+
+class Verifier
+{
+public:
+  bool Init(const std::string& filename)
+  {
+    m_reader = CreateBlobReader(filename);
+    std::unique_ptr<Volume> volume = CreateVolumeFromFilename(filename);
+    if (!m_reader || !volume)
+      return false;
+
+    if (volume->GetVolumeType() == Platform::WII_WAD)
+    {
+      ERROR_LOG(DISCIO, "%s is not a disc image", filename.c_str());
+      return false;
+    }
+
+    for (const Partition& partition : volume->GetPartitions())
+    {
+      const std::optional<u64> h3_offset =
+          volume->ReadSwappedAndShifted(partition.offset + 0x2b4, PARTITION_NONE);
+      const std::optional<u64> data_offset =
+          volume->ReadSwappedAndShifted(partition.offset + 0x2b8, PARTITION_NONE);
+      const std::optional<u64> data_size =
+          volume->ReadSwappedAndShifted(partition.offset + 0x2bc, PARTITION_NONE);
+      if (!h3_offset || !data_offset || !data_size)
+        return false;
+
+      auto info = std::make_unique<PartitionInfo>();
+      info->data_start = partition.offset + *data_offset;
+      info->data_end = info->data_start + *data_size;
+      info->h3_table.resize(H3_TABLE_SIZE);
+      if (!m_reader->Read(partition.offset + *h3_offset, H3_TABLE_SIZE, info->h3_table.data()))
+        return false;
+
+      const std::array<u8, 16> key = volume->GetTicket(partition).GetTitleKey();
+      mbedtls_aes_init(&info->aes_context);
+      mbedtls_aes_setkey_dec(&info->aes_context, key.data(), 128);
+      m_partitions.push_back(std::move(info));
+    }
+
+    // Clusters that the file systems don't use hold garbage that doesn't match its hashes.
+    if (!m_partitions.empty() &&
+        !m_scrubber.SetupScrub(filename, static_cast<int>(CLUSTER_SIZE)))
+    {
+      WARN_LOG(DISCIO, "Could not determine the unused clusters of %s", filename.c_str());
+    }
+
+    return true;
+  }
+
+  ~Verifier()
+  {
+    for (auto& partition : m_partitions)
+      mbedtls_aes_free(&partition->aes_context);
+  }
+
+  std::optional<VerificationResult> Run(unsigned int thread_count, const VerifyCallback& callback)
+  {
+    const auto start_time = std::chrono::steady_clock::now();
+
+    thread_count = std::max(thread_count, 1u);
+    Common::Semaphore semaphore(thread_count * CHUNKS_IN_FLIGHT_PER_THREAD,
+                                thread_count * CHUNKS_IN_FLIGHT_PER_THREAD);
+
+    mbedtls_md5_context md5_context;
+    mbedtls_sha1_context sha1_context;
+    mbedtls_md5_init(&md5_context);
+    mbedtls_sha1_init(&sha1_context);
+    mbedtls_md5_starts(&md5_context);
+    mbedtls_sha1_starts(&sha1_context);
+    uLong crc = crc32(0, nullptr, 0);
+
+    bool cancelled = false;
+    bool read_failed = false;
+    const u64 size = m_reader->GetDataSize();
+    {
+      // The checksums have to be computed in order, so they get a thread of their own.
+      ChunkQueue checksum_thread([&](std::shared_ptr<Chunk> chunk) {
+        mbedtls_md5_update(&md5_context, chunk->data.data(), chunk->data.size());
+        mbedtls_sha1_update(&sha1_context, chunk->data.data(), chunk->data.size());
+        crc = crc32(crc, chunk->data.data(), static_cast<uInt>(chunk->data.size()));
+      });
+
+      std::vector<std::unique_ptr<ChunkQueue>> hash_threads;
+      if (!m_partitions.empty())
+      {
+        for (unsigned int i = 0; i < thread_count; ++i)
+        {
+          hash_threads.push_back(std::make_unique<ChunkQueue>(
+              [this](std::shared_ptr<Chunk> chunk) { VerifyChunk(*chunk); }));
+        }
+      }
+
+      for (u64 offset = 0, chunk_index = 0; offset < size; offset += CHUNK_SIZE, ++chunk_index)
+      {
+        if (callback && !callback(offset, size))
+        {
+          cancelled = true;
+          break;
+        }
+
+        semaphore.Wait();
+        auto chunk = std::make_shared<Chunk>(&semaphore);
+        chunk->offset = offset;
+        chunk->data.resize(static_cast<size_t>(std::min(CHUNK_SIZE, size - offset)));
+        if (!m_reader->Read(offset, chunk->data.size(), chunk->data.data()))
+        {
+          ERROR_LOG(DISCIO, "Failed to read the disc at 0x%" PRIx64, offset);
+          read_failed = true;
+          break;
+        }
+
+        if (!hash_threads.empty())
+          hash_threads[chunk_index % hash_threads.size()]->EmplaceItem(chunk);
+        checksum_thread.EmplaceItem(std::move(chunk));
+      }
+
+      // The work queue threads finish their queues when they are destroyed.
+    }
+
+    VerificationResult result;
+    mbedtls_md5_finish(&md5_context, result.md5.data());
+    mbedtls_sha1_finish(&sha1_context, result.sha1.data());
+    mbedtls_md5_free(&md5_context);
+    mbedtls_sha1_free(&sha1_context);
+    result.crc32 = static_cast<u32>(crc);
+
+    if (cancelled || read_failed)
+      return std::nullopt;
+
+    result.bytes_read = size;
+    result.clusters_verified = m_clusters_verified;
+    result.clusters_skipped = m_clusters_skipped;
+    result.mismatches = std::move(m_mismatches);
+    std::sort(result.mismatches.begin(), result.mismatches.end(),
+              [](const HashMismatch& a, const HashMismatch& b) { return a.offset < b.offset; });
+
+    result.seconds = std::chrono::duration_cast<std::chrono::duration<double>>(
+                         std::chrono::steady_clock::now() - start_time)
+                         .count();
+
+    if (callback)
+      callback(size, size);
+
+    return result;
+  }
+
+private:
+  void VerifyChunk(const Chunk& chunk)
+  {
+    for (u64 cluster_offset = 0; cluster_offset + CLUSTER_SIZE <= chunk.data.size();
+         cluster_offset += CLUSTER_SIZE)
+    {
+      const u64 offset = chunk.offset + cluster_offset;
+      const auto partition = std::find_if(
+          m_partitions.begin(), m_partitions.end(), [offset](const auto& info) {
+            return offset >= info->data_start && offset + CLUSTER_SIZE <= info->data_end;
+          });
+      if (partition == m_partitions.end())
+        continue;
+
+      if (m_scrubber.CanBlockBeScrubbed(offset))
+      {
+        m_clusters_skipped++;
+        continue;
+      }
+
+      const std::optional<HashLevel> mismatch =
+          VerifyCluster(**partition, (offset - (*partition)->data_start) / CLUSTER_SIZE,
+                        &chunk.data[cluster_offset]);
+      m_clusters_verified++;
+
+      if (mismatch)
+      {
+        WARN_LOG(DISCIO, "%s mismatch in the cluster at 0x%" PRIx64, GetHashLevelName(*mismatch),
+                 offset);
+        std::lock_guard<std::mutex> lk(m_mismatches_mutex);
+        m_mismatches.push_back({offset, *mismatch});
+      }
+    }
+  }
+
+  // Returns the lowest hash level that doesn't match, if any.
+  static std::optional<HashLevel> VerifyCluster(const PartitionInfo& partition, u64 cluster_index,
+                                                const u8* encrypted)
+  {
+    // mbedtls_aes_crypt_cbc doesn't modify the context when decrypting, but it isn't const.
+    mbedtls_aes_context* aes_context = const_cast<mbedtls_aes_context*>(&partition.aes_context);
+
+    std::array<u8, VolumeWii::BLOCK_HEADER_SIZE> hashes;
+    std::array<u8, 16> iv{};
+    mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, hashes.size(), iv.data(), encrypted,
+                          hashes.data());
+
+    std::array<u8, VolumeWii::BLOCK_DATA_SIZE> data;
+    std::memcpy(iv.data(), encrypted + DATA_IV_OFFSET, iv.size());
+    mbedtls_aes_crypt_cbc(aes_context, MBEDTLS_AES_DECRYPT, data.size(), iv.data(),
+                          encrypted + VolumeWii::BLOCK_HEADER_SIZE, data.data());
+
+    u8 hash[SHA1_SIZE];
+    for (size_t i = 0; i < H0_SIZE / SHA1_SIZE; ++i)
+    {
+      mbedtls_sha1(&data[i * 0x400], 0x400, hash);
+      if (std::memcmp(hash, &hashes[H0_OFFSET + i * SHA1_SIZE], SHA1_SIZE))
+        return HashLevel::H0;
+    }
+
+    mbedtls_sha1(&hashes[H0_OFFSET], H0_SIZE, hash);
+    if (std::memcmp(hash, &hashes[H1_OFFSET + cluster_index % 8 * SHA1_SIZE], SHA1_SIZE))
+      return HashLevel::H1;
+
+    mbedtls_sha1(&hashes[H1_OFFSET], H1_SIZE, hash);
+    if (std::memcmp(hash, &hashes[H2_OFFSET + cluster_index / 8 % 8 * SHA1_SIZE], SHA1_SIZE))
+      return HashLevel::H2;
+
+    const u64 h3_index = cluster_index / 64;
+    mbedtls_sha1(&hashes[H2_OFFSET], H2_SIZE, hash);
+    if ((h3_index + 1) * SHA1_SIZE > partition.h3_table.size() ||
+        std::memcmp(hash, &partition.h3_table[h3_index * SHA1_SIZE], SHA1_SIZE))
+    {
+      return HashLevel::H3;
+    }
+
+    return std::nullopt;
+  }
+
+  std::unique_ptr<BlobReader> m_reader;
+  std::vector<std::unique_ptr<PartitionInfo>> m_partitions;
+  DiscScrubber m_scrubber;
+
+  std::atomic<u64> m_clusters_verified{0};
+  std::atomic<u64> m_clusters_skipped{0};
+  std::mutex m_mismatches_mutex;
+  std::vector<HashMismatch> m_mismatches;
+};
+}  // Anonymous namespace
+
+std::optional<VerificationResult> VerifyDisc(const std::string& filename,
+                                             unsigned int thread_count,
+                                             const VerifyCallback& callback)
+{
+  Verifier verifier;
+  if (!verifier.Init(filename))
+    return std::nullopt;
+
+  return verifier.Run(thread_count, callback);
+}
+
+const char* GetHashLevelName(HashLevel level)
+{
+  static constexpr std::array<const char*, 4> names = {{"H0", "H1", "H2", "H3"}};
+  return names[static_cast<size_t>(level)];
+}
+}  // namespace DiscIO
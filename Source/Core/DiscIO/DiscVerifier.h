@@ -0,0 +1,62 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace DiscIO
+{
+enum class HashLevel
+{
+  H0,
+  H1,
+  H2,
+  H3,
+};
+
+struct HashMismatch
+{
+  // Raw offset of the cluster on the disc.
+  u64 offset;
+  // The lowest level of the hash tree that didn't match.
+  HashLevel level;
+};
+
+struct VerificationResult
+{
+  u64 bytes_read = 0;
+  double seconds = 0;
+  // Wii partition clusters whose hashes were checked.
+  u64 clusters_verified = 0;
+  // Wii partition clusters that the file system doesn't use, which hold garbage data.
+  u64 clusters_skipped = 0;
+  std::vector<HashMismatch> mismatches;
+
+  // Checksums of the whole (uncompressed) disc image.
+  u32 crc32 = 0;
+  std::array<u8, 16> md5{};
+  std::array<u8, 20> sha1{};
+};
+
+// Called with the number of bytes processed so far and the size of the disc.
+// Returning false cancels the verification.
+using VerifyCallback = std::function<bool(u64 bytes_done, u64 bytes_total)>;
+
+// Reads a GameCube or Wii disc image sequentially in large chunks and computes its checksums.
+// For Wii discs, the clusters used by the partition file systems are decrypted and checked
+// against their H0/H1/H2 hashes and the H3 table of their partition, on thread_count threads.
+// Returns std::nullopt if the disc couldn't be read or the verification was cancelled.
+std::optional<VerificationResult> VerifyDisc(const std::string& filename,
+                                             unsigned int thread_count,
+                                             const VerifyCallback& callback = {});
+
+const char* GetHashLevelName(HashLevel level);
+}  // namespace DiscIO
@@ -6,34 +6,145 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cinttypes>
 #include <cstring>
+#include <memory>
+#include <thread>
 
-#include "Common/Crypto/AES.h"
+#include <mbedtls/aes.h>
+
+#include "Common/Align.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
+#include "Common/Semaphore.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Common/WorkQueueThread.h"
 #include "Core/IOS/ES/Formats.h"
 
 namespace DiscIO
 {
 constexpr size_t NAND_SIZE = 0x20000000;
 constexpr size_t NAND_KEYS_SIZE = 0x400;
+constexpr size_t NAND_TOTAL_BLOCKS = 0x40000;
+constexpr size_t NAND_BLOCK_SIZE = 0x800;
+constexpr size_t NAND_ECC_BLOCK_SIZE = 0x40;
+constexpr size_t NAND_RAW_BLOCK_SIZE = NAND_BLOCK_SIZE + NAND_ECC_BLOCK_SIZE;
+constexpr size_t NAND_BIN_SIZE = NAND_RAW_BLOCK_SIZE * NAND_TOTAL_BLOCKS;  // 0x21000000
+constexpr size_t NAND_AES_KEY_OFFSET = 0x158;
+constexpr size_t NAND_FAT_BLOCK_SIZE = 0x4000;
+constexpr size_t NAND_FAT_BLOCKS = NAND_SIZE / NAND_FAT_BLOCK_SIZE;
+
+// Pages read from the image at once.
+constexpr size_t CHUNK_BLOCKS = 0x200;
+// Number of chunks per worker thread that may be read ahead of the ECC checks.
+constexpr int CHUNKS_IN_FLIGHT_PER_THREAD = 2;
+
+// Each page has one 4 byte ECC per 512 bytes of data, at 0x30 in its spare area.
+constexpr size_t ECC_SUBPAGE_SIZE = 0x200;
+constexpr size_t ECC_OFFSET = 0x30;
+
+namespace
+{
+struct Chunk
+{
+  explicit Chunk(Common::Semaphore* semaphore_) : semaphore(semaphore_) {}
+  ~Chunk() { semaphore->Post(); }
+
+  Chunk(const Chunk&) = delete;
+  Chunk& operator=(const Chunk&) = delete;
+
+  Common::Semaphore* semaphore;
+  size_t first_block = 0;
+  std::vector<u8> data;
+};
+
+using ChunkQueue = Common::WorkQueueThread<std::shared_ptr<Chunk>>;
+
+u32 Parity(u32 value)
+{
+  value ^= value >> 16;
+  value ^= value >> 8;
+  value ^= value >> 4;
+  value ^= value >> 2;
+  value ^= value >> 1;
+  return value & 1;
+}
+
+// Computes the Hamming code of 512 bytes of a page. Bit n of the two halves is the parity of the
+// bytes whose offset has bit n-3 clear or set (the low 3 bits cover the bits of the bytes), so
+// the data is folded a word at a time: the low 2 bits of the offset select a byte of the folded
+// words and the other 7 bits select the words that get folded.
+std::array<u8, 4> CalculateECC(const u8* data)
+{
+  u32 all_words = 0;
+  std::array<u32, 7> odd_words{};
+  for (u32 i = 0; i < ECC_SUBPAGE_SIZE / sizeof(u32); ++i)
+  {
+    u32 word;
+    std::memcpy(&word, data + i * sizeof(u32), sizeof(word));
+    all_words ^= word;
+    for (u32 bit = 0; bit < odd_words.size(); ++bit)
+      odd_words[bit] ^= word & (0 - ((i >> bit) & 1));
+  }
+
+  std::array<u8, 4> lanes;
+  std::memcpy(lanes.data(), &all_words, sizeof(all_words));
+  const u8 all_bytes = lanes[0] ^ lanes[1] ^ lanes[2] ^ lanes[3];
+
+  u32 even = Parity(all_bytes & 0x55) | Parity(all_bytes & 0x33) << 1 |
+             Parity(all_bytes & 0x0f) << 2 | Parity(lanes[0] ^ lanes[2]) << 3 |
+             Parity(lanes[0] ^ lanes[1]) << 4;
+  u32 odd = Parity(all_bytes & 0xaa) | Parity(all_bytes & 0xcc) << 1 |
+            Parity(all_bytes & 0xf0) << 2 | Parity(lanes[1] ^ lanes[3]) << 3 |
+            Parity(lanes[2] ^ lanes[3]) << 4;
+  for (u32 bit = 0; bit < odd_words.size(); ++bit)
+  {
+    even |= Parity(all_words ^ odd_words[bit]) << (bit + 5);
+    odd |= Parity(odd_words[bit]) << (bit + 5);
+  }
+
+  return {{static_cast<u8>(even), static_cast<u8>(even >> 8), static_cast<u8>(odd),
+           static_cast<u8>(odd >> 8)}};
+}
+
+bool CheckECC(const u8* data, const u8* spare)
+{
+  for (size_t i = 0; i < NAND_BLOCK_SIZE / ECC_SUBPAGE_SIZE; ++i)
+  {
+    const u8* stored_ecc = spare + ECC_OFFSET + i * 4;
+    // Pages that were never written have no ECC.
+    if (std::all_of(stored_ecc, stored_ecc + 4, [](u8 byte) { return byte == 0xff; }))
+      continue;
+
+    const std::array<u8, 4> ecc = CalculateECC(data + i * ECC_SUBPAGE_SIZE);
+    if (!std::equal(ecc.begin(), ecc.end(), stored_ecc))
+      return false;
+  }
+  return true;
+}
+}  // namespace
 
 NANDImporter::NANDImporter() = default;
 NANDImporter::~NANDImporter() = default;
 
-void NANDImporter::ImportNANDBin(const std::string& path_to_bin,
-                                 std::function<void()> update_callback,
-                                 std::function<std::string()> get_otp_dump_path)
+std::optional<NANDImporter::Statistics>
+NANDImporter::ImportNANDBin(const std::string& path_to_bin, std::function<void()> update_callback,
+                            std::function<std::string()> get_otp_dump_path)
 {
+  const auto start_time = std::chrono::steady_clock::now();
+
   m_update_callback = std::move(update_callback);
+  m_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+  m_files.clear();
+  m_statistics = {};
 
   if (!ReadNANDBin(path_to_bin, get_otp_dump_path))
-    return;
+    return std::nullopt;
 
   const std::string nand_root = File::GetUserPath(D_WIIROOT_IDX);
   m_nand_root_length = nand_root.length();
@@ -42,19 +153,27 @@ void NANDImporter::ImportNANDBin(const std::string& path_to_bin,
 
   FindSuperblock();
   ProcessEntry(0, nand_root);
+  ExtractFiles();
   ExportKeys(nand_root);
   ExtractCertificates(nand_root);
+
+  m_statistics.seconds = std::chrono::duration_cast<std::chrono::duration<double>>(
+                             std::chrono::steady_clock::now() - start_time)
+                             .count();
+  NOTICE_LOG(DISCIO,
+             "Imported %u files and %u directories (%" PRIu64 " bytes) in %.2f s: %.1f MB/s, "
+             "%u pages didn't match their ECC",
+             m_statistics.files, m_statistics.directories, m_statistics.bytes_written,
+             m_statistics.seconds,
+             m_statistics.seconds > 0 ? m_statistics.bytes_read / m_statistics.seconds / 1000000 :
+                                        0.0,
+             m_statistics.ecc_errors);
+  return m_statistics;
 }
 
 bool NANDImporter::ReadNANDBin(const std::string& path_to_bin,
                                std::function<std::string()> get_otp_dump_path)
 {
-  constexpr size_t NAND_TOTAL_BLOCKS = 0x40000;
-  constexpr size_t NAND_BLOCK_SIZE = 0x800;
-  constexpr size_t NAND_ECC_BLOCK_SIZE = 0x40;
-  constexpr size_t NAND_BIN_SIZE =
-      (NAND_BLOCK_SIZE + NAND_ECC_BLOCK_SIZE) * NAND_TOTAL_BLOCKS;  // 0x21000000
-
   File::IOFile file(path_to_bin, "rb");
   const u64 image_size = file.GetSize();
   if (image_size != NAND_BIN_SIZE + NAND_KEYS_SIZE && image_size != NAND_BIN_SIZE)
@@ -65,17 +184,50 @@ bool NANDImporter::ReadNANDBin(const std::string& path_to_bin,
 
   m_nand.resize(NAND_SIZE);
 
-  for (size_t i = 0; i < NAND_TOTAL_BLOCKS; i++)
+  std::atomic<u32> ecc_errors{0};
+  const auto process_chunk = [this, &ecc_errors](std::shared_ptr<Chunk> chunk) {
+    for (size_t i = 0; i < CHUNK_BLOCKS; ++i)
+    {
+      const u8* block = &chunk->data[i * NAND_RAW_BLOCK_SIZE];
+      const size_t block_number = chunk->first_block + i;
+      std::copy_n(block, NAND_BLOCK_SIZE, &m_nand[block_number * NAND_BLOCK_SIZE]);
+      if (!CheckECC(block, block + NAND_BLOCK_SIZE))
+      {
+        WARN_LOG(DISCIO, "Page 0x%zx doesn't match its ECC", block_number);
+        ++ecc_errors;
+      }
+    }
+  };
+
   {
-    // Instead of updating on every cycle, we only update every 1000 cycles for a balance between
-    // not updating fast enough vs updating too fast
-    if (i % 1000 == 0)
+    const int chunks_in_flight = static_cast<int>(m_thread_count) * CHUNKS_IN_FLIGHT_PER_THREAD;
+    Common::Semaphore semaphore(chunks_in_flight, chunks_in_flight);
+    std::vector<std::unique_ptr<ChunkQueue>> threads;
+    for (unsigned int i = 0; i < m_thread_count; ++i)
+      threads.push_back(std::make_unique<ChunkQueue>(process_chunk));
+
+    for (size_t block = 0; block < NAND_TOTAL_BLOCKS; block += CHUNK_BLOCKS)
+    {
       m_update_callback();
 
-    file.ReadBytes(&m_nand[i * NAND_BLOCK_SIZE], NAND_BLOCK_SIZE);
-    file.Seek(NAND_ECC_BLOCK_SIZE, SEEK_CUR);  // We don't care about the ECC blocks
+      semaphore.Wait();
+      auto chunk = std::make_shared<Chunk>(&semaphore);
+      chunk->first_block = block;
+      chunk->data.resize(CHUNK_BLOCKS * NAND_RAW_BLOCK_SIZE);
+      if (!file.ReadBytes(chunk->data.data(), chunk->data.size()))
+      {
+        PanicAlertT("Failed to read the NAND backup.");
+        return false;
+      }
+
+      threads[block / CHUNK_BLOCKS % threads.size()]->EmplaceItem(std::move(chunk));
+    }
+
+    // The work queue threads finish their queues when they are destroyed.
   }
 
+  m_statistics.bytes_read = NAND_BIN_SIZE;
+  m_statistics.ecc_errors = ecc_errors;
   m_nand_keys.resize(NAND_KEYS_SIZE);
 
   // Read the OTP/SEEPROM dump.
@@ -161,6 +313,7 @@ void NANDImporter::ProcessDirectory(const NANDFSTEntry& entry, const std::string
 
   const std::string path = GetPath(entry, parent_path);
   File::CreateDir(path);
+  ++m_statistics.directories;
 
   if (entry.sub != 0xffff)
     ProcessEntry(entry.sub, path);
@@ -170,30 +323,78 @@ void NANDImporter::ProcessDirectory(const NANDFSTEntry& entry, const std::string
 
 void NANDImporter::ProcessFile(const NANDFSTEntry& entry, const std::string& parent_path)
 {
-  constexpr size_t NAND_AES_KEY_OFFSET = 0x158;
-  constexpr size_t NAND_FAT_BLOCK_SIZE = 0x4000;
-
-  m_update_callback();
   INFO_LOG(DISCIO, "File: %s", FormatDebugString(entry).c_str());
 
-  const std::string path = GetPath(entry, parent_path);
-  File::IOFile file(path, "wb");
-  std::array<u8, 16> key{};
-  std::copy(&m_nand_keys[NAND_AES_KEY_OFFSET], &m_nand_keys[NAND_AES_KEY_OFFSET + key.size()],
-            key.begin());
-  u16 sub = Common::swap16(entry.sub);
-  u32 remaining_bytes = Common::swap32(entry.size);
-
-  while (remaining_bytes > 0)
-  {
-    std::array<u8, 16> iv{};
-    std::vector<u8> block = Common::AES::Decrypt(
-        key.data(), iv.data(), &m_nand[NAND_FAT_BLOCK_SIZE * sub], NAND_FAT_BLOCK_SIZE);
-    u32 size = remaining_bytes < NAND_FAT_BLOCK_SIZE ? remaining_bytes : NAND_FAT_BLOCK_SIZE;
-    file.WriteBytes(block.data(), size);
-    remaining_bytes -= size;
-    sub = Common::swap16(&m_nand[m_nand_fat_offset + 2 * sub]);
-  }
+  m_files.push_back({GetPath(entry, parent_path), Common::swap16(entry.sub),
+                     Common::swap32(entry.size)});
+}
+
+void NANDImporter::ExtractFiles()
+{
+  // Starting with the largest files keeps the threads from waiting on a large one at the end.
+  std::sort(m_files.begin(), m_files.end(),
+            [](const FileJob& a, const FileJob& b) { return a.size > b.size; });
+
+  mbedtls_aes_context aes_context;
+  mbedtls_aes_init(&aes_context);
+  mbedtls_aes_setkey_dec(&aes_context, &m_nand_keys[NAND_AES_KEY_OFFSET], 128);
+
+  std::atomic<size_t> next_file{0};
+  std::atomic<u64> bytes_written{0};
+  std::atomic<u32> files_written{0};
+  const auto extract_files = [&](bool report_progress) {
+    std::vector<u8> buffer;
+    for (size_t index = next_file++; index < m_files.size(); index = next_file++)
+    {
+      const FileJob& job = m_files[index];
+
+      // Decrypt the whole file so that it can be written with a single call.
+      buffer.resize(Common::AlignUp<size_t>(job.size, NAND_FAT_BLOCK_SIZE));
+      size_t size = 0;
+      for (u16 cluster = job.first_cluster; size < job.size; size += NAND_FAT_BLOCK_SIZE)
+      {
+        if (cluster >= NAND_FAT_BLOCKS)
+        {
+          ERROR_LOG(DISCIO, "Invalid cluster 0x%04x in the FAT chain of %s", cluster,
+                    job.path.c_str() + m_nand_root_length);
+          break;
+        }
+
+        std::array<u8, 16> iv{};
+        mbedtls_aes_crypt_cbc(&aes_context, MBEDTLS_AES_DECRYPT, NAND_FAT_BLOCK_SIZE, iv.data(),
+                              &m_nand[NAND_FAT_BLOCK_SIZE * cluster], &buffer[size]);
+        cluster = Common::swap16(&m_nand[m_nand_fat_offset + 2 * cluster]);
+      }
+      size = std::min<size_t>(size, job.size);
+
+      File::IOFile file(job.path, "wb");
+      if (file.WriteBytes(buffer.data(), size))
+      {
+        bytes_written += size;
+        ++files_written;
+      }
+      else
+      {
+        ERROR_LOG(DISCIO, "Unable to write to file %s", job.path.c_str());
+      }
+
+      if (report_progress)
+        m_update_callback();
+    }
+  };
+
+  // The calling thread takes part, and is the only one to call the update callback.
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < m_thread_count; ++i)
+    threads.emplace_back(extract_files, false);
+  extract_files(true);
+  for (std::thread& thread : threads)
+    thread.join();
+
+  mbedtls_aes_free(&aes_context);
+
+  m_statistics.bytes_written = bytes_written;
+  m_statistics.files = files_written;
 }
 
 bool NANDImporter::ExtractCertificates(const std::string& nand_root)
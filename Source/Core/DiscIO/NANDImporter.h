@@ -5,6 +5,7 @@
 #pragma once
 
 #include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -15,14 +16,29 @@ namespace DiscIO
 class NANDImporter final
 {
 public:
+  struct Statistics
+  {
+    u64 bytes_read = 0;
+    u64 bytes_written = 0;
+    u32 files = 0;
+    u32 directories = 0;
+    // Pages whose data doesn't match the ECC stored in their spare area.
+    u32 ecc_errors = 0;
+    double seconds = 0;
+  };
+
   NANDImporter();
   ~NANDImporter();
 
   // Extract a NAND image to the configured NAND root.
   // If the associated OTP/SEEPROM dump (keys.bin) is not included in the image,
   // get_otp_dump_path will be called to get a path to it.
-  void ImportNANDBin(const std::string& path_to_bin, std::function<void()> update_callback,
-                     std::function<std::string()> get_otp_dump_path);
+  // The image is read in large chunks whose pages are checked against their ECC on worker
+  // threads, then the files are decrypted and written in parallel. update_callback is only ever
+  // called from the calling thread. Returns std::nullopt if the image couldn't be read.
+  std::optional<Statistics> ImportNANDBin(const std::string& path_to_bin,
+                                          std::function<void()> update_callback,
+                                          std::function<std::string()> get_otp_dump_path);
   bool ExtractCertificates(const std::string& nand_root);
 
 private:
@@ -42,6 +58,13 @@ private:
   };
 #pragma pack(pop)
 
+  struct FileJob
+  {
+    std::string path;
+    u16 first_cluster;
+    u32 size;
+  };
+
   bool ReadNANDBin(const std::string& path_to_bin, std::function<std::string()> get_otp_dump_path);
   void FindSuperblock();
   std::string GetPath(const NANDFSTEntry& entry, const std::string& parent_path);
@@ -49,6 +72,7 @@ private:
   void ProcessEntry(u16 entry_number, const std::string& parent_path);
   void ProcessFile(const NANDFSTEntry& entry, const std::string& parent_path);
   void ProcessDirectory(const NANDFSTEntry& entry, const std::string& parent_path);
+  void ExtractFiles();
   void ExportKeys(const std::string& nand_root);
 
   std::vector<u8> m_nand;
@@ -57,5 +81,9 @@ private:
   size_t m_nand_fst_offset = 0;
   std::function<void()> m_update_callback;
   size_t m_nand_root_length = 0;
+  unsigned int m_thread_count = 1;
+  // Filled while walking the FST, and extracted once all the directories exist.
+  std::vector<FileJob> m_files;
+  Statistics m_statistics;
 };
 }
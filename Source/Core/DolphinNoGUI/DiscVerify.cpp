@@ -0,0 +1,124 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Headless disc image verifier.
+//
+// Computes the CRC32, MD5 and SHA-1 of each given disc image and checks the hash tree of the
+// partitions of Wii discs, then reports the throughput and any hash mismatch.
+
+#include <OptionParser.h>
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/StringUtil.h"
+#include "Common/Version.h"
+
+#include "DiscIO/DiscVerifier.h"
+
+#include "UICommon/UICommon.h"
+
+template <size_t N>
+static std::string HexString(const std::array<u8, N>& bytes)
+{
+  std::string str;
+  for (u8 byte : bytes)
+    str += StringFromFormat("%02x", byte);
+  return str;
+}
+
+// Returns false if the disc couldn't be verified or has hash mismatches.
+static bool VerifyFile(const std::string& path, unsigned int threads, bool quiet)
+{
+  int last_percent = -1;
+  const auto progress = [&](u64 done, u64 total) {
+    const int percent = total ? static_cast<int>(done * 100 / total) : 100;
+    if (!quiet && percent != last_percent)
+    {
+      fprintf(stderr, "\r%s: %3d%%", path.c_str(), percent);
+      last_percent = percent;
+    }
+    return true;
+  };
+
+  const std::optional<DiscIO::VerificationResult> result =
+      DiscIO::VerifyDisc(path, threads, progress);
+  if (!quiet)
+    fprintf(stderr, "\n");
+
+  if (!result)
+  {
+    printf("%s: could not be read\n", path.c_str());
+    return false;
+  }
+
+  const double mib = result->bytes_read / (1024.0 * 1024.0);
+  printf("%s\n", path.c_str());
+  printf("  Size:       %" PRIu64 " bytes\n", result->bytes_read);
+  printf("  Time:       %.2f s (%.1f MiB/s)\n", result->seconds,
+         result->seconds > 0 ? mib / result->seconds : 0.0);
+  printf("  Clusters:   %" PRIu64 " verified, %" PRIu64 " unused\n", result->clusters_verified,
+         result->clusters_skipped);
+  printf("  CRC32:      %08x\n", result->crc32);
+  printf("  MD5:        %s\n", HexString(result->md5).c_str());
+  printf("  SHA-1:      %s\n", HexString(result->sha1).c_str());
+  printf("  Mismatches: %zu\n", result->mismatches.size());
+  for (const DiscIO::HashMismatch& mismatch : result->mismatches)
+  {
+    printf("    %s mismatch in the cluster at 0x%09" PRIx64 "\n",
+           DiscIO::GetHashLevelName(mismatch.level), mismatch.offset);
+  }
+
+  return result->mismatches.empty();
+}
+
+int main(int argc, char* argv[])
+{
+  optparse::OptionParser parser;
+  parser.usage("usage: %prog [options]... FILE...").version(Common::scm_rev_str);
+  parser.add_option("-u", "--user").action("store").help("User folder path");
+  parser.add_option("-j", "--threads")
+      .action("store")
+      .type("int")
+      .set_default(std::max(std::thread::hardware_concurrency(), 1u))
+      .help("Number of threads checking the Wii partition hashes (default: %default)");
+  parser.add_option("-q", "--quiet").action("store_true").help("Don't print the progress");
+
+  optparse::Values& options = parser.parse_args(argc, argv);
+  const std::vector<std::string> args = parser.args();
+  if (args.empty())
+  {
+    parser.print_help();
+    return 1;
+  }
+
+  const int threads = static_cast<int>(options.get("threads"));
+  if (threads < 1)
+  {
+    fprintf(stderr, "The number of threads must be at least 1\n");
+    return 1;
+  }
+
+  std::string user_directory;
+  if (options.is_set("user"))
+    user_directory = static_cast<const char*>(options.get("user"));
+
+  // The user directory holds the Wii keys that are needed to decrypt the partitions.
+  UICommon::SetUserDirectory(user_directory);
+  UICommon::Init();
+
+  const bool quiet = static_cast<bool>(options.get("quiet"));
+  bool success = true;
+  for (const std::string& path : args)
+    success &= VerifyFile(path, static_cast<unsigned int>(threads), quiet);
+
+  UICommon::Shutdown();
+  return success ? 0 : 1;
+}
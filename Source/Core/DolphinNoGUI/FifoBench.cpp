@@ -0,0 +1,368 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Headless FIFO log replay benchmark.
+//
+// Boots a .dff through the FifoPlayer without any UI or render window, replays it a given
+// number of times through the selected video backend and writes per-frame timings, video
+// statistics and (optionally) XFB hashes as JSON, so that rendering performance can be tracked
+// by scripts.
+
+#include <OptionParser.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <picojson/picojson.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/Event.h"
+#include "Common/File.h"
+#include "Common/Flag.h"
+#include "Common/Hash.h"
+#include "Common/ScopeGuard.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
+#include "Common/Version.h"
+
+#include "Core/Boot/Boot.h"
+#include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/FifoPlayer/FifoDataFile.h"
+#include "Core/FifoPlayer/FifoPlayer.h"
+#include "Core/HW/CPU.h"
+#include "Core/HW/Memmap.h"
+
+#include "DolphinNoGUI/ToolHost.h"
+
+#include "UICommon/UICommon.h"
+
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+static Common::Flag s_running{true};
+static Common::Event s_state_changed_event;
+
+namespace
+{
+struct FrameSample
+{
+  u32 frame;
+  u64 time_us;
+  u32 objects;
+  Statistics::ThisFrame stats;
+  u64 xfb_hash;
+};
+
+class FifoBenchmark
+{
+public:
+  FifoBenchmark(u32 loops, bool hash_xfb) : m_loops(loops), m_hash_xfb(hash_xfb) {}
+
+  // Called on the CPU thread right before the FifoPlayer writes a frame. Since the benchmark runs
+  // in single core mode, the previous frame has been fully processed by the video backend by then.
+  void OnFrameWritten()
+  {
+    FifoPlayer& player = FifoPlayer::GetInstance();
+    const u64 now = Common::Timer::GetTimeUs();
+
+    if (m_frames_to_run == 0)
+      m_frames_to_run = static_cast<size_t>(player.GetFile()->GetFrameCount()) * m_loops;
+
+    if (m_last_frame_start != 0)
+    {
+      FrameSample sample;
+      sample.frame = m_last_frame;
+      sample.time_us = now - m_last_frame_start;
+      sample.objects =
+          static_cast<u32>(player.GetAnalyzedFrameInfo(m_last_frame).objectStarts.size());
+      sample.stats = stats.prevFrame;
+      sample.xfb_hash = m_hash_xfb ? HashXFB() : 0;
+      m_samples.push_back(sample);
+    }
+
+    if (m_samples.size() >= m_frames_to_run)
+    {
+      if (!m_done.IsSet())
+      {
+        // The display list cache counters aren't per frame, and cover the whole replay.
+        m_display_list_cache_hits = stats.numDisplayListCacheHits;
+        m_display_list_cache_misses = stats.numDisplayListCacheMisses;
+        m_display_list_cache_fallbacks = stats.numDisplayListCacheFallbacks;
+        CPU::Break();
+        m_done.Set();
+        s_state_changed_event.Set();
+      }
+      return;
+    }
+
+    m_last_frame = player.GetCurrentFrameNum();
+    m_last_frame_start = Common::Timer::GetTimeUs();
+  }
+
+  bool IsDone() const { return m_done.IsSet(); }
+  picojson::value ToJson(const std::string& file, const std::string& backend,
+                         u32 frame_count) const;
+
+private:
+  // Hashes the XFB written by the last EFB to XFB copy. The copy parameters are still in BP
+  // memory at this point, so we can derive the region in the same way BPStructs does.
+  static u64 HashXFB()
+  {
+    const u32 address = bpmem.copyTexDest << 5;
+    const u32 stride = bpmem.copyMipMapStrideChannels << 5;
+    float y_scale;
+    if (bpmem.triggerEFBCopy.scale_invert)
+      y_scale = 256.0f / static_cast<float>(bpmem.dispcopyyscale);
+    else
+      y_scale = static_cast<float>(bpmem.dispcopyyscale) / 256.0f;
+    const u32 height = static_cast<u32>(1.0f + bpmem.copyTexSrcWH.y * y_scale);
+
+    // The XFB always lives in MEM1.
+    const u32 offset = address & Memory::RAM_MASK;
+    const u32 size = stride * height;
+    if (size == 0 || offset + size > Memory::REALRAM_SIZE)
+      return 0;
+    return GetHash64(Memory::m_pRAM + offset, size, 0);
+  }
+
+  u32 m_loops;
+  bool m_hash_xfb;
+  size_t m_frames_to_run = 0;
+  u32 m_last_frame = 0;
+  u64 m_last_frame_start = 0;
+  std::vector<FrameSample> m_samples;
+  u64 m_display_list_cache_hits = 0;
+  u64 m_display_list_cache_misses = 0;
+  u64 m_display_list_cache_fallbacks = 0;
+  Common::Flag m_done;
+};
+
+picojson::value FifoBenchmark::ToJson(const std::string& file, const std::string& backend,
+                                      u32 frame_count) const
+{
+  std::vector<u64> times;
+  times.reserve(m_samples.size());
+  for (const FrameSample& sample : m_samples)
+    times.push_back(sample.time_us);
+  std::sort(times.begin(), times.end());
+
+  const auto percentile = [&times](double p) {
+    if (times.empty())
+      return 0.0;
+    const size_t rank = static_cast<size_t>(p / 100.0 * (times.size() - 1) + 0.5);
+    return times[rank] / 1000.0;
+  };
+  const u64 total_us = std::accumulate(times.begin(), times.end(), u64(0));
+
+  picojson::object frame_time;
+  frame_time["min"] = picojson::value(percentile(0));
+  frame_time["mean"] = picojson::value(times.empty() ? 0.0 : total_us / 1000.0 / times.size());
+  frame_time["p50"] = picojson::value(percentile(50));
+  frame_time["p90"] = picojson::value(percentile(90));
+  frame_time["p95"] = picojson::value(percentile(95));
+  frame_time["p99"] = picojson::value(percentile(99));
+  frame_time["max"] = picojson::value(percentile(100));
+
+  // Per-frame data is only emitted for the first loop, later loops are checked against it.
+  picojson::array frames;
+  u32 hash_mismatches = 0;
+  for (size_t i = 0; i < m_samples.size(); ++i)
+  {
+    const FrameSample& sample = m_samples[i];
+    if (i >= frame_count)
+    {
+      if (m_hash_xfb && sample.xfb_hash != m_samples[i % frame_count].xfb_hash)
+        ++hash_mismatches;
+      continue;
+    }
+
+    picojson::object frame;
+    frame["frame"] = picojson::value(static_cast<double>(sample.frame));
+    frame["time_ms"] = picojson::value(sample.time_us / 1000.0);
+    frame["objects"] = picojson::value(static_cast<double>(sample.objects));
+    frame["draw_calls"] = picojson::value(static_cast<double>(sample.stats.numDrawCalls));
+    frame["primitives"] = picojson::value(static_cast<double>(sample.stats.numPrims));
+    frame["dl_primitives"] = picojson::value(static_cast<double>(sample.stats.numDLPrims));
+    frame["vertices_loaded"] = picojson::value(static_cast<double>(sample.stats.numVerticesLoaded));
+    frame["triangles_drawn"] = picojson::value(static_cast<double>(sample.stats.numTrianglesDrawn));
+    frame["bp_loads"] = picojson::value(static_cast<double>(sample.stats.numBPLoads));
+    frame["cp_loads"] = picojson::value(static_cast<double>(sample.stats.numCPLoads));
+    frame["xf_loads"] = picojson::value(static_cast<double>(sample.stats.numXFLoads));
+    frame["display_lists"] = picojson::value(static_cast<double>(sample.stats.numDListsCalled));
+    if (m_hash_xfb)
+      frame["xfb_hash"] = picojson::value(StringFromFormat("%016" PRIx64, sample.xfb_hash));
+    frames.emplace_back(std::move(frame));
+  }
+
+  picojson::object result;
+  result["version"] = picojson::value(Common::scm_rev_str);
+  result["file"] = picojson::value(file);
+  result["backend"] = picojson::value(backend);
+  result["loops"] = picojson::value(static_cast<double>(m_loops));
+  result["frames_per_loop"] = picojson::value(static_cast<double>(frame_count));
+  result["frames_measured"] = picojson::value(static_cast<double>(m_samples.size()));
+  result["total_time_ms"] = picojson::value(total_us / 1000.0);
+  result["fps"] = picojson::value(total_us ? m_samples.size() * 1000000.0 / total_us : 0.0);
+  result["frame_time_ms"] = picojson::value(frame_time);
+  result["frames"] = picojson::value(frames);
+  picojson::object display_list_cache;
+  display_list_cache["hits"] = picojson::value(static_cast<double>(m_display_list_cache_hits));
+  display_list_cache["misses"] = picojson::value(static_cast<double>(m_display_list_cache_misses));
+  display_list_cache["fallbacks"] =
+      picojson::value(static_cast<double>(m_display_list_cache_fallbacks));
+  result["display_list_cache"] = picojson::value(display_list_cache);
+  if (m_hash_xfb)
+    result["xfb_hash_mismatches"] = picojson::value(static_cast<double>(hash_mismatches));
+  return picojson::value(result);
+}
+}  // Anonymous namespace
+
+int main(int argc, char* argv[])
+{
+  optparse::OptionParser parser;
+  parser.usage("usage: %prog [options]... FILE.dff").version(Common::scm_rev_str);
+  parser.add_option("-u", "--user").action("store").help("User folder path");
+  parser.add_option("-v", "--video_backend")
+      .action("store")
+      .set_default("Null")
+      .help("Video backend to replay with (default: %default)");
+  parser.add_option("-l", "--loops")
+      .action("store")
+      .type("int")
+      .set_default(1)
+      .help("Number of times the FIFO log is replayed (default: %default)");
+  parser.add_option("-x", "--hash-xfb")
+      .action("store_true")
+      .help("Hash the XFB of each frame and check that all loops produce identical output");
+  parser.add_option("-o", "--output")
+      .action("store")
+      .help("Write the JSON report to this file instead of stdout");
+  parser.add_option("--no-display-list-cache")
+      .action("store_true")
+      .help("Decode display lists on every call instead of replaying them from the cache");
+
+  optparse::Values& options = parser.parse_args(argc, argv);
+  const std::vector<std::string> args = parser.args();
+  if (args.size() != 1)
+  {
+    parser.print_help();
+    return 1;
+  }
+
+  const std::string file = args.front();
+  const std::string backend = static_cast<const char*>(options.get("video_backend"));
+  const int loops = static_cast<int>(options.get("loops"));
+  const bool hash_xfb = static_cast<bool>(options.get("hash_xfb"));
+  if (loops < 1)
+  {
+    fprintf(stderr, "The number of loops must be at least 1\n");
+    return 1;
+  }
+
+  std::string user_directory;
+  if (options.is_set("user"))
+    user_directory = static_cast<const char*>(options.get("user"));
+
+  UICommon::SetUserDirectory(user_directory);
+  UICommon::Init();
+
+  // Run the GPU on the CPU thread, so that each frame is fully processed by the time the
+  // FifoPlayer moves on to the next one, and swap as soon as the XFB copy is done so that
+  // the video statistics line up with the frames of the FIFO log.
+  // The settings are restored before shutting down, so that they aren't saved to the user's
+  // configuration.
+  SConfig& config = SConfig::GetInstance();
+  const bool old_cpu_thread = config.bCPUThread;
+  const bool old_loop_fifo_replay = config.bLoopFifoReplay;
+  const std::string old_video_backend = config.m_strVideoBackend;
+  Common::ScopeGuard shutdown_guard{[&] {
+    config.bCPUThread = old_cpu_thread;
+    config.bLoopFifoReplay = old_loop_fifo_replay;
+    config.m_strVideoBackend = old_video_backend;
+    UICommon::Shutdown();
+  }};
+
+  config.bCPUThread = false;
+  config.bLoopFifoReplay = true;
+  config.m_strVideoBackend = backend;
+  VideoBackendBase::ActivateBackend(backend);
+  if (g_video_backend->GetName() != backend)
+  {
+    fprintf(stderr, "Unknown video backend: %s\n", backend.c_str());
+    return 1;
+  }
+  Config::SetCurrent(Config::GFX_HACK_IMMEDIATE_XFB, true);
+  if (hash_xfb)
+    Config::SetCurrent(Config::GFX_HACK_SKIP_XFB_COPY_TO_RAM, false);
+  if (static_cast<bool>(options.get("no_display_list_cache")))
+    Config::SetCurrent(Config::GFX_DISPLAY_LIST_CACHE, false);
+
+  FifoBenchmark benchmark(static_cast<u32>(loops), hash_xfb);
+  FifoPlayer& player = FifoPlayer::GetInstance();
+  player.SetFrameWrittenCallback([&benchmark] { benchmark.OnFrameWritten(); });
+
+  ToolHost::SetMessageCallback([](int id) {
+    if (id == WM_USER_STOP)
+      s_running.Clear();
+    s_state_changed_event.Set();
+  });
+  ToolHost::SetUpdateMainFrameCallback([] { s_state_changed_event.Set(); });
+  Core::SetOnStateChangedCallback([](Core::State state) {
+    if (state == Core::State::Uninitialized)
+      s_running.Clear();
+    s_state_changed_event.Set();
+  });
+
+  if (!BootManager::BootCore(BootParameters::GenerateFromFile(file)))
+  {
+    fprintf(stderr, "Could not boot %s\n", file.c_str());
+    return 1;
+  }
+
+  while (s_running.IsSet() && !benchmark.IsDone())
+  {
+    Core::HostDispatchJobs();
+    s_state_changed_event.WaitFor(std::chrono::milliseconds(100));
+  }
+
+  const u32 frame_count = player.GetFile() ? player.GetFile()->GetFrameCount() : 0;
+  const bool completed = benchmark.IsDone();
+
+  Core::Stop();
+  Core::Shutdown();
+  player.SetFrameWrittenCallback(nullptr);
+  shutdown_guard.Exit();
+
+  if (!completed)
+  {
+    fprintf(stderr, "Emulation stopped before the benchmark completed\n");
+    return 1;
+  }
+
+  const std::string report = benchmark.ToJson(file, backend, frame_count).serialize(true);
+  if (options.is_set("output"))
+  {
+    File::IOFile output(static_cast<const char*>(options.get("output")), "wb");
+    if (!output.WriteBytes(report.data(), report.size()))
+    {
+      fprintf(stderr, "Could not write the report\n");
+      return 1;
+    }
+  }
+  else
+  {
+    fwrite(report.data(), 1, report.size(), stdout);
+  }
+
+  return 0;
+}
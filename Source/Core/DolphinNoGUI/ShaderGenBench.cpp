@@ -0,0 +1,203 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Shader source generation benchmark.
+//
+// Reads the pipeline UIDs that a game recorded in its .uidcache, then generates the source of
+// every distinct vertex, geometry and pixel shader in them (and optionally of every ubershader)
+// a given number of times. It reports the generation rate and a hash of the generated sources,
+// which must not change when only the performance of the generators changes.
+
+#include <OptionParser.h>
+#include <cinttypes>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/Hash.h"
+#include "Common/Timer.h"
+#include "Common/Version.h"
+
+#include "VideoCommon/GXPipelineTypes.h"
+#include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/UberShaderPixel.h"
+#include "VideoCommon/UberShaderVertex.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/VideoCommon.h"
+
+namespace
+{
+constexpr u32 UID_CACHE_MAGIC = 0x44495550;  // PUID
+
+struct ShaderUids
+{
+  std::set<VertexShaderUid> vs;
+  std::set<GeometryShaderUid> gs;
+  std::set<PixelShaderUid> ps;
+  std::vector<UberShader::VertexShaderUid> uber_vs;
+  std::vector<UberShader::PixelShaderUid> uber_ps;
+};
+
+struct Totals
+{
+  u64 shaders = 0;
+  u64 bytes = 0;
+  u64 hash = 0;
+
+  void Add(const ShaderCode& code)
+  {
+    const std::string& source = code.GetBuffer();
+    ++shaders;
+    bytes += source.size();
+    hash = hash * 0x100000001b3 ^
+           HashAdler32(reinterpret_cast<const u8*>(source.data()), source.size());
+  }
+};
+
+bool ReadUidCache(const std::string& path, ShaderUids* uids)
+{
+  File::IOFile file(path, "rb");
+  u32 magic, version;
+  if (!file.ReadBytes(&magic, sizeof(magic)) || !file.ReadBytes(&version, sizeof(version)))
+    return false;
+  if (magic != UID_CACHE_MAGIC || version != VideoCommon::GX_PIPELINE_UID_VERSION)
+  {
+    fprintf(stderr, "%s is not a pipeline UID cache of this version\n", path.c_str());
+    return false;
+  }
+
+  VideoCommon::SerializedGXPipelineUid uid;
+  while (file.ReadBytes(&uid, sizeof(uid)))
+  {
+    uids->vs.insert(uid.vs_uid);
+    uids->gs.insert(uid.gs_uid);
+    uids->ps.insert(uid.ps_uid);
+  }
+  return true;
+}
+
+bool ParseAPI(const std::string& name, APIType* api_type)
+{
+  if (name == "opengl")
+    *api_type = APIType::OpenGL;
+  else if (name == "vulkan")
+    *api_type = APIType::Vulkan;
+  else if (name == "d3d")
+    *api_type = APIType::D3D;
+  else
+    return false;
+  return true;
+}
+
+// The features of a typical desktop GPU.
+ShaderHostConfig GetDefaultHostConfig()
+{
+  ShaderHostConfig host_config = {};
+  host_config.backend_dual_source_blend = true;
+  host_config.backend_geometry_shaders = true;
+  host_config.backend_early_z = true;
+  host_config.backend_bbox = true;
+  host_config.backend_gs_instancing = true;
+  host_config.backend_clip_control = true;
+  host_config.backend_ssaa = true;
+  host_config.backend_atomics = true;
+  host_config.backend_depth_clamp = true;
+  host_config.backend_bitfield = true;
+  host_config.backend_dynamic_sampler_indexing = true;
+  return host_config;
+}
+
+Totals GenerateAll(APIType api_type, const ShaderHostConfig& host_config, const ShaderUids& uids)
+{
+  Totals totals;
+  for (const VertexShaderUid& uid : uids.vs)
+    totals.Add(GenerateVertexShaderCode(api_type, host_config, uid.GetUidData()));
+  for (const GeometryShaderUid& uid : uids.gs)
+  {
+    if (!uid.GetUidData()->IsPassthrough())
+      totals.Add(GenerateGeometryShaderCode(api_type, host_config, uid.GetUidData()));
+  }
+  for (const PixelShaderUid& uid : uids.ps)
+    totals.Add(GeneratePixelShaderCode(api_type, host_config, uid.GetUidData()));
+  for (const UberShader::VertexShaderUid& uid : uids.uber_vs)
+    totals.Add(UberShader::GenVertexShader(api_type, host_config, uid.GetUidData()));
+  for (const UberShader::PixelShaderUid& uid : uids.uber_ps)
+    totals.Add(UberShader::GenPixelShader(api_type, host_config, uid.GetUidData()));
+  return totals;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+  optparse::OptionParser parser;
+  parser.usage("usage: %prog [options]... FILE.uidcache").version(Common::scm_rev_str);
+  parser.add_option("-a", "--api")
+      .action("store")
+      .set_default("opengl")
+      .help("Shading language to generate: opengl, vulkan or d3d (default: %default)");
+  parser.add_option("-c", "--host-config")
+      .action("store")
+      .help("Host config bits in hex, as in the names of the shader cache files "
+            "(default: the features of a typical desktop GPU)");
+  parser.add_option("-n", "--loops")
+      .action("store")
+      .type("int")
+      .set_default(10)
+      .help("Number of times every shader is generated (default: %default)");
+  parser.add_option("-u", "--ubershaders")
+      .action("store_true")
+      .help("Also generate every vertex and pixel ubershader");
+
+  optparse::Values& options = parser.parse_args(argc, argv);
+  const std::vector<std::string> args = parser.args();
+  const int loops = static_cast<int>(options.get("loops"));
+  APIType api_type;
+  if (args.size() != 1 || loops < 1 || !ParseAPI(options["api"], &api_type))
+  {
+    parser.print_help();
+    return 1;
+  }
+
+  ShaderHostConfig host_config = GetDefaultHostConfig();
+  if (options.is_set("host-config"))
+    host_config.bits = std::stoul(options["host-config"], nullptr, 16);
+
+  ShaderUids uids;
+  if (!ReadUidCache(args[0], &uids))
+  {
+    fprintf(stderr, "Could not read %s\n", args[0].c_str());
+    return 1;
+  }
+  if (static_cast<bool>(options.get("ubershaders")))
+  {
+    UberShader::EnumerateVertexShaderUids(
+        [&uids](const UberShader::VertexShaderUid& uid) { uids.uber_vs.push_back(uid); });
+    UberShader::EnumeratePixelShaderUids(
+        [&uids](const UberShader::PixelShaderUid& uid) { uids.uber_ps.push_back(uid); });
+  }
+  printf("%zu vertex, %zu geometry, %zu pixel shaders, %zu vertex and %zu pixel ubershaders\n",
+         uids.vs.size(), uids.gs.size(), uids.ps.size(), uids.uber_vs.size(),
+         uids.uber_ps.size());
+
+  Totals totals;
+  const u64 start = Common::Timer::GetTimeUs();
+  for (int i = 0; i < loops; ++i)
+    totals = GenerateAll(api_type, host_config, uids);
+  const double seconds = (Common::Timer::GetTimeUs() - start) / 1000000.0;
+
+  const double shaders = static_cast<double>(totals.shaders) * loops;
+  printf("Generated %" PRIu64 " shaders (%.1f KiB) %d times in %.3f s\n", totals.shaders,
+         totals.bytes / 1024.0, loops, seconds);
+  if (seconds > 0 && totals.shaders > 0)
+  {
+    printf("%.0f shaders/s, %.1f MB/s, %.1f us per shader\n", shaders / seconds,
+           totals.bytes * loops / seconds / 1000000, seconds * 1000000 / shaders);
+  }
+  printf("Source hash: %016" PRIx64 "\n", totals.hash);
+  return 0;
+}
@@ -0,0 +1,77 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "DolphinNoGUI/ToolHost.h"
+
+#include <string>
+#include <utility>
+
+#include "Core/Host.h"
+
+static std::function<void(int)> s_message_callback;
+static std::function<void()> s_update_main_frame_callback;
+
+namespace ToolHost
+{
+void SetMessageCallback(std::function<void(int)> callback)
+{
+  s_message_callback = std::move(callback);
+}
+
+void SetUpdateMainFrameCallback(std::function<void()> callback)
+{
+  s_update_main_frame_callback = std::move(callback);
+}
+}  // namespace ToolHost
+
+void Host_NotifyMapLoaded()
+{
+}
+void Host_RefreshDSPDebuggerWindow()
+{
+}
+void Host_Message(int id)
+{
+  if (s_message_callback)
+    s_message_callback(id);
+}
+void* Host_GetRenderHandle()
+{
+  return nullptr;
+}
+void Host_UpdateTitle(const std::string&)
+{
+}
+void Host_UpdateDisasmDialog()
+{
+}
+void Host_UpdateMainFrame()
+{
+  if (s_update_main_frame_callback)
+    s_update_main_frame_callback();
+}
+void Host_RequestRenderWindowSize(int, int)
+{
+}
+bool Host_UINeedsControllerState()
+{
+  return false;
+}
+bool Host_RendererHasFocus()
+{
+  return false;
+}
+bool Host_RendererIsFullscreen()
+{
+  return false;
+}
+void Host_ShowVideoConfig(void*, const std::string&)
+{
+}
+void Host_YieldToUI()
+{
+}
+void Host_UpdateProgressDialog(const char* caption, int position, int total)
+{
+}
@@ -0,0 +1,18 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+
+// Implements the Host_* functions of Core/Host.h for the command line tools, which have no UI.
+// Tools that run the emulation can follow its state through the callbacks, which have to be set
+// before it starts.
+namespace ToolHost
+{
+// Called by Host_Message() with the id of the message.
+void SetMessageCallback(std::function<void(int)> callback);
+// Called by Host_UpdateMainFrame().
+void SetUpdateMainFrameCallback(std::function<void()> callback);
+}  // namespace ToolHost
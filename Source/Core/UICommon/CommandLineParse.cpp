@@ -22,7 +22,7 @@ class CommandLineConfigLayerLoader final : public Config::ConfigLayerLoader
 {
 public:
   CommandLineConfigLayerLoader(const std::list<std::string>& args, const std::string& video_backend,
-                               const std::string& audio_backend)
+                               const std::string& audio_backend, const std::string& trace_file)
       : ConfigLayerLoader(Config::LayerType::CommandLine)
   {
     if (video_backend.size())
@@ -32,6 +32,9 @@ public:
       m_values.emplace_back(
           std::make_tuple(Config::MAIN_DSP_HLE.location, StringFromBool(audio_backend == "HLE")));
 
+    if (trace_file.size())
+      m_values.emplace_back(std::make_tuple(Config::MAIN_TRACE_FILE.location, trace_file));
+
     // Arguments are in the format of <System>.<Section>.<Key>=Value
     for (const auto& arg : args)
     {
@@ -102,22 +105,30 @@ std::unique_ptr<optparse::OptionParser> CreateParser(ParserOptions options)
 
   parser->set_defaults("video_backend", "");
   parser->set_defaults("audio_emulation", "");
+  parser->set_defaults("trace", "");
   parser->add_option("-v", "--video_backend").action("store").help("Specify a video backend");
   parser->add_option("-a", "--audio_emulation")
       .choices({"HLE", "LLE"})
       .help("Choose audio emulation from [%choices]");
+  parser->add_option("--trace")
+      .action("store")
+      .metavar("<file>")
+      .type("string")
+      .help("Record a timeline of the emulation threads to a Chrome trace file");
 
   return parser;
 }
 
 static void AddConfigLayer(const optparse::Values& options)
 {
-  if (options.is_set_by_user("config"))
+  if (options.is_set_by_user("config") || options.is_set_by_user("trace"))
   {
-    const std::list<std::string>& config_args = options.all("config");
+    const std::list<std::string> config_args =
+        options.is_set_by_user("config") ? options.all("config") : std::list<std::string>();
     Config::AddLayer(std::make_unique<CommandLineConfigLayerLoader>(
         config_args, static_cast<const char*>(options.get("video_backend")),
-        static_cast<const char*>(options.get("audio_emulation"))));
+        static_cast<const char*>(options.get("audio_emulation")),
+        static_cast<const char*>(options.get("trace"))));
   }
 }
 
@@ -18,7 +18,8 @@
 #include "VideoCommon/LookUpTables.h"
 #include "VideoCommon/PerfQueryBase.h"
 
-static u8 efb[EFB_WIDTH * EFB_HEIGHT * 6];
+// The texture encoder loads eight pixels at a time, and can read up to 32 bytes past the last one.
+static u8 efb[EFB_WIDTH * EFB_HEIGHT * 6 + 32];
 
 namespace EfbInterface
 {
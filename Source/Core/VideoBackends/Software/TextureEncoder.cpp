@@ -4,9 +4,13 @@
 
 #include "VideoBackends/Software/TextureEncoder.h"
 
-#include "Common/Align.h"
+#include <algorithm>
+#include <cstring>
+
+#include "Common/CPUDetect.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
 #include "Common/MsgHandler.h"
 #include "Common/Swap.h"
 
@@ -14,6 +18,7 @@
 
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/LookUpTables.h"
+#include "VideoCommon/ParallelBands.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
 
@@ -219,7 +224,9 @@ static void SetSpans(int sBlkSize, int tBlkSize, s32* tSpan, s32* sBlkSpan, s32*
 {
   // width is 1 less than the number of pixels of width
   u32 width = bpmem.copyTexSrcWH.x >> bpmem.triggerEFBCopy.half_scale;
-  u32 alignedWidth = Common::AlignUp(width, sBlkSize);
+  // The width of the blocks that SetBlockDimensions() counted, which is a whole block more than
+  // width when width is a multiple of the block width.
+  u32 alignedWidth = (width / sBlkSize + 1) * sBlkSize;
 
   u32 readStride = 3 << bpmem.triggerEFBCopy.half_scale;
 
@@ -1417,10 +1424,473 @@ static void EncodeZ24halfscale(u8* dst, const u8* src, EFBCopyFormat format)
   }
 }
 
+#ifdef _M_X86
 namespace
 {
-void EncodeEfbCopy(u8* dst, const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
-                   u32 num_blocks_y, u32 memory_stride, const EFBRectangle& src_rect,
+// The SSSE3 encoders unpack eight texels at a time into one vector per component, with a 16 bit
+// lane for every texel, and pack the components that the format uses straight into the blocks.
+// Copies are always a whole number of blocks wide, and blocks are four or eight texels wide.
+constexpr u32 EFB_LINE_BYTES = EFB_WIDTH * 3;
+// In EFB pixels, so half scale copies count four times as much as their size.
+constexpr u32 PARALLEL_ENCODE_THRESHOLD = 256 * 256;
+
+struct Texels
+{
+  __m128i r;
+  __m128i g;
+  __m128i b;
+  __m128i a;
+};
+
+// Eight pixels, four in the low 12 bytes of each vector. Reads 28 bytes.
+struct Pixels
+{
+  __m128i first;
+  __m128i second;
+};
+
+Pixels LoadPixels(const u8* src)
+{
+  return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12))};
+}
+
+// Returns byte i of every pixel, or bytes i and i + 1 as a little endian word.
+template <int i, bool word>
+FUNCTION_TARGET_SSSE3 __m128i GatherComponent(const Pixels& pixels)
+{
+  constexpr s8 hi0 = word ? i + 1 : -1;
+  constexpr s8 hi1 = word ? i + 4 : -1;
+  constexpr s8 hi2 = word ? i + 7 : -1;
+  constexpr s8 hi3 = word ? i + 10 : -1;
+  const __m128i mask = _mm_setr_epi8(i, hi0, i + 3, hi1, i + 6, hi2, i + 9, hi3, -1, -1, -1, -1,
+                                     -1, -1, -1, -1);
+  return _mm_unpacklo_epi64(_mm_shuffle_epi8(pixels.first, mask),
+                            _mm_shuffle_epi8(pixels.second, mask));
+}
+
+// The 6 bit components of RGBA6 pixels.
+FUNCTION_TARGET_SSSE3 Texels GatherRGBA6(const Pixels& pixels)
+{
+  const __m128i mask = _mm_set1_epi16(0x3f);
+  return {_mm_srli_epi16(GatherComponent<2, false>(pixels), 2),
+          _mm_and_si128(_mm_srli_epi16(GatherComponent<1, true>(pixels), 4), mask),
+          _mm_and_si128(_mm_srli_epi16(GatherComponent<0, true>(pixels), 6), mask),
+          _mm_and_si128(GatherComponent<0, false>(pixels), mask)};
+}
+
+// RGB8 pixels are stored as b, g, r. The half scale depth encoders have always kept that order for
+// some formats, so they don't swap red and blue.
+template <bool swap_red_blue>
+FUNCTION_TARGET_SSSE3 Texels GatherRGB8(const Pixels& pixels)
+{
+  const __m128i low = GatherComponent<0, false>(pixels);
+  const __m128i high = GatherComponent<2, false>(pixels);
+  const __m128i alpha = _mm_set1_epi16(0xff);
+  if (swap_red_blue)
+    return {high, GatherComponent<1, false>(pixels), low, alpha};
+  return {low, GatherComponent<1, false>(pixels), high, alpha};
+}
+
+// Adds up each component of two lines of sixteen pixels, for the eight 2x2 squares in them.
+template <typename Gather>
+FUNCTION_TARGET_SSSE3 Texels SumSquares(const u8* src, Gather gather)
+{
+  const Texels left = gather(LoadPixels(src));
+  const Texels right = gather(LoadPixels(src + 24));
+  const Texels bottom_left = gather(LoadPixels(src + EFB_LINE_BYTES));
+  const Texels bottom_right = gather(LoadPixels(src + EFB_LINE_BYTES + 24));
+  const auto sum = [](__m128i left_sums, __m128i right_sums) {
+    const __m128i ones = _mm_set1_epi16(1);
+    return _mm_packs_epi32(_mm_madd_epi16(left_sums, ones), _mm_madd_epi16(right_sums, ones));
+  };
+  return {sum(_mm_add_epi16(left.r, bottom_left.r), _mm_add_epi16(right.r, bottom_right.r)),
+          sum(_mm_add_epi16(left.g, bottom_left.g), _mm_add_epi16(right.g, bottom_right.g)),
+          sum(_mm_add_epi16(left.b, bottom_left.b), _mm_add_epi16(right.b, bottom_right.b)),
+          sum(_mm_add_epi16(left.a, bottom_left.a), _mm_add_epi16(right.a, bottom_right.a))};
+}
+
+// The unpackers return the texel at src and the seven after it. TEXEL_BYTES is the distance between
+// texels in the EFB, which is two pixels for half scale copies.
+struct UnpackRGBA6
+{
+  static constexpr u32 TEXEL_BYTES = 3;
+
+  FUNCTION_TARGET_SSSE3 static Texels Unpack(const u8* src)
+  {
+    const auto convert = [](__m128i x) {
+      return _mm_or_si128(_mm_slli_epi16(x, 2), _mm_srli_epi16(x, 4));
+    };
+    const Texels components = GatherRGBA6(LoadPixels(src));
+    return {convert(components.r), convert(components.g), convert(components.b),
+            convert(components.a)};
+  }
+};
+
+struct UnpackRGBA6Boxfilter
+{
+  static constexpr u32 TEXEL_BYTES = 6;
+
+  FUNCTION_TARGET_SSSE3 static Texels Unpack(const u8* src)
+  {
+    // Like Convert6To8 on the average, the sums are at most 4 * 63.
+    const auto convert = [](__m128i x) { return _mm_add_epi16(x, _mm_srli_epi16(x, 6)); };
+    const Texels sums = SumSquares(src, GatherRGBA6);
+    return {convert(sums.r), convert(sums.g), convert(sums.b), convert(sums.a)};
+  }
+};
+
+struct UnpackRGB8
+{
+  static constexpr u32 TEXEL_BYTES = 3;
+
+  FUNCTION_TARGET_SSSE3 static Texels Unpack(const u8* src)
+  {
+    return GatherRGB8<true>(LoadPixels(src));
+  }
+};
+
+template <bool swap_red_blue>
+struct UnpackRGB8Boxfilter
+{
+  static constexpr u32 TEXEL_BYTES = 6;
+
+  FUNCTION_TARGET_SSSE3 static Texels Unpack(const u8* src)
+  {
+    const Texels sums = SumSquares(src, GatherRGB8<swap_red_blue>);
+    return {_mm_srli_epi16(sums.r, 2), _mm_srli_epi16(sums.g, 2), _mm_srli_epi16(sums.b, 2),
+            _mm_set1_epi16(0xff)};
+  }
+};
+
+// Like RGB8_to_I. The sum is at most 60196, so it fits in the unsigned 16 bit lanes.
+__m128i ConvertToIntensity(const Texels& texels)
+{
+  const __m128i r = _mm_mullo_epi16(texels.r, _mm_set1_epi16(66));
+  const __m128i g = _mm_mullo_epi16(texels.g, _mm_set1_epi16(129));
+  const __m128i b = _mm_mullo_epi16(texels.b, _mm_set1_epi16(25));
+  const __m128i sum = _mm_add_epi16(_mm_add_epi16(r, g), _mm_add_epi16(b, _mm_set1_epi16(4096)));
+  return _mm_srli_epi16(sum, 8);
+}
+
+__m128i SwapBytes16(__m128i values)
+{
+  return _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+}
+
+template <u32 width_log2, u32 height_log2, u32 line_bytes, u32 block_bytes>
+struct BlockLayout
+{
+  static constexpr u32 BLOCK_WIDTH_LOG2 = width_log2;
+  static constexpr u32 BLOCK_HEIGHT_LOG2 = height_log2;
+  static constexpr u32 LINE_BYTES = line_bytes;
+  static constexpr u32 BLOCK_BYTES = block_bytes;
+};
+
+// The packers write the eight texels to one line of a block that is eight texels wide, or to one
+// line of two blocks that are four texels wide. The second of those is left alone if the copy ends
+// after the first.
+template <typename Layout>
+void StoreLines(u8* dst, __m128i values, bool second_block)
+{
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), values);
+  if (second_block)
+    _mm_storeh_pd(reinterpret_cast<double*>(dst + Layout::BLOCK_BYTES), _mm_castsi128_pd(values));
+}
+
+struct PackR4 : BlockLayout<3, 3, 4, 32>
+{
+  static void Pack(u8* dst, const Texels& texels, bool)
+  {
+    // Even texels in the low half of each 32 bit lane, odd ones in the high half.
+    const __m128i bytes = _mm_or_si128(_mm_and_si128(texels.r, _mm_set1_epi32(0xf0)),
+                                       _mm_srli_epi32(texels.r, 20));
+    const __m128i words = _mm_packs_epi32(bytes, bytes);
+    const u32 packed = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+    std::memcpy(dst, &packed, sizeof(packed));
+  }
+};
+
+template <__m128i Texels::*component>
+struct PackX8 : BlockLayout<3, 2, 8, 32>
+{
+  static void Pack(u8* dst, const Texels& texels, bool)
+  {
+    const __m128i x = texels.*component;
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(x, x));
+  }
+};
+
+struct PackRA4 : BlockLayout<3, 2, 8, 32>
+{
+  static void Pack(u8* dst, const Texels& texels, bool)
+  {
+    const __m128i x = _mm_or_si128(_mm_and_si128(texels.a, _mm_set1_epi16(0xf0)),
+                                   _mm_srli_epi16(texels.r, 4));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(x, x));
+  }
+};
+
+template <__m128i Texels::*first, __m128i Texels::*second>
+struct PackXY8 : BlockLayout<2, 2, 8, 32>
+{
+  static void Pack(u8* dst, const Texels& texels, bool second_block)
+  {
+    const __m128i values = _mm_or_si128(texels.*first, _mm_slli_epi16(texels.*second, 8));
+    StoreLines<PackXY8>(dst, values, second_block);
+  }
+};
+
+struct PackRGB565 : BlockLayout<2, 2, 8, 32>
+{
+  static void Pack(u8* dst, const Texels& texels, bool second_block)
+  {
+    const __m128i r = _mm_slli_epi16(_mm_srli_epi16(texels.r, 3), 11);
+    const __m128i g = _mm_slli_epi16(_mm_srli_epi16(texels.g, 2), 5);
+    const __m128i b = _mm_srli_epi16(texels.b, 3);
+    const __m128i values = SwapBytes16(_mm_or_si128(_mm_or_si128(r, g), b));
+    StoreLines<PackRGB565>(dst, values, second_block);
+  }
+};
+
+struct PackRGB5A3 : BlockLayout<2, 2, 8, 32>
+{
+  static void Pack(u8* dst, const Texels& texels, bool second_block)
+  {
+    const __m128i rgb555 = _mm_or_si128(
+        _mm_or_si128(_mm_set1_epi16(-0x8000), _mm_slli_epi16(_mm_srli_epi16(texels.r, 3), 10)),
+        _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(texels.g, 3), 5), _mm_srli_epi16(texels.b, 3)));
+    const __m128i argb4443 = _mm_or_si128(
+        _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(texels.a, 5), 12),
+                     _mm_slli_epi16(_mm_srli_epi16(texels.r, 4), 8)),
+        _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(texels.g, 4), 4), _mm_srli_epi16(texels.b, 4)));
+    // Alpha of at least 224 is stored as opaque.
+    const __m128i opaque = _mm_cmpgt_epi16(texels.a, _mm_set1_epi16(223));
+    const __m128i values = SwapBytes16(
+        _mm_or_si128(_mm_and_si128(opaque, rgb555), _mm_andnot_si128(opaque, argb4443)));
+    StoreLines<PackRGB5A3>(dst, values, second_block);
+  }
+};
+
+// AR in the first half of the block, GB in the second.
+struct PackRGBA8 : BlockLayout<2, 2, 8, 64>
+{
+  static void Pack(u8* dst, const Texels& texels, bool second_block)
+  {
+    StoreLines<PackRGBA8>(dst, _mm_or_si128(texels.a, _mm_slli_epi16(texels.r, 8)),
+                          second_block);
+    StoreLines<PackRGBA8>(dst + 32, _mm_or_si128(texels.g, _mm_slli_epi16(texels.b, 8)),
+                          second_block);
+  }
+};
+
+using EncodeFunction = void (*)(u8* dst, const u8* src, u32 num_blocks_x, u32 write_stride,
+                                u32 first_row, u32 end_row);
+
+template <typename Unpacker, bool intensity, typename Packer>
+FUNCTION_TARGET_SSSE3 void EncodeBlockRows(u8* dst, const u8* src, u32 num_blocks_x,
+                                           u32 write_stride, u32 first_row, u32 end_row)
+{
+  constexpr u32 block_height = 1 << Packer::BLOCK_HEIGHT_LOG2;
+  // Half scale copies read two lines of pixels for every line of texels.
+  constexpr u32 src_line_stride = EFB_LINE_BYTES * Unpacker::TEXEL_BYTES / 3;
+  const u32 line_width = num_blocks_x << Packer::BLOCK_WIDTH_LOG2;
+
+  for (u32 row = first_row; row < end_row; row++)
+  {
+    for (u32 t = 0; t < block_height; t++)
+    {
+      const u8* src_line = src + (row * block_height + t) * src_line_stride;
+      u8* dst_line = dst + row * write_stride + t * Packer::LINE_BYTES;
+      for (u32 x = 0; x < line_width; x += 8)
+      {
+        Texels texels = Unpacker::Unpack(src_line + x * Unpacker::TEXEL_BYTES);
+        if (intensity)
+          texels.r = ConvertToIntensity(texels);
+        Packer::Pack(dst_line + (x >> Packer::BLOCK_WIDTH_LOG2) * Packer::BLOCK_BYTES, texels,
+                     x + 4 < line_width);
+      }
+    }
+  }
+}
+
+struct BlockEncoder
+{
+  EncodeFunction encode;
+  u32 block_width_log2;
+  u32 block_height_log2;
+};
+
+template <typename Unpacker, typename Packer>
+BlockEncoder MakeEncoder(bool intensity)
+{
+  return {intensity ? &EncodeBlockRows<Unpacker, true, Packer> :
+                      &EncodeBlockRows<Unpacker, false, Packer>,
+          Packer::BLOCK_WIDTH_LOG2, Packer::BLOCK_HEIGHT_LOG2};
+}
+
+// intensity only applies to the formats that can be converted to YUV.
+template <typename Unpacker>
+bool GetBlockEncoder(EFBCopyFormat format, bool intensity, BlockEncoder* encoder)
+{
+  switch (format)
+  {
+  case EFBCopyFormat::R4:
+    *encoder = MakeEncoder<Unpacker, PackR4>(intensity);
+    return true;
+  case EFBCopyFormat::R8_0x1:
+  case EFBCopyFormat::R8:
+    *encoder = MakeEncoder<Unpacker, PackX8<&Texels::r>>(intensity);
+    return true;
+  case EFBCopyFormat::RA4:
+    *encoder = MakeEncoder<Unpacker, PackRA4>(intensity);
+    return true;
+  case EFBCopyFormat::RA8:
+    *encoder = MakeEncoder<Unpacker, PackXY8<&Texels::a, &Texels::r>>(intensity);
+    return true;
+  case EFBCopyFormat::RGB565:
+    *encoder = MakeEncoder<Unpacker, PackRGB565>(false);
+    return true;
+  case EFBCopyFormat::RGB5A3:
+    *encoder = MakeEncoder<Unpacker, PackRGB5A3>(false);
+    return true;
+  case EFBCopyFormat::RGBA8:
+    *encoder = MakeEncoder<Unpacker, PackRGBA8>(false);
+    return true;
+  case EFBCopyFormat::A8:
+    *encoder = MakeEncoder<Unpacker, PackX8<&Texels::a>>(false);
+    return true;
+  case EFBCopyFormat::G8:
+    *encoder = MakeEncoder<Unpacker, PackX8<&Texels::g>>(false);
+    return true;
+  case EFBCopyFormat::B8:
+    *encoder = MakeEncoder<Unpacker, PackX8<&Texels::b>>(false);
+    return true;
+  case EFBCopyFormat::RG8:
+    *encoder = MakeEncoder<Unpacker, PackXY8<&Texels::g, &Texels::r>>(false);
+    return true;
+  case EFBCopyFormat::GB8:
+    *encoder = MakeEncoder<Unpacker, PackXY8<&Texels::b, &Texels::g>>(false);
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool GetDepthBlockEncoder(EFBCopyFormat format, bool scale_by_half, BlockEncoder* encoder)
+{
+  using UnpackDepthBoxfilter = UnpackRGB8Boxfilter<false>;
+  switch (format)
+  {
+  // The depth encoders don't support these.
+  case EFBCopyFormat::RA4:
+  case EFBCopyFormat::RA8:
+  case EFBCopyFormat::RGB565:
+  case EFBCopyFormat::RGB5A3:
+  case EFBCopyFormat::A8:
+    return false;
+  case EFBCopyFormat::RGBA8:
+    if (scale_by_half)
+    {
+      *encoder = MakeEncoder<UnpackDepthBoxfilter, PackRGBA8>(false);
+      return true;
+    }
+    break;
+  case EFBCopyFormat::RG8:
+    if (scale_by_half)
+    {
+      *encoder = MakeEncoder<UnpackDepthBoxfilter, PackXY8<&Texels::g, &Texels::r>>(false);
+      return true;
+    }
+    break;
+  case EFBCopyFormat::GB8:
+    if (scale_by_half)
+    {
+      *encoder = MakeEncoder<UnpackDepthBoxfilter, PackXY8<&Texels::b, &Texels::g>>(false);
+      return true;
+    }
+    break;
+  default:
+    break;
+  }
+
+  if (scale_by_half)
+    return GetBlockEncoder<UnpackRGB8Boxfilter<true>>(format, false, encoder);
+  return GetBlockEncoder<UnpackRGB8>(format, false, encoder);
+}
+
+// Returns false if the copy has to be encoded by EncodeGeneric.
+bool EncodeInBlocks(u8* dst, const EFBCopyParams& params, const EFBRectangle& src_rect,
+                    bool scale_by_half)
+{
+  if (!cpu_info.bSSSE3)
+    return false;
+
+  const EFBCopyFormat format = params.copy_format;
+  BlockEncoder encoder;
+  bool supported = false;
+  switch (params.efb_format)
+  {
+  case PEControl::RGBA6_Z24:
+    if (scale_by_half)
+      supported = GetBlockEncoder<UnpackRGBA6Boxfilter>(format, params.yuv, &encoder);
+    else
+      supported = GetBlockEncoder<UnpackRGBA6>(format, params.yuv, &encoder);
+    break;
+  case PEControl::RGB8_Z24:
+  case PEControl::RGB565_Z16:
+    // The generic encoder only has to fill these with 0xff.
+    if (format == EFBCopyFormat::A8)
+      break;
+    if (scale_by_half)
+      supported = GetBlockEncoder<UnpackRGB8Boxfilter<true>>(format, params.yuv, &encoder);
+    else
+      supported = GetBlockEncoder<UnpackRGB8>(format, params.yuv, &encoder);
+    break;
+  case PEControl::Z24:
+    supported = GetDepthBlockEncoder(format, scale_by_half, &encoder);
+    break;
+  default:
+    break;
+  }
+  if (!supported)
+    return false;
+
+  const u8* src = EfbInterface::GetPixelPointer(src_rect.left, src_rect.top, params.depth);
+  // The same size as the generic encoders use. width and height are one less than the size.
+  const u32 width = bpmem.copyTexSrcWH.x >> bpmem.triggerEFBCopy.half_scale;
+  const u32 height = bpmem.copyTexSrcWH.y >> bpmem.triggerEFBCopy.half_scale;
+  const u32 num_blocks_x = (width >> encoder.block_width_log2) + 1;
+  const u32 num_block_rows = (height >> encoder.block_height_log2) + 1;
+  const u32 write_stride = bpmem.copyMipMapStrideChannels * 32;
+
+  const u32 num_pixels = (num_blocks_x << encoder.block_width_log2) *
+                         (num_block_rows << encoder.block_height_log2)
+                         << (scale_by_half ? 2 : 0);
+  const size_t num_threads =
+      num_pixels >= PARALLEL_ENCODE_THRESHOLD ? ParallelBands::GetThreadCount() : 1;
+  if (num_threads > 1)
+  {
+    // A few bands per thread, so that a thread that was descheduled doesn't hold the others up.
+    const u32 max_bands = static_cast<u32>(num_threads) * 2;
+    const u32 rows_per_band = (num_block_rows + max_bands - 1) / max_bands;
+    const u32 num_bands = (num_block_rows + rows_per_band - 1) / rows_per_band;
+    const bool encoded = ParallelBands::Run(num_bands, [&](int band) {
+      const u32 first_row = band * rows_per_band;
+      encoder.encode(dst, src, num_blocks_x, write_stride, first_row,
+                     std::min(first_row + rows_per_band, num_block_rows));
+    });
+    if (encoded)
+      return true;
+  }
+
+  encoder.encode(dst, src, num_blocks_x, write_stride, 0, num_block_rows);
+  return true;
+}
+}  // namespace
+#endif
+
+void EncodeGeneric(u8* dst, const EFBCopyParams& params, const EFBRectangle& src_rect,
                    bool scale_by_half)
 {
   const u8* src = EfbInterface::GetPixelPointer(src_rect.left, src_rect.top, params.depth);
@@ -1466,7 +1936,6 @@ void EncodeEfbCopy(u8* dst, const EFBCopyParams& params, u32 native_width, u32 b
     }
   }
 }
-}
 
 void Encode(u8* dst, const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
             u32 num_blocks_y, u32 memory_stride, const EFBRectangle& src_rect, bool scale_by_half)
@@ -1477,8 +1946,11 @@ void Encode(u8* dst, const EFBCopyParams& params, u32 native_width, u32 bytes_pe
   }
   else
   {
-    EncodeEfbCopy(dst, params, native_width, bytes_per_row, num_blocks_y, memory_stride, src_rect,
-                  scale_by_half);
+#ifdef _M_X86
+    if (EncodeInBlocks(dst, params, src_rect, scale_by_half))
+      return;
+#endif
+    EncodeGeneric(dst, params, src_rect, scale_by_half);
   }
 }
 }
@@ -13,4 +13,9 @@ namespace TextureEncoder
 {
 void Encode(u8* dst, const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
             u32 num_blocks_y, u32 memory_stride, const EFBRectangle& src_rect, bool scale_by_half);
+
+// Encodes one texel at a time. Encode() only uses it for the copies that the SSSE3 block encoders
+// can't do, and on hosts without SSSE3; the tests check the block encoders against it.
+void EncodeGeneric(u8* dst, const EFBCopyParams& params, const EFBRectangle& src_rect,
+                   bool scale_by_half);
 }
@@ -2,9 +2,15 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cinttypes>
+#include <iterator>
 #include <mutex>
 
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
 #include "VideoCommon/AsyncRequests.h"
+#include "VideoCommon/EFBAccessCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -12,119 +18,169 @@
 
 AsyncRequests AsyncRequests::s_singleton;
 
+namespace
+{
+constexpr const char* EVENT_NAMES[] = {"EFB poke color", "EFB poke Z", "EFB peek color",
+                                       "EFB peek Z",     "EFB peek tile", "Swap",
+                                       "BBox read",      "Perf query"};
+static_assert(std::size(EVENT_NAMES) == AsyncRequests::Event::NUM_TYPES,
+              "every event type needs a name");
+}  // namespace
+
 AsyncRequests::AsyncRequests() : m_enable(false), m_passthrough(true)
 {
 }
 
 void AsyncRequests::PullEventsInternal()
 {
-  std::unique_lock<std::mutex> lock(m_mutex);
-  m_empty.Set();
-
-  while (!m_queue.empty())
+  const size_t count = m_queue.Size();
+  for (size_t i = 0; i < count;)
   {
-    Event e = m_queue.front();
-
-    // try to merge as many efb pokes as possible
-    // it's a bit hacky, but some games render a complete frame in this way
-    if ((e.type == Event::EFB_POKE_COLOR || e.type == Event::EFB_POKE_Z))
-    {
-      m_merged_efb_pokes.clear();
-      Event first_event = m_queue.front();
-      const auto t = first_event.type == Event::EFB_POKE_COLOR ? EFBAccessType::PokeColor :
-                                                                 EFBAccessType::PokeZ;
-
-      do
-      {
-        e = m_queue.front();
-
-        EfbPokeData d;
-        d.data = e.efb_poke.data;
-        d.x = e.efb_poke.x;
-        d.y = e.efb_poke.y;
-        m_merged_efb_pokes.push_back(d);
-
-        m_queue.pop();
-      } while (!m_queue.empty() && m_queue.front().type == first_event.type);
-
-      lock.unlock();
-      g_renderer->PokeEFB(t, m_merged_efb_pokes.data(), m_merged_efb_pokes.size());
-      lock.lock();
-      continue;
-    }
-
-    lock.unlock();
-    HandleEvent(e);
-    lock.lock();
-
-    m_queue.pop();
+    size_t contiguous;
+    const QueuedEvent* events = m_queue.Peek(i, &contiguous);
+    i += HandleEvents(events, std::min(contiguous, count - i));
   }
+  m_queue.Pop(count);
+  m_handled.fetch_add(count);
 
-  if (m_wake_me_up_again)
+  // The CPU thread sets the flag before it checks m_handled, so either it sees the events as
+  // handled or we see the flag.
+  if (m_wake_me_up_again.load())
   {
-    m_wake_me_up_again = false;
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_cond.notify_all();
   }
 }
 
-void AsyncRequests::PushEvent(const AsyncRequests::Event& event, bool blocking)
+void AsyncRequests::PushEvents(const Event* events, size_t count, bool blocking)
 {
-  std::unique_lock<std::mutex> lock(m_mutex);
+  const u64 now = Common::Timer::GetTimeUs();
+  m_push_buffer.resize(count);
+  for (size_t i = 0; i < count; i++)
+    m_push_buffer[i] = {events[i], now};
 
-  if (m_passthrough)
+  if (m_passthrough.load())
   {
-    HandleEvent(event);
+    for (size_t i = 0; i < count;)
+      i += HandleEvents(&m_push_buffer[i], count - i);
     return;
   }
 
-  m_empty.Clear();
-  m_wake_me_up_again |= blocking;
-
-  if (!m_enable)
+  if (!m_enable.load())
     return;
 
-  m_queue.push(event);
+  const QueuedEvent* queued = m_push_buffer.data();
+  while (count != 0)
+  {
+    const size_t batch = std::min(count, QUEUE_SIZE);
+    if (!m_queue.Push(queued, batch))
+    {
+      m_full_queue_waits.fetch_add(1, std::memory_order_relaxed);
+      WaitForEvents(m_pushed + batch - QUEUE_SIZE);
+      if (!m_enable.load())
+        return;
+      continue;
+    }
+
+    m_pushed += batch;
+    queued += batch;
+    count -= batch;
+  }
 
   Fifo::RunGpu();
   if (blocking)
-  {
-    m_cond.wait(lock, [this] { return m_queue.empty(); });
-  }
+    WaitForEvents(m_pushed);
+}
+
+void AsyncRequests::WaitForEvents(u64 count)
+{
+  if (m_handled.load() >= count)
+    return;
+
+  Fifo::RunGpu();
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_wake_me_up_again.store(true);
+  m_cond.wait(lock, [this, count] { return m_handled.load() >= count || !m_enable.load(); });
+  m_wake_me_up_again.store(false);
 }
 
 void AsyncRequests::SetEnable(bool enable)
 {
   std::unique_lock<std::mutex> lock(m_mutex);
-  m_enable = enable;
+  m_enable.store(enable);
 
   if (!enable)
   {
     // flush the queue on disabling
-    while (!m_queue.empty())
-      m_queue.pop();
-    if (m_wake_me_up_again)
-      m_cond.notify_all();
+    const size_t count = m_queue.Size();
+    m_queue.Pop(count);
+    m_handled.fetch_add(count);
+    m_cond.notify_all();
   }
 }
 
-void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
+u16 AsyncRequests::ReadBoundingBox(int index)
 {
-  EFBRectangle rc;
-  switch (e.type)
+  // Games read the four coordinates one after the other, usually without drawing in between.
+  if (m_bbox_values_epoch == m_bbox_epoch.load(std::memory_order_relaxed))
   {
-  case Event::EFB_POKE_COLOR:
+    m_merged_requests.fetch_add(1, std::memory_order_relaxed);
+  }
+  else
   {
-    EfbPokeData poke = {e.efb_poke.x, e.efb_poke.y, e.efb_poke.data};
-    g_renderer->PokeEFB(EFBAccessType::PokeColor, &poke, 1);
+    Event e;
+    e.time = 0;
+    e.type = Event::BBOX_READ;
+    e.bbox.data = m_bbox_values.data();
+    e.bbox.epoch = &m_bbox_values_epoch;
+    PushEvent(e, true);
   }
-  break;
 
-  case Event::EFB_POKE_Z:
+  return m_bbox_values[index];
+}
+
+size_t AsyncRequests::HandleEvents(const QueuedEvent* events, size_t count)
+{
+  const Event::Type type = events[0].event.type;
+  size_t handled = 1;
+
+  // try to merge as many efb pokes as possible
+  // it's a bit hacky, but some games render a complete frame in this way
+  if (type == Event::EFB_POKE_COLOR || type == Event::EFB_POKE_Z)
   {
-    EfbPokeData poke = {e.efb_poke.x, e.efb_poke.y, e.efb_poke.data};
-    g_renderer->PokeEFB(EFBAccessType::PokeZ, &poke, 1);
+    m_merged_efb_pokes.clear();
+    for (handled = 0; handled < count && events[handled].event.type == type; handled++)
+    {
+      const Event& e = events[handled].event;
+      m_merged_efb_pokes.push_back({e.efb_poke.x, e.efb_poke.y, e.efb_poke.data});
+    }
+
+    g_renderer->PokeEFB(type == Event::EFB_POKE_COLOR ? EFBAccessType::PokeColor :
+                                                        EFBAccessType::PokeZ,
+                        m_merged_efb_pokes.data(), m_merged_efb_pokes.size());
+    m_merged_requests.fetch_add(handled - 1, std::memory_order_relaxed);
+  }
+  else
+  {
+    HandleEvent(events[0].event);
   }
-  break;
+
+  const u64 now = Common::Timer::GetTimeUs();
+  for (size_t i = 0; i < handled; i++)
+    RecordLatency(type, events[i].push_time_us, now);
+  return handled;
+}
+
+void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
+{
+  EFBRectangle rc;
+  switch (e.type)
+  {
+  // Merged by HandleEvents().
+  case Event::EFB_POKE_COLOR:
+  case Event::EFB_POKE_Z:
+  case Event::NUM_TYPES:
+    break;
 
   case Event::EFB_PEEK_COLOR:
     *e.efb_peek.data =
@@ -135,13 +191,20 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
     *e.efb_peek.data = g_renderer->AccessEFB(EFBAccessType::PeekZ, e.efb_peek.x, e.efb_peek.y, 0);
     break;
 
+  case Event::EFB_PEEK_TILE:
+    EFBAccessCache::ReadTile(e.efb_peek_tile.depth, e.efb_peek_tile.x, e.efb_peek_tile.y,
+                             e.efb_peek_tile.data, e.efb_peek_tile.epoch);
+    break;
+
   case Event::SWAP_EVENT:
     g_renderer->Swap(e.swap_event.xfbAddr, e.swap_event.fbWidth, e.swap_event.fbStride,
                      e.swap_event.fbHeight, rc, e.time);
     break;
 
   case Event::BBOX_READ:
-    *e.bbox.data = g_renderer->BBoxRead(e.bbox.index);
+    for (int i = 0; i < 4; i++)
+      e.bbox.data[i] = g_renderer->BBoxRead(i);
+    *e.bbox.epoch = m_bbox_epoch.load(std::memory_order_relaxed);
     break;
 
   case Event::PERF_QUERY:
@@ -150,8 +213,70 @@ void AsyncRequests::HandleEvent(const AsyncRequests::Event& e)
   }
 }
 
+void AsyncRequests::RecordLatency(Event::Type type, u64 push_time_us, u64 now_us)
+{
+  const u64 latency_us = now_us - push_time_us;
+  size_t bucket = 0;
+  while (bucket < LATENCY_BUCKETS - 1 && (u64(1) << bucket) <= latency_us)
+    ++bucket;
+  m_latency[type][bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+AsyncRequests::LatencyHistogram AsyncRequests::GetLatencyHistogram(Event::Type type) const
+{
+  LatencyHistogram histogram;
+  for (size_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket)
+    histogram[bucket] = m_latency[type][bucket].load(std::memory_order_relaxed);
+  return histogram;
+}
+
+std::string AsyncRequests::GetStatisticsString() const
+{
+  std::string str = StringFromFormat(
+      "Async requests merged: %" PRIu64 ", waits for a full queue: %" PRIu64 "\n",
+      m_merged_requests.load(std::memory_order_relaxed),
+      m_full_queue_waits.load(std::memory_order_relaxed));
+
+  for (int type = 0; type < Event::NUM_TYPES; ++type)
+  {
+    const LatencyHistogram histogram = GetLatencyHistogram(static_cast<Event::Type>(type));
+    u64 total = 0;
+    std::string buckets;
+    for (size_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket)
+    {
+      if (!histogram[bucket])
+        continue;
+
+      total += histogram[bucket];
+      if (bucket == LATENCY_BUCKETS - 1)
+        buckets += StringFromFormat(" >=%" PRIu64 ":%" PRIu64, u64(1) << (bucket - 1),
+                                    histogram[bucket]);
+      else
+        buckets += StringFromFormat(" <%" PRIu64 ":%" PRIu64, u64(1) << bucket, histogram[bucket]);
+    }
+
+    if (total != 0)
+    {
+      str += StringFromFormat("%s latency (us): %" PRIu64 " requests%s\n", EVENT_NAMES[type],
+                              total, buckets.c_str());
+    }
+  }
+  return str;
+}
+
+void AsyncRequests::ResetStatistics()
+{
+  for (auto& histogram : m_latency)
+  {
+    for (std::atomic<u64>& bucket : histogram)
+      bucket.store(0, std::memory_order_relaxed);
+  }
+  m_merged_requests.store(0, std::memory_order_relaxed);
+  m_full_queue_waits.store(0, std::memory_order_relaxed);
+}
+
 void AsyncRequests::SetPassthrough(bool enable)
 {
   std::unique_lock<std::mutex> lock(m_mutex);
-  m_passthrough = enable;
+  m_passthrough.store(enable);
 }
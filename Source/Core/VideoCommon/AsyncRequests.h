@@ -4,16 +4,22 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <mutex>
-#include <queue>
+#include <string>
 #include <vector>
 
 #include "Common/CommonTypes.h"
-#include "Common/Flag.h"
+#include "Common/SPSCRingBuffer.h"
 
 struct EfbPokeData;
 
+// Requests from the CPU thread to the GPU thread. The CPU thread pushes them into a lock-free
+// ring, and only takes the lock to sleep when it has to wait for the GPU thread. Without a GPU
+// thread (passthrough), they are handled right away on the calling thread.
 class AsyncRequests
 {
 public:
@@ -25,9 +31,11 @@ public:
       EFB_POKE_Z,
       EFB_PEEK_COLOR,
       EFB_PEEK_Z,
+      EFB_PEEK_TILE,
       SWAP_EVENT,
       BBOX_READ,
       PERF_QUERY,
+      NUM_TYPES
     } type;
     u64 time;
 
@@ -47,6 +55,15 @@ public:
         u32* data;
       } efb_peek;
 
+      struct
+      {
+        u16 x;
+        u16 y;
+        bool depth;
+        u32* data;
+        u64* epoch;
+      } efb_peek_tile;
+
       struct
       {
         u32 xfbAddr;
@@ -55,10 +72,11 @@ public:
         u32 fbHeight;
       } swap_event;
 
+      // Reads all four coordinates, and the bounding box epoch that they belong to.
       struct
       {
-        int index;
         u16* data;
+        u64* epoch;
       } bbox;
 
       struct
@@ -67,32 +85,81 @@ public:
     };
   };
 
+  // Time from pushing an event to having handled it. Bucket 0 holds events handled within 1us,
+  // bucket n the ones that took [2^(n-1), 2^n) us. The last bucket also holds everything slower.
+  static constexpr size_t LATENCY_BUCKETS = 16;
+  using LatencyHistogram = std::array<u64, LATENCY_BUCKETS>;
+
   AsyncRequests();
 
   void PullEvents()
   {
-    if (!m_empty.IsSet())
+    if (m_queue.Size() != 0)
       PullEventsInternal();
   }
-  void PushEvent(const Event& event, bool blocking = false);
+  // CPU thread only, or another thread while the CPU thread is paused: the ring has a single
+  // producer. A blocking push returns once the GPU thread has handled the events.
+  void PushEvent(const Event& event, bool blocking = false) { PushEvents(&event, 1, blocking); }
+  void PushEvents(const Event* events, size_t count, bool blocking = false);
   void SetEnable(bool enable);
   void SetPassthrough(bool enable);
 
+  // Reads a bounding box coordinate. The GPU thread reads all four at once, and the CPU thread
+  // keeps them until the GPU thread may have changed the bounding box.
+  u16 ReadBoundingBox(int index);
+  // GPU thread. Called after draws and writes to the bounding box.
+  void InvalidateBoundingBox() { m_bbox_epoch.fetch_add(1, std::memory_order_relaxed); }
+  // Forgets the bounding box that the CPU thread kept, for when the emulated state is replaced.
+  void ResetBoundingBox() { m_bbox_values_epoch = 0; }
+
+  LatencyHistogram GetLatencyHistogram(Event::Type type) const;
+  std::string GetStatisticsString() const;
+  void ResetStatistics();
+
   static AsyncRequests* GetInstance() { return &s_singleton; }
 private:
+  struct QueuedEvent
+  {
+    Event event;
+    u64 push_time_us;
+  };
+
+  // Large enough for a full batch of EFB pokes.
+  static constexpr size_t QUEUE_SIZE = 2048;
+
   void PullEventsInternal();
+  // Handles the first event, or the run of EFB pokes of the same type that it starts, and returns
+  // the number of events that were handled.
+  size_t HandleEvents(const QueuedEvent* events, size_t count);
   void HandleEvent(const Event& e);
+  void RecordLatency(Event::Type type, u64 push_time_us, u64 now_us);
+  void WaitForEvents(u64 count);
 
   static AsyncRequests s_singleton;
 
-  Common::Flag m_empty;
-  std::queue<Event> m_queue;
+  Common::SPSCRingBuffer<QueuedEvent, QUEUE_SIZE> m_queue;
+  // Events pushed by the CPU thread and handled by the GPU thread since the start.
+  u64 m_pushed = 0;
+  std::atomic<u64> m_handled{0};
+
+  // Only used when the CPU thread waits for the GPU thread.
   std::mutex m_mutex;
   std::condition_variable m_cond;
+  std::atomic<bool> m_wake_me_up_again{false};
 
-  bool m_wake_me_up_again;
-  bool m_enable;
-  bool m_passthrough;
+  std::atomic<bool> m_enable;
+  std::atomic<bool> m_passthrough;
 
   std::vector<EfbPokeData> m_merged_efb_pokes;
+  std::vector<QueuedEvent> m_push_buffer;
+
+  std::atomic<u64> m_bbox_epoch{1};
+  // The CPU thread's copy of the bounding box, valid while its epoch is current.
+  std::array<u16, 4> m_bbox_values{};
+  u64 m_bbox_values_epoch = 0;
+
+  std::array<std::array<std::atomic<u64>, LATENCY_BUCKETS>, Event::NUM_TYPES> m_latency{};
+  std::atomic<u64> m_merged_requests{0};
+  // Pushes that had to wait for the GPU thread to make room in the ring.
+  std::atomic<u64> m_full_queue_waits{0};
 };
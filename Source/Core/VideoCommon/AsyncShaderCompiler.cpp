@@ -3,9 +3,11 @@
 // Refer to the license.txt file included.
 
 #include "VideoCommon/AsyncShaderCompiler.h"
+#include <algorithm>
 #include <thread>
 #include "Common/Assert.h"
 #include "Common/Logging/Log.h"
+#include "Common/Timer.h"
 
 namespace VideoCommon
 {
@@ -30,8 +32,19 @@ void AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority)
   }
   else
   {
-    std::lock_guard<std::mutex> guard(m_pending_work_lock);
-    m_pending_work.emplace(priority, std::move(item));
+    const size_t lane = std::min<u32>(priority, NUM_PRIORITY_LANES - 1);
+    WorkerQueue& queue = *m_queues[m_next_queue];
+    m_next_queue = (m_next_queue + 1) % m_queues.size();
+    {
+      std::lock_guard<std::mutex> guard(queue.lock);
+      queue.lanes[lane].push_back({std::move(item), Common::Timer::GetTimeUs()});
+      m_pending_counts[lane]++;
+    }
+
+    // Taking the lock makes sure that a worker which is about to sleep sees the new item.
+    {
+      std::lock_guard<std::mutex> guard(m_wake_lock);
+    }
     m_worker_thread_wake.notify_one();
   }
 }
@@ -53,8 +66,8 @@ void AsyncShaderCompiler::RetrieveWorkItems()
 
 bool AsyncShaderCompiler::HasPendingWork()
 {
-  std::lock_guard<std::mutex> guard(m_pending_work_lock);
-  return !m_pending_work.empty() || m_busy_workers.load() != 0;
+  // Workers are marked busy before they take an item, so an item is always counted in one of them.
+  return GetPendingCount() != 0 || m_busy_workers.load() != 0;
 }
 
 bool AsyncShaderCompiler::HasCompletedWork()
@@ -63,6 +76,38 @@ bool AsyncShaderCompiler::HasCompletedWork()
   return !m_completed_work.empty();
 }
 
+void AsyncShaderCompiler::CancelPendingWork()
+{
+  for (auto& queue : m_queues)
+  {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    for (size_t lane = 0; lane < NUM_PRIORITY_LANES; lane++)
+    {
+      const size_t count = queue->lanes[lane].size();
+      queue->lanes[lane].clear();
+      m_pending_counts[lane] -= count;
+      m_cancelled_count += count;
+    }
+  }
+}
+
+AsyncShaderCompiler::Statistics AsyncShaderCompiler::GetStatistics()
+{
+  Statistics statistics;
+  statistics.pending = GetPendingCount();
+  statistics.completed = m_completed_count.load();
+  statistics.cancelled = m_cancelled_count.load();
+  statistics.stolen = m_stolen_count.load();
+
+  const u64 latency_count = m_latency_count.exchange(0);
+  const u64 latency_sum_us = m_latency_sum_us.exchange(0);
+  const u64 latency_max_us = m_latency_max_us.exchange(0);
+  statistics.average_latency_ms =
+      latency_count != 0 ? latency_sum_us / 1000.0 / latency_count : 0.0;
+  statistics.max_latency_ms = latency_max_us / 1000.0;
+  return statistics;
+}
+
 void AsyncShaderCompiler::WaitUntilCompletion()
 {
   while (HasPendingWork())
@@ -89,23 +134,14 @@ void AsyncShaderCompiler::WaitUntilCompletion(
   // Grab the number of pending items. We use this to work out how many are left.
   size_t total_items = 0;
   {
-    // Safe to hold both locks here, since nowhere else does.
-    std::lock_guard<std::mutex> pending_guard(m_pending_work_lock);
     std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
-    total_items = m_completed_work.size() + m_pending_work.size() + m_busy_workers.load() + 1;
+    total_items = m_completed_work.size() + GetPendingCount() + m_busy_workers.load() + 1;
   }
 
   // Update progress while the compiles complete.
-  for (;;)
+  while (HasPendingWork())
   {
-    size_t remaining_items;
-    {
-      std::lock_guard<std::mutex> pending_guard(m_pending_work_lock);
-      if (m_pending_work.empty() && !m_busy_workers.load())
-        break;
-      remaining_items = m_pending_work.size();
-    }
-
+    const size_t remaining_items = std::min(GetPendingCount(), total_items);
     progress_callback(total_items - remaining_items, total_items);
     std::this_thread::sleep_for(CHECK_INTERVAL);
   }
@@ -116,6 +152,9 @@ bool AsyncShaderCompiler::StartWorkerThreads(u32 num_worker_threads)
   if (num_worker_threads == 0)
     return true;
 
+  if (!HasWorkerThreads())
+    ResizeQueues(num_worker_threads);
+
   for (u32 i = 0; i < num_worker_threads; i++)
   {
     void* thread_param = nullptr;
@@ -127,7 +166,8 @@ bool AsyncShaderCompiler::StartWorkerThreads(u32 num_worker_threads)
 
     m_worker_thread_start_result.store(false);
 
-    std::thread thr(&AsyncShaderCompiler::WorkerThreadEntryPoint, this, thread_param);
+    std::thread thr(&AsyncShaderCompiler::WorkerThreadEntryPoint, this, m_worker_threads.size(),
+                    thread_param);
     m_init_event.Wait();
 
     if (!m_worker_thread_start_result.load())
@@ -164,7 +204,7 @@ void AsyncShaderCompiler::StopWorkerThreads()
 
   // Signal worker threads to stop, and wake all of them.
   {
-    std::lock_guard<std::mutex> guard(m_pending_work_lock);
+    std::lock_guard<std::mutex> guard(m_wake_lock);
     m_exit_flag.Set();
     m_worker_thread_wake.notify_all();
   }
@@ -190,7 +230,7 @@ void AsyncShaderCompiler::WorkerThreadExit(void* param)
 {
 }
 
-void AsyncShaderCompiler::WorkerThreadEntryPoint(void* param)
+void AsyncShaderCompiler::WorkerThreadEntryPoint(size_t worker_index, void* param)
 {
   // Initialize worker thread with backend-specific method.
   if (!WorkerThreadInitWorkerThread(param))
@@ -204,34 +244,102 @@ void AsyncShaderCompiler::WorkerThreadEntryPoint(void* param)
   m_worker_thread_start_result.store(true);
   m_init_event.Set();
 
-  WorkerThreadRun();
+  WorkerThreadRun(worker_index);
 
   WorkerThreadExit(param);
 }
 
-void AsyncShaderCompiler::WorkerThreadRun()
+void AsyncShaderCompiler::WorkerThreadRun(size_t worker_index)
 {
-  std::unique_lock<std::mutex> pending_lock(m_pending_work_lock);
   while (!m_exit_flag.IsSet())
   {
-    m_worker_thread_wake.wait(pending_lock);
-
-    while (!m_pending_work.empty() && !m_exit_flag.IsSet())
+    m_busy_workers++;
+    QueuedWorkItem work_item;
+    if (TakeWorkItem(worker_index, &work_item))
     {
-      m_busy_workers++;
-      auto iter = m_pending_work.begin();
-      WorkItemPtr item(std::move(iter->second));
-      m_pending_work.erase(iter);
-      pending_lock.unlock();
-
-      if (item->Compile())
+      RecordLatency(Common::Timer::GetTimeUs() - work_item.queue_time_us);
+      if (work_item.item->Compile())
       {
         std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
-        m_completed_work.push_back(std::move(item));
+        m_completed_work.push_back(std::move(work_item.item));
       }
-
-      pending_lock.lock();
+      m_completed_count++;
       m_busy_workers--;
+      continue;
+    }
+    m_busy_workers--;
+
+    std::unique_lock<std::mutex> wake_lock(m_wake_lock);
+    m_worker_thread_wake.wait(wake_lock,
+                              [this] { return m_exit_flag.IsSet() || GetPendingCount() != 0; });
+  }
+}
+
+bool AsyncShaderCompiler::TakeWorkItem(size_t worker_index, QueuedWorkItem* work_item)
+{
+  const size_t num_queues = m_queues.size();
+  for (size_t lane = 0; lane < NUM_PRIORITY_LANES; lane++)
+  {
+    if (m_pending_counts[lane].load() == 0)
+      continue;
+
+    // Our own queue first, then steal from the others.
+    for (size_t i = 0; i < num_queues; i++)
+    {
+      WorkerQueue& queue = *m_queues[(worker_index + i) % num_queues];
+      std::lock_guard<std::mutex> guard(queue.lock);
+      std::deque<QueuedWorkItem>& items = queue.lanes[lane];
+      if (items.empty())
+        continue;
+
+      *work_item = std::move(items.front());
+      items.pop_front();
+      m_pending_counts[lane]--;
+      if (i != 0)
+        m_stolen_count++;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void AsyncShaderCompiler::RecordLatency(u64 latency_us)
+{
+  m_latency_count++;
+  m_latency_sum_us += latency_us;
+  u64 max_us = m_latency_max_us.load();
+  while (latency_us > max_us && !m_latency_max_us.compare_exchange_weak(max_us, latency_us))
+  {
+  }
+}
+
+size_t AsyncShaderCompiler::GetPendingCount() const
+{
+  size_t count = 0;
+  for (const auto& lane_count : m_pending_counts)
+    count += lane_count.load();
+  return count;
+}
+
+void AsyncShaderCompiler::ResizeQueues(size_t num_queues)
+{
+  // Hand the items that were queued for the previous workers out to the new ones.
+  std::vector<std::unique_ptr<WorkerQueue>> old_queues;
+  old_queues.swap(m_queues);
+  for (size_t i = 0; i < num_queues; i++)
+    m_queues.push_back(std::make_unique<WorkerQueue>());
+
+  m_next_queue = 0;
+  for (size_t lane = 0; lane < NUM_PRIORITY_LANES; lane++)
+  {
+    for (auto& old_queue : old_queues)
+    {
+      for (QueuedWorkItem& work_item : old_queue->lanes[lane])
+      {
+        m_queues[m_next_queue]->lanes[lane].push_back(std::move(work_item));
+        m_next_queue = (m_next_queue + 1) % num_queues;
+      }
     }
   }
 }
@@ -4,11 +4,11 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <functional>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -21,9 +21,39 @@
 
 namespace VideoCommon
 {
+// Work items are queued in priority lanes. Every worker thread has its own queue in each lane, and
+// items are handed out to the queues in turn. A worker takes the oldest item of the most urgent
+// lane from its own queue, or steals it from the queue of another worker when its own is empty,
+// so the workers don't all contend for a single lock while the shader cache is precompiled.
 class AsyncShaderCompiler
 {
 public:
+  // Items in a lower lane are always started before the items in higher lanes, and the items in a
+  // lane are started in about the order they were queued.
+  enum PriorityLane : u32
+  {
+    // Shaders that the game is waiting for.
+    PRIORITY_LANE_ONDEMAND,
+    // Ubershaders, which replace the shaders that the game is waiting for.
+    PRIORITY_LANE_UBERSHADER,
+    // Shaders from the shader cache, which the game may never use.
+    PRIORITY_LANE_PRECOMPILE,
+    NUM_PRIORITY_LANES
+  };
+
+  struct Statistics
+  {
+    // Items that have been queued but not started yet, in all lanes.
+    size_t pending;
+    u64 completed;
+    u64 cancelled;
+    // Items that a worker took from the queue of another worker.
+    u64 stolen;
+    // Time that the items started since the last call waited in the queue.
+    double average_latency_ms;
+    double max_latency_ms;
+  };
+
   class WorkItem
   {
   public:
@@ -43,13 +73,20 @@ public:
     return std::make_unique<T>(std::forward<Params>(params)...);
   }
 
-  // Queues a new work item to the compiler threads. The lower the priority, the sooner
-  // this work item will be compiled, relative to the other work items.
+  // Queues a new work item to the compiler threads, in the lane given by the priority.
+  // Priorities past the last lane are queued in the last lane.
   void QueueWorkItem(WorkItemPtr item, u32 priority);
   void RetrieveWorkItems();
   bool HasPendingWork();
   bool HasCompletedWork();
 
+  // Drops the work items that no worker has started yet, without compiling or retrieving them.
+  // Items that are being compiled still complete.
+  void CancelPendingWork();
+
+  // The latency figures cover the items that were started since the previous call.
+  Statistics GetStatistics();
+
   // Simpler version without progress updates.
   void WaitUntilCompletion();
 
@@ -68,8 +105,24 @@ protected:
   virtual void WorkerThreadExit(void* param);
 
 private:
-  void WorkerThreadEntryPoint(void* param);
-  void WorkerThreadRun();
+  struct QueuedWorkItem
+  {
+    WorkItemPtr item;
+    u64 queue_time_us;
+  };
+
+  struct alignas(64) WorkerQueue
+  {
+    std::mutex lock;
+    std::array<std::deque<QueuedWorkItem>, NUM_PRIORITY_LANES> lanes;
+  };
+
+  void WorkerThreadEntryPoint(size_t worker_index, void* param);
+  void WorkerThreadRun(size_t worker_index);
+  bool TakeWorkItem(size_t worker_index, QueuedWorkItem* work_item);
+  void RecordLatency(u64 latency_us);
+  size_t GetPendingCount() const;
+  void ResizeQueues(size_t num_queues);
 
   Common::Flag m_exit_flag;
   Common::Event m_init_event;
@@ -77,13 +130,23 @@ private:
   std::vector<std::thread> m_worker_threads;
   std::atomic_bool m_worker_thread_start_result{false};
 
-  // A multimap is used to store the work items. We can't use a priority_queue here, because
-  // there's no way to obtain a non-const reference, which we need for the unique_ptr.
-  std::multimap<u32, WorkItemPtr> m_pending_work;
-  std::mutex m_pending_work_lock;
-  std::condition_variable m_worker_thread_wake;
+  // One queue per worker thread. Only resized while there are no worker threads.
+  std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+  size_t m_next_queue = 0;
+  std::array<std::atomic_size_t, NUM_PRIORITY_LANES> m_pending_counts{};
   std::atomic_size_t m_busy_workers{0};
 
+  // Only used to put idle workers to sleep, the queues have their own locks.
+  std::mutex m_wake_lock;
+  std::condition_variable m_worker_thread_wake;
+
+  std::atomic<u64> m_completed_count{0};
+  std::atomic<u64> m_cancelled_count{0};
+  std::atomic<u64> m_stolen_count{0};
+  std::atomic<u64> m_latency_count{0};
+  std::atomic<u64> m_latency_sum_us{0};
+  std::atomic<u64> m_latency_max_us{0};
+
   std::deque<WorkItemPtr> m_completed_work;
   std::mutex m_completed_work_lock;
 };
@@ -7,6 +7,7 @@
 
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/EFBAccessCache.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/RenderState.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -183,6 +184,7 @@ void ClearScreen(const EFBRectangle& rc)
       z = Z24ToZ16ToZ24(z);
     }
     g_renderer->ClearScreen(rc, colorEnable, alphaEnable, zEnable, color, z);
+    EFBAccessCache::Invalidate();
   }
 }
 
@@ -190,6 +192,9 @@ void OnPixelFormatChange()
 {
   int convtype = -1;
 
+  // Peeks convert the EFB to the current format, even when the data isn't reinterpreted.
+  EFBAccessCache::Invalidate();
+
   // TODO : Check for Z compression format change
   // When using 16bit Z, the game may enable a special compression format which we need to handle
   // If we don't, Z values will be completely screwed up, currently only Star Wars:RS2 uses that.
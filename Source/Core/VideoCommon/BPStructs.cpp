@@ -18,6 +18,7 @@
 #include "Core/HW/Memmap.h"
 #include "Core/HW/VideoInterface.h"
 
+#include "VideoCommon/AsyncRequests.h"
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/BoundingBox.h"
@@ -416,6 +417,7 @@ static void BPWritten(const BPCmd& bp)
     {
       g_renderer->BBoxWrite(offset, bp.newvalue & 0x3ff);
       g_renderer->BBoxWrite(offset + 1, bp.newvalue >> 10);
+      AsyncRequests::GetInstance()->InvalidateBoundingBox();
     }
   }
     return;
@@ -17,6 +17,7 @@
 #include "Core/HW/MMIO.h"
 #include "Core/HW/ProcessorInterface.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/EFBAccessCache.h"
 #include "VideoCommon/Fifo.h"
 
 namespace CommandProcessor
@@ -293,6 +294,9 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 
 void GatherPipeBursted()
 {
+  // The pokes that were held back have to reach the EFB before the commands that follow them.
+  EFBAccessCache::FlushPokes();
+
   SetCPStatusFromCPU();
 
   // if we aren't linked, we don't care about gather pipe data
@@ -0,0 +1,247 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/DisplayListCache.h"
+
+#include <unordered_map>
+#include <vector>
+
+#include "Common/Hash.h"
+#include "Common/Swap.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/PipelineProfiler.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace DisplayListCache
+{
+bool g_recording = false;
+
+namespace
+{
+enum class CommandType : u8
+{
+  LoadBP,
+  LoadCP,
+  LoadXF,
+  LoadIndexedXF,
+  Draw,
+};
+
+// NOPs and the other commands without an effect aren't kept, only their cycles are.
+struct Command
+{
+  CommandType type;
+  // The CP register, the array of an indexed XF load, or the command byte of a draw.
+  u8 sub_cmd;
+  // The number of words of an XF load, or of vertices of a draw.
+  u16 count;
+  // The BP or CP value, the XF address, or the indexed XF load.
+  u32 value;
+  // Where the XF data or the vertices start in the list, and the size of the vertices.
+  u32 offset;
+  u32 size;
+  // Cycles that the list took up to the start and the end of the command.
+  u32 start_cycles;
+  u32 end_cycles;
+};
+
+struct DisplayList
+{
+  u64 hash;
+  u32 cycles;
+  // False for lists with unknown commands or that end in the middle of a command, which are
+  // decoded on every call.
+  bool replayable;
+  std::vector<Command> commands;
+};
+
+// All the lists are dropped when there are more than this, which only happens in games that build
+// new lists all the time.
+constexpr size_t MAX_DISPLAY_LISTS = 4096;
+
+std::unordered_map<u64, DisplayList> s_lists;
+
+DisplayList* s_recording_list;
+const u8* s_recording_start;
+u32 s_recorded_cycles;
+
+u32 Replay(const DisplayList& list, u8* data, u32 size)
+{
+  PipelineProfiler::ScopedTimer profiler_timer(PipelineProfiler::Section::OpcodeDecoding);
+  u8* const end = data + size;
+  for (const Command& command : list.commands)
+  {
+    switch (command.type)
+    {
+    case CommandType::LoadBP:
+      LoadBPReg(command.value);
+      INCSTAT(stats.thisFrame.numBPLoads);
+      break;
+
+    case CommandType::LoadCP:
+      LoadCPReg(command.sub_cmd, command.value);
+      INCSTAT(stats.thisFrame.numCPLoads);
+      break;
+
+    case CommandType::LoadXF:
+      LoadXFReg(command.count, command.value, DataReader(data + command.offset, end));
+      INCSTAT(stats.thisFrame.numXFLoads);
+      break;
+
+    case CommandType::LoadIndexedXF:
+      LoadIndexedXF(command.value, command.sub_cmd);
+      break;
+
+    case CommandType::Draw:
+    {
+      const int bytes = VertexLoaderManager::RunVertices(
+          command.sub_cmd & OpcodeDecoder::GX_VAT_MASK,
+          (command.sub_cmd & OpcodeDecoder::GX_PRIMITIVE_MASK) >> OpcodeDecoder::GX_PRIMITIVE_SHIFT,
+          command.count, DataReader(data + command.offset, end), false);
+      if (bytes == static_cast<int>(command.size))
+        break;
+
+      // The vertex format isn't the one that the list was decoded with, so the commands after
+      // the vertices are somewhere else.
+      INCSTAT(stats.numDisplayListCacheFallbacks);
+      if (bytes < 0)
+        return command.start_cycles;
+
+      u32 cycles = 0;
+      OpcodeDecoder::Run(DataReader(data + command.offset + bytes, end), &cycles, true);
+      return command.end_cycles + cycles;
+    }
+    }
+  }
+
+  return list.cycles;
+}
+}  // namespace
+
+void Init()
+{
+  Clear();
+  SETSTAT(stats.numDisplayListCacheHits, 0);
+  SETSTAT(stats.numDisplayListCacheMisses, 0);
+  SETSTAT(stats.numDisplayListCacheFallbacks, 0);
+}
+
+void Clear()
+{
+  s_lists.clear();
+}
+
+u32 Run(u32 address, u8* data, u32 size)
+{
+  const u64 key = static_cast<u64>(address) << 32 | size;
+  const u64 hash = GetHash64(data, size, 0);
+  auto iter = s_lists.find(key);
+  if (iter != s_lists.end() && iter->second.hash == hash && iter->second.replayable)
+  {
+    INCSTAT(stats.numDisplayListCacheHits);
+    return Replay(iter->second, data, size);
+  }
+
+  INCSTAT(stats.numDisplayListCacheMisses);
+  u32 cycles = 0;
+  if (iter != s_lists.end() && iter->second.hash == hash)
+  {
+    OpcodeDecoder::Run(DataReader(data, data + size), &cycles, true);
+    return cycles;
+  }
+
+  if (iter == s_lists.end())
+  {
+    if (s_lists.size() >= MAX_DISPLAY_LISTS)
+      s_lists.clear();
+    iter = s_lists.emplace(key, DisplayList()).first;
+  }
+
+  DisplayList& list = iter->second;
+  list.hash = hash;
+  list.replayable = true;
+  list.commands.clear();
+
+  s_recording_list = &list;
+  s_recording_start = data;
+  s_recorded_cycles = 0;
+  g_recording = true;
+  const u8* const stop = OpcodeDecoder::Run(DataReader(data, data + size), &cycles, true);
+  g_recording = false;
+
+  list.cycles = cycles;
+  if (stop != data + size)
+    list.replayable = false;
+  return cycles;
+}
+
+void RecordCommand(const u8* start, const u8* end, u32 cycles)
+{
+  const u8 cmd_byte = start[0];
+  Command command = {};
+  command.start_cycles = s_recorded_cycles;
+  command.end_cycles = cycles;
+  s_recorded_cycles = cycles;
+
+  switch (cmd_byte)
+  {
+  case OpcodeDecoder::GX_NOP:
+  case OpcodeDecoder::GX_UNKNOWN_RESET:
+  case OpcodeDecoder::GX_CMD_CALL_DL:
+  case OpcodeDecoder::GX_CMD_UNKNOWN_METRICS:
+  case OpcodeDecoder::GX_CMD_INVL_VC:
+    return;
+
+  case OpcodeDecoder::GX_LOAD_BP_REG:
+    command.type = CommandType::LoadBP;
+    command.value = Common::swap32(start + 1);
+    break;
+
+  case OpcodeDecoder::GX_LOAD_CP_REG:
+    command.type = CommandType::LoadCP;
+    command.sub_cmd = start[1];
+    command.value = Common::swap32(start + 2);
+    break;
+
+  case OpcodeDecoder::GX_LOAD_XF_REG:
+  {
+    const u32 cmd2 = Common::swap32(start + 1);
+    command.type = CommandType::LoadXF;
+    command.count = ((cmd2 >> 16) & 15) + 1;
+    command.value = cmd2 & 0xFFFF;
+    command.offset = static_cast<u32>(start + 5 - s_recording_start);
+    break;
+  }
+
+  case OpcodeDecoder::GX_LOAD_INDX_A:
+  case OpcodeDecoder::GX_LOAD_INDX_B:
+  case OpcodeDecoder::GX_LOAD_INDX_C:
+  case OpcodeDecoder::GX_LOAD_INDX_D:
+    command.type = CommandType::LoadIndexedXF;
+    command.sub_cmd = 0xC + ((cmd_byte - OpcodeDecoder::GX_LOAD_INDX_A) >> 3);
+    command.value = Common::swap32(start + 1);
+    break;
+
+  default:
+    if ((cmd_byte & 0xC0) != 0x80)
+    {
+      s_recording_list->replayable = false;
+      return;
+    }
+    command.type = CommandType::Draw;
+    command.sub_cmd = cmd_byte;
+    command.count = Common::swap16(start + 1);
+    command.offset = static_cast<u32>(start + 3 - s_recording_start);
+    command.size = static_cast<u32>(end - (start + 3));
+    break;
+  }
+
+  s_recording_list->commands.push_back(command);
+}
+}  // namespace DisplayListCache
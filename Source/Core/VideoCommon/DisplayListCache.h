@@ -0,0 +1,32 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+// Keeps the commands of display lists that were called before, keyed by their address and size,
+// so that a list that is called again is replayed without parsing it. The contents of the list are
+// hashed on every call, which catches the CPU writing to it since it was decoded.
+//
+// The size of the vertices depends on the vertex format at the time of the call, so every draw
+// checks that it used as many bytes as when the list was decoded, and the rest of the list is
+// decoded again if it didn't.
+namespace DisplayListCache
+{
+// Set while a list is decoded, for OpcodeDecoder::Run() to pass every command to RecordCommand().
+extern bool g_recording;
+
+void Init();
+// Forgets every list, for when the emulated state is replaced.
+void Clear();
+
+// Runs the display list at the given address, whose contents are at data, and returns the number
+// of cycles that it took.
+u32 Run(u32 address, u8* data, u32 size);
+
+// start and end delimit the command in the list, and cycles is the number of cycles that the list
+// took up to the end of the command.
+void RecordCommand(const u8* start, const u8* end, u32 cycles);
+}  // namespace DisplayListCache
@@ -0,0 +1,172 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/EFBAccessCache.h"
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "VideoCommon/AsyncRequests.h"
+#include "VideoCommon/PixelEngine.h"
+#include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VideoBackendBase.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace EFBAccessCache
+{
+namespace
+{
+constexpr u32 TILES_X = EFB_WIDTH / TILE_SIZE;
+constexpr u32 TILES_Y = EFB_HEIGHT / TILE_SIZE;
+static_assert(TILES_X * TILE_SIZE == EFB_WIDTH && TILES_Y * TILE_SIZE == EFB_HEIGHT,
+              "the tiles must cover the EFB exactly");
+
+// Games that draw whole frames with pokes send them in batches of this size.
+constexpr size_t MAX_HELD_POKES = 1024;
+
+struct Tile
+{
+  // The epoch that the tile was read in, or 0 if it is out of date.
+  u64 epoch = 0;
+  // The backends apply the alpha read mode to the colors they return. The CPU writes the mode
+  // directly, so it is checked on every peek instead of invalidating the tiles.
+  u16 alpha_read_mode = 0;
+  std::array<u32, TILE_SIZE * TILE_SIZE> values;
+};
+
+// Incremented by the GPU thread whenever the EFB may have changed. A relaxed load is enough on the
+// CPU thread: a peek that races with a draw could see the old contents without the cache too.
+std::atomic<u64> s_epoch{1};
+
+// Color and depth tiles, allocated by the first peek. Only the CPU thread uses them, apart from
+// the GPU thread reading a tile while the CPU thread waits for it.
+std::vector<Tile> s_tiles[2];
+std::vector<AsyncRequests::Event> s_held_pokes;
+
+// The peek as it was done before the cache, for backends that read the EFB one pixel at a time.
+u32 PeekPixel(EFBAccessType type, u32 x, u32 y)
+{
+  AsyncRequests::Event e;
+  u32 result;
+  e.type = type == EFBAccessType::PeekColor ? AsyncRequests::Event::EFB_PEEK_COLOR :
+                                              AsyncRequests::Event::EFB_PEEK_Z;
+  e.time = 0;
+  e.efb_peek.x = x;
+  e.efb_peek.y = y;
+  e.efb_peek.data = &result;
+  AsyncRequests::GetInstance()->PushEvent(e, true);
+  return result;
+}
+}  // namespace
+
+u32 Peek(EFBAccessType type, u32 x, u32 y)
+{
+  if (!g_ActiveConfig.backend_info.bSupportsEFBPeekCache)
+  {
+    FlushPokes();
+    return PeekPixel(type, x, y);
+  }
+
+  const bool depth = type == EFBAccessType::PeekZ;
+  std::vector<Tile>& tiles = s_tiles[depth];
+  if (tiles.empty())
+    tiles.resize(TILES_X * TILES_Y);
+
+  Tile& tile = tiles[(y / TILE_SIZE) * TILES_X + x / TILE_SIZE];
+  const u16 alpha_read_mode = depth ? 0 : PixelEngine::GetAlphaReadMode().Hex;
+  if (tile.epoch == s_epoch.load(std::memory_order_relaxed) &&
+      tile.alpha_read_mode == alpha_read_mode)
+  {
+    INCSTAT(stats.numEFBPeekCacheHits);
+  }
+  else
+  {
+    INCSTAT(stats.numEFBPeekCacheMisses);
+
+    // Poking a pixel marks its tile as out of date, so the pokes only matter when reading a tile.
+    FlushPokes();
+    tile.alpha_read_mode = alpha_read_mode;
+    AsyncRequests::Event e;
+    e.type = AsyncRequests::Event::EFB_PEEK_TILE;
+    e.time = 0;
+    e.efb_peek_tile.x = x - x % TILE_SIZE;
+    e.efb_peek_tile.y = y - y % TILE_SIZE;
+    e.efb_peek_tile.depth = depth;
+    e.efb_peek_tile.data = tile.values.data();
+    e.efb_peek_tile.epoch = &tile.epoch;
+    AsyncRequests::GetInstance()->PushEvent(e, true);
+  }
+
+  return tile.values[(y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE];
+}
+
+void Poke(EFBAccessType type, u32 x, u32 y, u32 data)
+{
+  const bool depth = type == EFBAccessType::PokeZ;
+  // The tile is out of date as soon as the poke reaches the EFB.
+  std::vector<Tile>& tiles = s_tiles[depth];
+  if (!tiles.empty())
+    tiles[(y / TILE_SIZE) * TILES_X + x / TILE_SIZE].epoch = 0;
+
+  AsyncRequests::Event e;
+  e.type = depth ? AsyncRequests::Event::EFB_POKE_Z : AsyncRequests::Event::EFB_POKE_COLOR;
+  e.time = 0;
+  e.efb_poke.data = data;
+  e.efb_poke.x = x;
+  e.efb_poke.y = y;
+  s_held_pokes.push_back(e);
+  INCSTAT(stats.numEFBPokes);
+
+  if (s_held_pokes.size() >= MAX_HELD_POKES)
+    FlushPokes();
+}
+
+void FlushPokes()
+{
+  if (s_held_pokes.empty())
+    return;
+
+  // Consecutive pokes are merged into one PokeEFB() call.
+  AsyncRequests::GetInstance()->PushEvents(s_held_pokes.data(), s_held_pokes.size(), false);
+  s_held_pokes.clear();
+  INCSTAT(stats.numEFBPokeFlushes);
+}
+
+void Init()
+{
+  Reset();
+  SETSTAT(stats.numEFBPeekCacheHits, 0);
+  SETSTAT(stats.numEFBPeekCacheMisses, 0);
+  SETSTAT(stats.numEFBPokes, 0);
+  SETSTAT(stats.numEFBPokeFlushes, 0);
+}
+
+void Reset()
+{
+  s_tiles[0].clear();
+  s_tiles[1].clear();
+  s_held_pokes.clear();
+}
+
+void Invalidate()
+{
+  s_epoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ReadTile(bool depth, u32 x, u32 y, u32* values, u64* epoch)
+{
+  // The backends that support the cache read back a whole region on the first peek in it, so the
+  // other pixels of the tile are cheap.
+  const EFBAccessType type = depth ? EFBAccessType::PeekZ : EFBAccessType::PeekColor;
+  for (u32 tile_y = y; tile_y < y + TILE_SIZE; tile_y++)
+  {
+    for (u32 tile_x = x; tile_x < x + TILE_SIZE; tile_x++)
+      *values++ = g_renderer->AccessEFB(type, tile_x, tile_y, 0);
+  }
+  *epoch = s_epoch.load(std::memory_order_relaxed);
+}
+}  // namespace EFBAccessCache
@@ -0,0 +1,34 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+enum class EFBAccessType;
+
+// Answers EFB peeks on the CPU thread from tiles of the EFB that were read back since it last
+// changed, so that only the first peek of a tile waits for the GPU thread. EFB pokes are held back
+// and sent to the GPU thread together.
+namespace EFBAccessCache
+{
+constexpr u32 TILE_SIZE = 16;
+
+// CPU thread.
+u32 Peek(EFBAccessType type, u32 x, u32 y);
+void Poke(EFBAccessType type, u32 x, u32 y, u32 data);
+// Sends the pokes that were held back to the GPU thread. Called before anything that the pokes
+// have to arrive ahead of, like the next commands in the FIFO.
+void FlushPokes();
+
+void Init();
+// Forgets every tile and drops the held pokes, for when the emulated state is replaced.
+void Reset();
+
+// GPU thread.
+// Marks every tile as out of date. Called whenever the contents of the EFB may have changed.
+void Invalidate();
+// Reads a tile for Peek(), and the epoch that it belongs to.
+void ReadTile(bool depth, u32 x, u32 y, u32* values, u64* epoch);
+}  // namespace EFBAccessCache
@@ -15,6 +15,7 @@
 #include "Common/FPURoundMode.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/Trace.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -71,6 +72,8 @@ static u8* s_video_buffer_pp_read_ptr;
 static std::atomic<int> s_sync_ticks;
 static bool s_syncing_suspended;
 static Common::Event s_sync_wakeup_event;
+// Flow id of the last wakeup, so that the trace timeline can link it to the CPU thread's wait.
+static std::atomic<u64> s_sync_wakeup_trace_id;
 
 void DoState(PointerWrap& p)
 {
@@ -161,7 +164,10 @@ void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
 {
   if (s_use_deterministic_gpu_thread)
   {
-    s_gpu_mainloop.Wait();
+    {
+      Common::Trace::ScopedSlice trace_slice("SyncGPU wait");
+      s_gpu_mainloop.Wait();
+    }
     if (!s_gpu_mainloop.IsRunning())
       return;
 
@@ -288,6 +294,19 @@ void ResetVideoBuffer()
   s_fifo_aux_read_ptr = s_fifo_aux_data;
 }
 
+// Wakes up the CPU thread waiting in WaitForGpuThread.
+static void WakeupSyncGPU()
+{
+  if (Common::Trace::IsEnabled())
+  {
+    const u64 trace_id = Common::Trace::NewFlowId();
+    Common::Trace::FlowStart("SyncGPU wakeup", trace_id);
+    s_sync_wakeup_trace_id.store(trace_id);
+  }
+
+  s_sync_wakeup_event.Set();
+}
+
 // Description: Main FIFO update loop
 // Purpose: Keep the Core HW updated about the CPU-GPU distance
 void RunGpuLoop()
@@ -303,6 +322,8 @@ void RunGpuLoop()
         if (!s_emu_running_state.IsSet())
           return;
 
+        Common::Trace::ScopedSlice trace_slice("GPU loop");
+
         if (s_use_deterministic_gpu_thread)
         {
           AsyncRequests::GetInstance()->PullEvents();
@@ -364,7 +385,7 @@ void RunGpuLoop()
               int old = s_sync_ticks.fetch_sub(cyclesExecuted);
               if (old >= param.iSyncGpuMaxDistance &&
                   old - (int)cyclesExecuted < param.iSyncGpuMaxDistance)
-                s_sync_wakeup_event.Set();
+                WakeupSyncGPU();
             }
 
             // This call is pretty important in DualCore mode and must be called in the FIFO Loop.
@@ -379,7 +400,7 @@ void RunGpuLoop()
           {
             int old = s_sync_ticks.exchange(0);
             if (old >= param.iSyncGpuMaxDistance)
-              s_sync_wakeup_event.Set();
+              WakeupSyncGPU();
           }
 
           // The fifo is empty and it's unlikely we will get any more work in the near future.
@@ -555,8 +576,15 @@ static int WaitForGpuThread(int ticks)
 
   // Wait for GPU
   if (now >= param.iSyncGpuMaxDistance)
+  {
+    Common::Trace::ScopedSlice trace_slice("SyncGPU wait");
     s_sync_wakeup_event.Wait();
 
+    const u64 trace_id = s_sync_wakeup_trace_id.exchange(0);
+    if (trace_id)
+      Common::Trace::FlowEnd("SyncGPU wakeup", trace_id);
+  }
+
   return GPU_TIME_SLOT_SIZE;
 }
 
@@ -24,10 +24,13 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/DisplayListCache.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/PipelineProfiler.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
 bool g_bRecordFifoData = false;
@@ -53,7 +56,11 @@ static u32 InterpretDisplayList(u32 address, u32 size)
     // temporarily swap dl and non-dl (small "hack" for the stats)
     Statistics::SwapDL();
 
-    Run(DataReader(startAddress, startAddress + size), &cycles, true);
+    // The FIFO recorder needs to see every command of the list.
+    if (g_ActiveConfig.bDisplayListCache && !g_bRecordFifoData)
+      cycles = DisplayListCache::Run(address, startAddress, size);
+    else
+      Run(DataReader(startAddress, startAddress + size), &cycles, true);
     INCSTAT(stats.thisFrame.numDListsCalled);
 
     // un-swap
@@ -83,6 +90,8 @@ void Init()
 template <bool is_preprocess>
 u8* Run(DataReader src, u32* cycles, bool in_display_list)
 {
+  PipelineProfiler::ScopedTimer profiler_timer(PipelineProfiler::Section::OpcodeDecoding,
+                                               !is_preprocess);
   u32 totalCycles = 0;
   u8* opcodeStart;
   while (true)
@@ -252,6 +261,9 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
       opcodeEnd = src.GetPointer();
       FifoRecorder::GetInstance().WriteGPCommand(opcodeStart, u32(opcodeEnd - opcodeStart));
     }
+
+    if (!is_preprocess && in_display_list && DisplayListCache::g_recording)
+      DisplayListCache::RecordCommand(opcodeStart, src.GetPointer(), totalCycles);
   }
 
 end:
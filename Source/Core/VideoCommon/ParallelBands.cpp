@@ -0,0 +1,128 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/ParallelBands.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Thread.h"
+
+namespace ParallelBands
+{
+namespace
+{
+class WorkerPool final
+{
+public:
+  ~WorkerPool()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_exit = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads)
+      thread.join();
+  }
+
+  size_t GetThreadCount()
+  {
+    std::call_once(m_start_flag, [this] {
+      const unsigned int cores = std::thread::hardware_concurrency();
+      for (unsigned int i = 1; i < std::min(cores, MAX_THREADS); i++)
+        m_threads.emplace_back(&WorkerPool::WorkerThread, this);
+    });
+    return m_threads.size() + 1;
+  }
+
+  bool Run(int num_bands, const std::function<void(int)>& run_band)
+  {
+    std::unique_lock<std::mutex> run_lock(m_run_lock, std::try_to_lock);
+    if (!run_lock.owns_lock())
+      return false;
+
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_run_band = &run_band;
+      m_num_bands = num_bands;
+      m_next_band = 0;
+      m_busy_workers = m_threads.size();
+      m_generation++;
+    }
+    m_wake.notify_all();
+
+    RunBands();
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_done.wait(lock, [this] { return m_busy_workers == 0; });
+    m_run_band = nullptr;
+    return true;
+  }
+
+private:
+  static constexpr unsigned int MAX_THREADS = 8;
+
+  void WorkerThread()
+  {
+    Common::SetCurrentThreadName("Texture worker");
+
+    u64 generation = 0;
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (;;)
+    {
+      m_wake.wait(lock, [&] { return m_exit || m_generation != generation; });
+      if (m_exit)
+        return;
+      generation = m_generation;
+
+      lock.unlock();
+      RunBands();
+      lock.lock();
+
+      if (--m_busy_workers == 0)
+        m_done.notify_one();
+    }
+  }
+
+  void RunBands()
+  {
+    for (int band = m_next_band++; band < m_num_bands; band = m_next_band++)
+      (*m_run_band)(band);
+  }
+
+  std::once_flag m_start_flag;
+  std::vector<std::thread> m_threads;
+  // Held by the thread whose bands the workers are running.
+  std::mutex m_run_lock;
+
+  std::mutex m_lock;
+  std::condition_variable m_wake;
+  std::condition_variable m_done;
+  const std::function<void(int)>* m_run_band = nullptr;
+  int m_num_bands = 0;
+  std::atomic<int> m_next_band{0};
+  size_t m_busy_workers = 0;
+  u64 m_generation = 0;
+  bool m_exit = false;
+};
+
+WorkerPool s_worker_pool;
+}  // namespace
+
+size_t GetThreadCount()
+{
+  return s_worker_pool.GetThreadCount();
+}
+
+bool Run(int num_bands, const std::function<void(int)>& run_band)
+{
+  return s_worker_pool.Run(num_bands, run_band);
+}
+}  // namespace ParallelBands
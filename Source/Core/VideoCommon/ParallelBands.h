@@ -0,0 +1,22 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+// Splits texture conversions into bands that are run on the calling thread and on a small pool of
+// worker threads. The texture decoder and the software texture encoder share the pool.
+namespace ParallelBands
+{
+// Number of threads that bands are spread over, including the calling thread. The worker threads
+// are started by the first call, and only if the host has more than one core.
+size_t GetThreadCount();
+
+// Calls run_band for every band from 0 to num_bands - 1, in no particular order, and returns once
+// all of them have returned. Returns false without running anything if another thread is using the
+// workers.
+bool Run(int num_bands, const std::function<void(int)>& run_band);
+}  // namespace ParallelBands
@@ -0,0 +1,255 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/PipelineProfiler.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <deque>
+#include <fstream>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace PipelineProfiler
+{
+bool g_enabled = false;
+
+// Bucket 0 holds calls shorter than 1us, bucket n calls of [2^(n-1), 2^n) us.
+// The last bucket also holds everything longer than that.
+constexpr size_t NUM_BUCKETS = 16;
+// Number of frames the overlay averages over.
+constexpr size_t HISTORY_FRAMES = 60;
+constexpr size_t NUM_SECTIONS = static_cast<size_t>(Section::NumSections);
+
+static const std::array<const char*, NUM_SECTIONS> s_section_names = {{
+    "OpcodeDecoding",
+    "VertexLoading",
+    "VertexFlush",
+    "ShaderLookup",
+    "TextureLookup",
+}};
+
+struct SectionStats
+{
+  u64 calls = 0;
+  u64 total_ns = 0;
+  u64 max_ns = 0;
+  std::array<u32, NUM_BUCKETS> buckets{};
+};
+
+struct Event
+{
+  Section section;
+  u64 start_ns;
+  u64 end_ns;
+};
+
+using FrameStats = std::array<SectionStats, NUM_SECTIONS>;
+
+static FrameStats s_current_frame;
+static FrameStats s_last_frame;
+static std::deque<std::array<u64, NUM_SECTIONS>> s_history;
+static std::vector<Event> s_events;
+static std::ofstream s_trace_file;
+static bool s_first_trace_event;
+static u64 s_epoch_ns;
+
+u64 GetTimeNs()
+{
+  return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch())
+                              .count());
+}
+
+static size_t GetBucket(u64 duration_ns)
+{
+  const u64 duration_us = duration_ns / 1000;
+  size_t bucket = 0;
+  while (bucket < NUM_BUCKETS - 1 && (u64(1) << bucket) <= duration_us)
+    ++bucket;
+  return bucket;
+}
+
+static double ToTraceTimestamp(u64 time_ns)
+{
+  return (time_ns - s_epoch_ns) / 1000.0;
+}
+
+static void WriteTraceEvent(const std::string& event)
+{
+  if (!s_first_trace_event)
+    s_trace_file << ",\n";
+  s_first_trace_event = false;
+  s_trace_file << event;
+}
+
+static void OpenTrace()
+{
+  const std::string path = File::GetUserPath(D_LOGS_IDX) + "video_pipeline_trace.json";
+  File::OpenFStream(s_trace_file, path, std::ios_base::out | std::ios_base::trunc);
+  s_trace_file << "{\"traceEvents\":[\n";
+  s_first_trace_event = true;
+  s_epoch_ns = GetTimeNs();
+
+  WriteTraceEvent("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+                  "\"args\":{\"name\":\"Video\"}}");
+}
+
+static void CloseTrace()
+{
+  if (!s_trace_file.is_open())
+    return;
+
+  s_trace_file << "\n]}\n";
+  s_trace_file.close();
+}
+
+static void FlushTrace(u64 frame_end_ns)
+{
+  if (!s_trace_file.is_open())
+    return;
+
+  for (const Event& event : s_events)
+  {
+    WriteTraceEvent(StringFromFormat(
+        "{\"name\":\"%s\",\"cat\":\"video\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,"
+        "\"tid\":1}",
+        s_section_names[static_cast<size_t>(event.section)], ToTraceTimestamp(event.start_ns),
+        (event.end_ns - event.start_ns) / 1000.0));
+  }
+
+  std::string args;
+  for (size_t i = 0; i < NUM_SECTIONS; ++i)
+  {
+    args += StringFromFormat("%s\"%s\":%.3f", i ? "," : "", s_section_names[i],
+                             s_current_frame[i].total_ns / 1000.0);
+  }
+  WriteTraceEvent(StringFromFormat("{\"name\":\"Frame time per section (us)\",\"ph\":\"C\","
+                                   "\"ts\":%.3f,\"pid\":1,\"args\":{%s}}",
+                                   ToTraceTimestamp(frame_end_ns), args.c_str()));
+  WriteTraceEvent(StringFromFormat("{\"name\":\"Frame\",\"cat\":\"video\",\"ph\":\"i\","
+                                   "\"s\":\"p\",\"ts\":%.3f,\"pid\":1,\"tid\":1}",
+                                   ToTraceTimestamp(frame_end_ns)));
+}
+
+static void UpdateEnabled()
+{
+  const bool enabled = g_ActiveConfig.bProfileVideoPipeline;
+  if (enabled == g_enabled)
+    return;
+
+  if (enabled)
+    OpenTrace();
+  else
+    CloseTrace();
+
+  s_current_frame = {};
+  s_last_frame = {};
+  s_history.clear();
+  s_events.clear();
+  g_enabled = enabled;
+}
+
+void Init()
+{
+  g_enabled = false;
+  UpdateEnabled();
+}
+
+void Shutdown()
+{
+  CloseTrace();
+  s_current_frame = {};
+  s_last_frame = {};
+  s_history.clear();
+  s_events.clear();
+  s_events.shrink_to_fit();
+  g_enabled = false;
+}
+
+void Record(Section section, u64 start_ns, u64 end_ns)
+{
+  // The profiler may have been disabled while the scope was open.
+  if (!g_enabled)
+    return;
+
+  const u64 duration_ns = end_ns - start_ns;
+  SectionStats& section_stats = s_current_frame[static_cast<size_t>(section)];
+  section_stats.calls++;
+  section_stats.total_ns += duration_ns;
+  section_stats.max_ns = std::max(section_stats.max_ns, duration_ns);
+  section_stats.buckets[GetBucket(duration_ns)]++;
+
+  if (s_trace_file.is_open())
+    s_events.push_back({section, start_ns, end_ns});
+}
+
+void FrameEnded()
+{
+  if (g_enabled)
+  {
+    FlushTrace(GetTimeNs());
+    s_events.clear();
+
+    std::array<u64, NUM_SECTIONS> totals;
+    for (size_t i = 0; i < NUM_SECTIONS; ++i)
+      totals[i] = s_current_frame[i].total_ns;
+    s_history.push_back(totals);
+    if (s_history.size() > HISTORY_FRAMES)
+      s_history.pop_front();
+
+    s_last_frame = s_current_frame;
+    s_current_frame = {};
+  }
+
+  UpdateEnabled();
+}
+
+std::string ToString()
+{
+  if (!g_enabled)
+    return "";
+
+  std::string str = StringFromFormat("%-15s %7s %9s %9s %9s  %s\n", "Section", "calls", "ms",
+                                     "avg ms", "max ms", "calls per duration (us)");
+  for (size_t i = 0; i < NUM_SECTIONS; ++i)
+  {
+    const SectionStats& section_stats = s_last_frame[i];
+
+    u64 history_total = 0;
+    u64 history_max = 0;
+    for (const auto& totals : s_history)
+    {
+      history_total += totals[i];
+      history_max = std::max(history_max, totals[i]);
+    }
+    const double history_avg = s_history.empty() ? 0.0 : double(history_total) / s_history.size();
+
+    std::string histogram;
+    for (size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket)
+    {
+      if (!section_stats.buckets[bucket])
+        continue;
+
+      if (bucket == NUM_BUCKETS - 1)
+        histogram += StringFromFormat(" >=%" PRIu64 ":%u", u64(1) << (bucket - 1),
+                                      section_stats.buckets[bucket]);
+      else
+        histogram +=
+            StringFromFormat(" <%" PRIu64 ":%u", u64(1) << bucket, section_stats.buckets[bucket]);
+    }
+
+    str += StringFromFormat("%-15s %7" PRIu64 " %9.3f %9.3f %9.3f %s\n", s_section_names[i],
+                            section_stats.calls, section_stats.total_ns / 1000000.0,
+                            history_avg / 1000000.0, history_max / 1000000.0, histogram.c_str());
+  }
+  return str;
+}
+}  // namespace PipelineProfiler
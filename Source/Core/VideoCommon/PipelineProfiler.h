@@ -0,0 +1,67 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Opt-in instrumentation of the CPU time the GPU thread spends in the main stages of the video
+// pipeline. Timings are aggregated into per-frame histograms, which are shown in the statistics
+// overlay, and every timed scope is written to a Chrome trace file in the logs directory that
+// can be loaded in chrome://tracing or ui.perfetto.dev.
+//
+// Only the GPU thread (or the CPU thread in single core mode) may record timings.
+namespace PipelineProfiler
+{
+enum class Section : u32
+{
+  OpcodeDecoding,
+  VertexLoading,
+  VertexFlush,
+  ShaderLookup,
+  TextureLookup,
+  NumSections
+};
+
+// Mirrors the active video config, updated once per frame.
+extern bool g_enabled;
+
+void Init();
+void Shutdown();
+
+// Folds the timings of the current frame into the histograms and flushes the trace file.
+// Called by the renderer when a frame is presented.
+void FrameEnded();
+
+std::string ToString();
+
+u64 GetTimeNs();
+void Record(Section section, u64 start_ns, u64 end_ns);
+
+// Times the enclosing scope. Nested scopes are recorded separately, so the time of a section
+// includes the time of the sections it calls into.
+class ScopedTimer final
+{
+public:
+  explicit ScopedTimer(Section section, bool active = true) : m_section(section)
+  {
+    if (g_enabled && active)
+      m_start_ns = GetTimeNs();
+  }
+  ~ScopedTimer()
+  {
+    if (m_start_ns)
+      Record(m_section, m_start_ns, GetTimeNs());
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  Section m_section;
+  u64 m_start_ns = 0;
+};
+}  // namespace PipelineProfiler
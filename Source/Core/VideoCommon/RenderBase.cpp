@@ -50,10 +50,12 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Debugger.h"
+#include "VideoCommon/EFBAccessCache.h"
 #include "VideoCommon/FPSCounter.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/PipelineProfiler.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/PostProcessing.h"
 #include "VideoCommon/ShaderCache.h"
@@ -375,6 +377,7 @@ void Renderer::DrawDebugText()
   }
 
   final_cyan += Common::Profiler::ToString();
+  final_cyan += PipelineProfiler::ToString();
 
   if (g_ActiveConfig.bOverlayStats)
     final_cyan += Statistics::ToString();
@@ -682,6 +685,8 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
         std::lock_guard<std::mutex> guard(m_swap_mutex);
         g_renderer->SwapImpl(xfb_entry->texture.get(), xfb_rect, ticks, xfb_entry->gamma);
       }
+      // The backend may have resized the EFB.
+      EFBAccessCache::Invalidate();
 
       // Update the window size based on the frame that was just rendered.
       // Due to depending on guest state, we need to call this every frame.
@@ -699,6 +704,7 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
       // Set default viewport and scissor, for the clear to work correctly
       // New frame
       stats.ResetFrame();
+      PipelineProfiler::FrameEnded();
       g_shader_cache->RetrieveAsyncShaders();
 
       // We invalidate the pipeline object at the start of the frame.
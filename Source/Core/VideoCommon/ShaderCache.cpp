@@ -10,6 +10,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/Host.h"
 
+#include "VideoCommon/PipelineProfiler.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -65,6 +66,10 @@ void ShaderCache::SetHostConfig(const ShaderHostConfig& host_config, u32 efb_mul
 
 void ShaderCache::Reload()
 {
+  // Whatever hasn't started compiling yet is for the old configuration. The pipelines that are
+  // retrieved while we wait queue the shaders they were waiting for again.
+  m_async_shader_compiler->CancelPendingWork();
+  RemovePendingShaders();
   WaitForAsyncCompiler();
   ClosePipelineUIDCache();
   InvalidateCachedPipelines();
@@ -88,6 +93,13 @@ void ShaderCache::Reload()
 void ShaderCache::RetrieveAsyncShaders()
 {
   m_async_shader_compiler->RetrieveWorkItems();
+
+  const AsyncShaderCompiler::Statistics compiler_stats = m_async_shader_compiler->GetStatistics();
+  SETSTAT(stats.numPendingShaderCompiles, compiler_stats.pending);
+  SETSTAT(stats.numShaderCompilesCancelled, compiler_stats.cancelled);
+  SETSTAT(stats.numShaderCompilesStolen, compiler_stats.stolen);
+  SETSTAT_FT(stats.shaderCompileLatencyMs, compiler_stats.average_latency_ms);
+  SETSTAT_FT(stats.shaderCompileMaxLatencyMs, compiler_stats.max_latency_ms);
 }
 
 void ShaderCache::Shutdown()
@@ -102,6 +114,8 @@ void ShaderCache::Shutdown()
 
 const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
 {
+  PipelineProfiler::ScopedTimer profiler_timer(PipelineProfiler::Section::ShaderLookup);
+
   auto it = m_gx_pipeline_cache.find(uid);
   if (it != m_gx_pipeline_cache.end() && !it->second.second)
     return it->second.first.get();
@@ -118,6 +132,8 @@ const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
 
 std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const GXPipelineUid& uid)
 {
+  PipelineProfiler::ScopedTimer profiler_timer(PipelineProfiler::Section::ShaderLookup);
+
   auto it = m_gx_pipeline_cache.find(uid);
   if (it != m_gx_pipeline_cache.end())
   {
@@ -135,6 +151,8 @@ std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const
 
 const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineUid& uid)
 {
+  PipelineProfiler::ScopedTimer profiler_timer(PipelineProfiler::Section::ShaderLookup);
+
   auto it = m_gx_uber_pipeline_cache.find(uid);
   if (it != m_gx_uber_pipeline_cache.end() && !it->second.second)
     return it->second.first.get();
@@ -228,6 +246,27 @@ void ShaderCache::LoadShaderCaches()
                                                       true);
 }
 
+template <typename T>
+static void RemovePendingShaderEntries(T& cache)
+{
+  for (auto it = cache.shader_map.begin(); it != cache.shader_map.end();)
+  {
+    if (it->second.pending)
+      it = cache.shader_map.erase(it);
+    else
+      ++it;
+  }
+}
+
+void ShaderCache::RemovePendingShaders()
+{
+  RemovePendingShaderEntries(m_vs_cache);
+  RemovePendingShaderEntries(m_gs_cache);
+  RemovePendingShaderEntries(m_ps_cache);
+  RemovePendingShaderEntries(m_uber_vs_cache);
+  RemovePendingShaderEntries(m_uber_ps_cache);
+}
+
 void ShaderCache::ClearShaderCaches()
 {
   ClearShaderCache(m_vs_cache);
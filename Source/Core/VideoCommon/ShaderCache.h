@@ -67,6 +67,7 @@ private:
   void WaitForAsyncCompiler();
   void LoadShaderCaches();
   void ClearShaderCaches();
+  void RemovePendingShaders();
   void LoadPipelineUIDCache();
   void ClosePipelineUIDCache();
   void CompileMissingPipelines();
@@ -115,15 +116,15 @@ private:
   void QueuePipelineCompile(const GXPipelineUid& uid, u32 priority);
   void QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority);
 
-  // Priorities for compiling. The lower the value, the sooner the pipeline is compiled.
-  // The shader cache is compiled last, as it is the least likely to be required. On demand
-  // shaders are always compiled before pending ubershaders, as we want to use the ubershader
-  // for as few frames as possible, otherwise we risk framerate drops.
+  // Priorities for compiling, which are the lanes of the async compiler. The lower the value, the
+  // sooner the pipeline is compiled. The shader cache is compiled last, as it is the least likely
+  // to be required. On demand shaders are always compiled before pending ubershaders, as we want
+  // to use the ubershader for as few frames as possible, otherwise we risk framerate drops.
   enum : u32
   {
-    COMPILE_PRIORITY_ONDEMAND_PIPELINE = 100,
-    COMPILE_PRIORITY_UBERSHADER_PIPELINE = 200,
-    COMPILE_PRIORITY_SHADERCACHE_PIPELINE = 300
+    COMPILE_PRIORITY_ONDEMAND_PIPELINE = AsyncShaderCompiler::PRIORITY_LANE_ONDEMAND,
+    COMPILE_PRIORITY_UBERSHADER_PIPELINE = AsyncShaderCompiler::PRIORITY_LANE_UBERSHADER,
+    COMPILE_PRIORITY_SHADERCACHE_PIPELINE = AsyncShaderCompiler::PRIORITY_LANE_PRECOMPILE
   };
 
   // Configuration bits.
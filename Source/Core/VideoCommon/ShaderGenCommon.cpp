@@ -3,10 +3,327 @@
 // Refer to the license.txt file included.
 
 #include "VideoCommon/ShaderGenCommon.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
 #include "Common/CommonPaths.h"
 #include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
 #include "Core/ConfigManager.h"
 
+namespace
+{
+struct FormatSpec
+{
+  bool left_justify = false;
+  bool plus_sign = false;
+  bool space_sign = false;
+  bool alternate_form = false;
+  bool zero_pad = false;
+  int width = 0;
+  // -1 if there is no precision.
+  int precision = -1;
+  // Length modifier, up to two characters.
+  char length[3] = {};
+  char conversion = 0;
+};
+
+void AppendPadding(std::string* out, const FormatSpec& spec, size_t length, char pad)
+{
+  if (static_cast<size_t>(spec.width) > length)
+    out->append(spec.width - length, pad);
+}
+
+void AppendInteger(std::string* out, const FormatSpec& spec, u64 magnitude, bool negative)
+{
+  const bool is_signed = spec.conversion == 'd' || spec.conversion == 'i';
+  const unsigned int base =
+      spec.conversion == 'x' || spec.conversion == 'X' ? 16 : spec.conversion == 'o' ? 8 : 10;
+  const char* const alphabet = spec.conversion == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+
+  char digits[24];
+  char* const digits_end = digits + sizeof(digits);
+  char* digits_begin = digits_end;
+  const bool is_zero = magnitude == 0;
+  for (; magnitude != 0; magnitude /= base)
+    *--digits_begin = alphabet[magnitude % base];
+  // A precision of 0 means that no digit is written for 0.
+  if (is_zero && spec.precision != 0)
+    *--digits_begin = '0';
+  const size_t digit_count = digits_end - digits_begin;
+
+  char prefix[2];
+  size_t prefix_length = 0;
+  if (negative)
+    prefix[prefix_length++] = '-';
+  else if (is_signed && spec.plus_sign)
+    prefix[prefix_length++] = '+';
+  else if (is_signed && spec.space_sign)
+    prefix[prefix_length++] = ' ';
+  else if (spec.alternate_form && base == 16 && !is_zero)
+  {
+    prefix[prefix_length++] = '0';
+    prefix[prefix_length++] = spec.conversion;
+  }
+
+  size_t leading_zeros =
+      spec.precision > 0 && static_cast<size_t>(spec.precision) > digit_count ?
+          spec.precision - digit_count :
+          0;
+  // The alternate form of octal numbers starts with a 0.
+  if (spec.alternate_form && base == 8 && leading_zeros == 0 &&
+      (digit_count == 0 || *digits_begin != '0'))
+  {
+    leading_zeros = 1;
+  }
+
+  // The 0 flag is ignored when there is a precision.
+  const bool zero_pad = spec.zero_pad && !spec.left_justify && spec.precision < 0;
+  const size_t length = prefix_length + leading_zeros + digit_count;
+  if (!spec.left_justify && !zero_pad)
+    AppendPadding(out, spec, length, ' ');
+  out->append(prefix, prefix_length);
+  if (zero_pad)
+    AppendPadding(out, spec, length, '0');
+  out->append(leading_zeros, '0');
+  out->append(digits_begin, digit_count);
+  if (spec.left_justify)
+    AppendPadding(out, spec, length, ' ');
+}
+
+void AppendString(std::string* out, const FormatSpec& spec, const char* str, size_t length)
+{
+  if (!spec.left_justify)
+    AppendPadding(out, spec, length, ' ');
+  out->append(str, length);
+  if (spec.left_justify)
+    AppendPadding(out, spec, length, ' ');
+}
+
+// For the conversions that are rarely used in shaders, rebuilds the specification without the
+// '*' and lets the C library format the value. StringFromFormat() formats in the C locale, as
+// shaders need a decimal point whatever the locale of the user is.
+template <typename T>
+void AppendWithCLibrary(std::string* out, const FormatSpec& spec, T value)
+{
+  char format[32];
+  char* p = format;
+  *p++ = '%';
+  if (spec.left_justify)
+    *p++ = '-';
+  if (spec.plus_sign)
+    *p++ = '+';
+  if (spec.space_sign)
+    *p++ = ' ';
+  if (spec.alternate_form)
+    *p++ = '#';
+  if (spec.zero_pad)
+    *p++ = '0';
+  if (spec.width > 0)
+    p += std::sprintf(p, "%d", spec.width);
+  if (spec.precision >= 0)
+    p += std::sprintf(p, ".%d", spec.precision);
+  p = std::strcpy(p, spec.length) + std::strlen(spec.length);
+  *p++ = spec.conversion;
+  *p = '\0';
+
+  out->append(StringFromFormat(format, value));
+}
+
+// Parses the specification after a '%'. Returns a pointer past it, or nullptr if the format
+// string ends in the middle of it.
+const char* ParseFormatSpec(const char* p, FormatSpec* spec, va_list& args)
+{
+  for (;; ++p)
+  {
+    if (*p == '-')
+      spec->left_justify = true;
+    else if (*p == '+')
+      spec->plus_sign = true;
+    else if (*p == ' ')
+      spec->space_sign = true;
+    else if (*p == '#')
+      spec->alternate_form = true;
+    else if (*p == '0')
+      spec->zero_pad = true;
+    else
+      break;
+  }
+
+  if (*p == '*')
+  {
+    spec->width = va_arg(args, int);
+    // A negative width is taken as a '-' flag.
+    if (spec->width < 0)
+    {
+      spec->left_justify = true;
+      spec->width = -spec->width;
+    }
+    ++p;
+  }
+  else
+  {
+    for (; *p >= '0' && *p <= '9'; ++p)
+      spec->width = spec->width * 10 + (*p - '0');
+  }
+
+  if (*p == '.')
+  {
+    ++p;
+    if (*p == '*')
+    {
+      // A negative precision is taken as if there was none.
+      spec->precision = std::max(va_arg(args, int), -1);
+      ++p;
+    }
+    else
+    {
+      spec->precision = 0;
+      for (; *p >= '0' && *p <= '9'; ++p)
+        spec->precision = spec->precision * 10 + (*p - '0');
+    }
+  }
+
+  size_t length_size = 0;
+  while (length_size < 2 && *p != '\0' && std::strchr("hljztL", *p))
+    spec->length[length_size++] = *p++;
+
+  if (*p == '\0')
+    return nullptr;
+  spec->conversion = *p;
+  return p + 1;
+}
+
+// Reads an integer argument of the type given by the length modifier, converted to T.
+template <typename T>
+T ReadInteger(const FormatSpec& spec, va_list& args)
+{
+  constexpr bool is_signed = std::is_signed<T>();
+  switch (spec.length[0])
+  {
+  case 'h':
+    if (spec.length[1] == 'h')
+    {
+      return is_signed ? static_cast<T>(static_cast<signed char>(va_arg(args, int))) :
+                         static_cast<T>(static_cast<unsigned char>(va_arg(args, int)));
+    }
+    return is_signed ? static_cast<T>(static_cast<short>(va_arg(args, int))) :
+                       static_cast<T>(static_cast<unsigned short>(va_arg(args, int)));
+  case 'l':
+    if (spec.length[1] == 'l')
+    {
+      return is_signed ? static_cast<T>(va_arg(args, long long)) :
+                         static_cast<T>(va_arg(args, unsigned long long));
+    }
+    return is_signed ? static_cast<T>(va_arg(args, long)) :
+                       static_cast<T>(va_arg(args, unsigned long));
+  case 'j':
+    return is_signed ? static_cast<T>(va_arg(args, intmax_t)) :
+                       static_cast<T>(va_arg(args, uintmax_t));
+  case 'z':
+    return static_cast<T>(static_cast<std::make_signed_t<size_t>>(va_arg(args, size_t)));
+  case 't':
+    return static_cast<T>(va_arg(args, ptrdiff_t));
+  default:
+    return is_signed ? static_cast<T>(va_arg(args, int)) :
+                       static_cast<T>(va_arg(args, unsigned int));
+  }
+}
+
+void AppendFormatV(std::string* out, const char* format, va_list& args)
+{
+  const char* p = format;
+  while (true)
+  {
+    // Copy the text up to the next conversion in one go.
+    const char* const percent = std::strchr(p, '%');
+    if (!percent)
+    {
+      out->append(p);
+      return;
+    }
+    out->append(p, percent - p);
+
+    FormatSpec spec;
+    const char* const spec_end = ParseFormatSpec(percent + 1, &spec, args);
+    if (!spec_end)
+      return;
+    p = spec_end;
+
+    switch (spec.conversion)
+    {
+    case '%':
+      out->push_back('%');
+      break;
+    case 'd':
+    case 'i':
+    {
+      const s64 value = ReadInteger<s64>(spec, args);
+      const u64 magnitude = value < 0 ? 0 - static_cast<u64>(value) : static_cast<u64>(value);
+      AppendInteger(out, spec, magnitude, value < 0);
+      break;
+    }
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+      AppendInteger(out, spec, ReadInteger<u64>(spec, args), false);
+      break;
+    case 'c':
+    {
+      const char c = static_cast<char>(va_arg(args, int));
+      AppendString(out, spec, &c, 1);
+      break;
+    }
+    case 's':
+    {
+      const char* str = va_arg(args, const char*);
+      if (!str)
+        str = "(null)";
+      const size_t length =
+          spec.precision < 0 ? std::strlen(str) : strnlen(str, static_cast<size_t>(spec.precision));
+      AppendString(out, spec, str, length);
+      break;
+    }
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      if (spec.length[0] == 'L')
+        AppendWithCLibrary(out, spec, va_arg(args, long double));
+      else
+        AppendWithCLibrary(out, spec, va_arg(args, double));
+      break;
+    case 'p':
+      AppendWithCLibrary(out, spec, va_arg(args, void*));
+      break;
+    default:
+      // Not a valid conversion: write it out as is.
+      out->append(percent, spec_end - percent);
+      break;
+    }
+  }
+}
+}  // namespace
+
+void ShaderCode::Write(const char* fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  AppendFormatV(&m_buffer, fmt, args);
+  va_end(args);
+}
+
 ShaderHostConfig ShaderHostConfig::GetCurrent()
 {
   ShaderHostConfig bits = {};
@@ -111,16 +111,14 @@ class ShaderCode : public ShaderGeneratorInterface
 public:
   ShaderCode() { m_buffer.reserve(16384); }
   const std::string& GetBuffer() const { return m_buffer; }
+  // Formats straight into the buffer instead of going through a temporary string, since the
+  // generators write thousands of fragments per shader. Integers, characters and strings are
+  // formatted here; only the rare floating point and pointer conversions go to the C library.
   void Write(const char* fmt, ...)
 #ifdef __GNUC__
       __attribute__((format(printf, 2, 3)))
 #endif
-  {
-    va_list arglist;
-    va_start(arglist, fmt);
-    m_buffer += StringFromFormatV(fmt, arglist);
-    va_end(arglist);
-  }
+      ;
 
 protected:
   std::string m_buffer;
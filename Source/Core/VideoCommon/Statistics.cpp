@@ -2,11 +2,13 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <cinttypes>
 #include <cstring>
 #include <string>
 #include <utility>
 
 #include "Common/StringUtil.h"
+#include "VideoCommon/AsyncRequests.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoConfig.h"
@@ -15,6 +17,7 @@ Statistics stats;
 
 void Statistics::ResetFrame()
 {
+  prevFrame = thisFrame;
   memset(&thisFrame, 0, sizeof(ThisFrame));
 }
 
@@ -67,6 +70,29 @@ std::string Statistics::ToString()
   str += StringFromFormat("Index streamed: %i kB\n", stats.thisFrame.bytesIndexStreamed / 1024);
   str += StringFromFormat("Uniform streamed: %i kB\n", stats.thisFrame.bytesUniformStreamed / 1024);
   str += StringFromFormat("Vertex Loaders: %i\n", stats.numVertexLoaders);
+  const u64 loader_lookups = stats.numVertexLoaderCacheHits + stats.numVertexLoaderCacheMisses;
+  str += StringFromFormat("Vertex Loader cache hits: %" PRIu64 " / %" PRIu64 " (%.1f%%)\n",
+                          stats.numVertexLoaderCacheHits, loader_lookups,
+                          loader_lookups ? stats.numVertexLoaderCacheHits * 100.0 / loader_lookups :
+                                           0.0);
+  str += StringFromFormat("Shader compiles pending: %i\n", stats.numPendingShaderCompiles);
+  str += StringFromFormat("Shader compiles cancelled: %i\n", stats.numShaderCompilesCancelled);
+  str += StringFromFormat("Shader compiles stolen: %i\n", stats.numShaderCompilesStolen);
+  str += StringFromFormat("Shader compile latency: %.1f ms (max %.1f ms)\n",
+                          stats.shaderCompileLatencyMs, stats.shaderCompileMaxLatencyMs);
+  const u64 efb_peeks = stats.numEFBPeekCacheHits + stats.numEFBPeekCacheMisses;
+  str += StringFromFormat("EFB peek cache hits: %" PRIu64 " / %" PRIu64 " (%.1f%%)\n",
+                          stats.numEFBPeekCacheHits, efb_peeks,
+                          efb_peeks ? stats.numEFBPeekCacheHits * 100.0 / efb_peeks : 0.0);
+  str += StringFromFormat("EFB pokes: %" PRIu64 " in %" PRIu64 " batches\n", stats.numEFBPokes,
+                          stats.numEFBPokeFlushes);
+  str += AsyncRequests::GetInstance()->GetStatisticsString();
+  const u64 dl_calls = stats.numDisplayListCacheHits + stats.numDisplayListCacheMisses;
+  str += StringFromFormat("Display list cache hits: %" PRIu64 " / %" PRIu64
+                          " (%.1f%%), %" PRIu64 " fell back\n",
+                          stats.numDisplayListCacheHits, dl_calls,
+                          dl_calls ? stats.numDisplayListCacheHits * 100.0 / dl_calls : 0.0,
+                          stats.numDisplayListCacheFallbacks);
 
   std::string vertex_list = VertexLoaderManager::VertexLoadersToString();
 
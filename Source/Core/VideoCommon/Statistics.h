@@ -6,6 +6,8 @@
 
 #include <string>
 
+#include "Common/CommonTypes.h"
+
 struct Statistics
 {
   int numPixelShadersCreated;
@@ -18,6 +20,32 @@ struct Statistics
   int numTexturesAlive;
 
   int numVertexLoaders;
+  // Lookups of the vertex loader for a new vertex format by the GPU thread, and how many of them
+  // were found in its cache of recently used loaders. These count from the start of emulation,
+  // so they are 64-bit to not overflow.
+  u64 numVertexLoaderCacheHits;
+  u64 numVertexLoaderCacheMisses;
+
+  // State of the async shader compiler, updated once per frame. The latencies are the time that
+  // the compiles which started since the previous frame spent waiting in the queue.
+  int numPendingShaderCompiles;
+  int numShaderCompilesCancelled;
+  int numShaderCompilesStolen;
+  float shaderCompileLatencyMs;
+  float shaderCompileMaxLatencyMs;
+
+  // EFB accesses by the CPU thread since the start of emulation. Peeks that hit the cache don't
+  // wait for the GPU thread, and pokes are sent to it in batches.
+  u64 numEFBPeekCacheHits;
+  u64 numEFBPeekCacheMisses;
+  u64 numEFBPokes;
+  u64 numEFBPokeFlushes;
+
+  // Display list calls since the start of emulation that were replayed from the cache or decoded,
+  // and the replays that had to decode the rest of the list because the vertex format changed.
+  u64 numDisplayListCacheHits;
+  u64 numDisplayListCacheMisses;
+  u64 numDisplayListCacheFallbacks;
 
   float proj_0, proj_1, proj_2, proj_3, proj_4, proj_5;
   float gproj_0, gproj_1, gproj_2, gproj_3, gproj_4, gproj_5;
@@ -63,6 +91,8 @@ struct Statistics
     int tevPixelsOut;
   };
   ThisFrame thisFrame;
+  // Counters of the last completed frame, saved by ResetFrame() before clearing thisFrame.
+  ThisFrame prevFrame;
   void ResetFrame();
   static void SwapDL();
 
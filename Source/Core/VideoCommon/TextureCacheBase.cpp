@@ -31,6 +31,7 @@
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/HiresTextures.h"
+#include "VideoCommon/PipelineProfiler.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/SamplerCommon.h"
 #include "VideoCommon/Statistics.h"
@@ -663,6 +664,8 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
                              TLUTFormat tlutfmt, bool use_mipmaps, u32 tex_levels, bool from_tmem,
                              u32 tmem_address_even, u32 tmem_address_odd)
 {
+  PipelineProfiler::ScopedTimer profiler_timer(PipelineProfiler::Section::TextureLookup);
+
   // TexelSizeInNibbles(format) * width * height / 16;
   const unsigned int bsw = TexDecoder_GetBlockWidthInTexels(texformat);
   const unsigned int bsh = TexDecoder_GetBlockHeightInTexels(texformat);
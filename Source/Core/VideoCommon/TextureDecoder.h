@@ -108,6 +108,10 @@ int TexDecoder_GetEFBCopyBlockHeightInTexels(EFBCopyFormat format);
 int TexDecoder_GetPaletteSize(TextureFormat fmt);
 TextureFormat TexDecoder_GetEFBCopyBaseFormat(EFBCopyFormat format);
 
+// Textures with at least this many texels are split into bands of block rows, which are decoded
+// on several threads when the host has more than one core.
+constexpr int TEXTURE_DECODE_PARALLEL_THRESHOLD = 256 * 256;
+
 void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFormat texformat,
                        const u8* tlut, TLUTFormat tlutfmt);
 void TexDecoder_DecodeRGBA8FromTmem(u8* dst, const u8* src_ar, const u8* src_gb, int width,
@@ -122,3 +126,6 @@ void TexDecoder_SetTexFmtOverlayOptions(bool enable, bool center);
 /* Internal method, implemented by TextureDecoder_Generic and TextureDecoder_x64. */
 void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
                             const u8* tlut, TLUTFormat tlutfmt);
+/* The portable implementation in TextureDecoder_Generic, which the optimized ones must match. */
+void _TexDecoder_DecodeImplGeneric(u32* dst, const u8* src, int width, int height,
+                                   TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
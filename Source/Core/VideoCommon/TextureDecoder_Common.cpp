@@ -12,6 +12,7 @@
 #include "Common/Swap.h"
 
 #include "VideoCommon/LookUpTables.h"
+#include "VideoCommon/ParallelBands.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/TextureDecoder_Util.h"
 #include "VideoCommon/sfont.inc"
@@ -315,10 +316,42 @@ static void TexDecoder_DrawOverlay(u8* dst, int width, int height, TextureFormat
   }
 }
 
+namespace
+{
+bool DecodeInParallel(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
+                      const u8* tlut, TLUTFormat tlutfmt)
+{
+  // The bands start at the beginning of a row of blocks in the source.
+  const int block_width = TexDecoder_GetBlockWidthInTexels(texformat);
+  const int block_height = TexDecoder_GetBlockHeightInTexels(texformat);
+  if (width * height < TEXTURE_DECODE_PARALLEL_THRESHOLD || width % block_width != 0)
+    return false;
+
+  const size_t num_threads = ParallelBands::GetThreadCount();
+  if (num_threads == 1)
+    return false;
+
+  // A few bands per thread, so that a thread that was descheduled doesn't hold the others up.
+  const int block_rows = (height + block_height - 1) / block_height;
+  const int max_bands = static_cast<int>(num_threads) * 2;
+  const int rows_per_band = (block_rows + max_bands - 1) / max_bands;
+  const int band_height = rows_per_band * block_height;
+  const int num_bands = (block_rows + rows_per_band - 1) / rows_per_band;
+  return ParallelBands::Run(num_bands, [=](int band) {
+    const int first_line = band * band_height;
+    _TexDecoder_DecodeImpl(dst + first_line * width,
+                           src + TexDecoder_GetTextureSizeInBytes(width, first_line, texformat),
+                           width, std::min(band_height, height - first_line), texformat, tlut,
+                           tlutfmt);
+  });
+}
+}  // namespace
+
 void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFormat texformat,
                        const u8* tlut, TLUTFormat tlutfmt)
 {
-  _TexDecoder_DecodeImpl((u32*)dst, src, width, height, texformat, tlut, tlutfmt);
+  if (!DecodeInParallel((u32*)dst, src, width, height, texformat, tlut, tlutfmt))
+    _TexDecoder_DecodeImpl((u32*)dst, src, width, height, texformat, tlut, tlutfmt);
 
   if (TexFmt_Overlay_Enable)
     TexDecoder_DrawOverlay(dst, width, height, texformat);
@@ -422,6 +422,30 @@ static void TexDecoder_DecodeImpl_I8_SSSE3(u32* dst, const u8* src, int width, i
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_I8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // A row of 8 texels fills a whole 256-bit register. The row is copied to both 128-bit lanes,
+  // and each lane expands four of its texels.
+  const __m256i mask = _mm256_set_epi8(7, 7, 7, 7, 6, 6, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 3, 3, 3, 3,
+                                       2, 2, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps8; x < width; x += 8, yStep++)
+    {
+      const u8* block = src + 32 * yStep;
+      for (int iy = 0; iy < 4; iy++)
+      {
+        const __m256i row =
+            _mm256_broadcastq_epi64(_mm_loadl_epi64((const __m128i*)(block + 8 * iy)));
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x), _mm256_shuffle_epi8(row, mask));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_I8(u32* dst, const u8* src, int width, int height,
                                      TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                      int Wsteps4, int Wsteps8)
@@ -601,6 +625,44 @@ static void TexDecoder_DecodeImpl_IA8_SSSE3(u32* dst, const u8* src, int width,
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m256i mask = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(6, 7, 7, 7, 4, 5, 5, 5, 2, 3, 3, 3, 0, 1, 1, 1));
+  for (int y = 0; y < height; y += 4)
+  {
+    int x = 0;
+    int yStep = (y / 4) * Wsteps4;
+    // Two blocks side by side, so that each store writes a row of 8 texels.
+    for (; x + 8 <= width; x += 8, yStep += 2)
+    {
+      const u8* left = src + 32 * yStep;
+      const u8* right = left + 32;
+      for (int iy = 0; iy < 4; iy++)
+      {
+        const __m256i rows = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadl_epi64((const __m128i*)(left + 8 * iy))),
+            _mm_loadl_epi64((const __m128i*)(right + 8 * iy)), 1);
+        _mm256_storeu_si256((__m256i*)(dst + (y + iy) * width + x),
+                            _mm256_shuffle_epi8(rows, mask));
+      }
+    }
+    for (; x < width; x += 4, yStep++)
+    {
+      const u8* block = src + 32 * yStep;
+      for (int iy = 0; iy < 4; iy++)
+      {
+        const __m128i row = _mm_loadl_epi64((const __m128i*)(block + 8 * iy));
+        _mm_storeu_si128((__m128i*)(dst + (y + iy) * width + x),
+                         _mm_shuffle_epi8(row, _mm256_castsi256_si128(mask)));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_IA8(u32* dst, const u8* src, int width, int height,
                                       TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                       int Wsteps4, int Wsteps8)
@@ -878,6 +940,69 @@ static void TexDecoder_DecodeImpl_RGB5A3_SSSE3(u32* dst, const u8* src, int widt
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB5A3_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m128i kByteSwap16 = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+  const __m256i kMask_x1f = _mm256_set1_epi32(0x0000001fL);
+  const __m256i kMask_x0f = _mm256_set1_epi32(0x0000000fL);
+  const __m256i kMask_x07 = _mm256_set1_epi32(0x00000007L);
+  const __m256i aVxff00 = _mm256_set1_epi32(0xFF000000L);
+
+  // Unlike the SSSE3 version, this one doesn't branch on the mix of formats in a row: both
+  // conversions are done for 8 texels, and the top bit of each texel selects between them.
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0, yStep = (y / 4) * Wsteps4; x < width; x += 4, yStep++)
+    {
+      const u8* block = src + 32 * yStep;
+      for (int iy = 0; iy < 4; iy += 2)
+      {
+        // Rows iy and iy + 1, zero extended to 32 bits per texel.
+        const __m256i valV = _mm256_cvtepu16_epi32(
+            _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(block + 8 * iy)), kByteSwap16));
+
+        // RGB555: 00012345 -> 12345123
+        const __m256i tmpr5V = _mm256_and_si256(_mm256_srli_epi32(valV, 10), kMask_x1f);
+        const __m256i r5V =
+            _mm256_or_si256(_mm256_slli_epi32(tmpr5V, 3), _mm256_srli_epi32(tmpr5V, 2));
+        const __m256i tmpg5V = _mm256_and_si256(_mm256_srli_epi32(valV, 5), kMask_x1f);
+        const __m256i g5V =
+            _mm256_or_si256(_mm256_slli_epi32(tmpg5V, 3), _mm256_srli_epi32(tmpg5V, 2));
+        const __m256i tmpb5V = _mm256_and_si256(valV, kMask_x1f);
+        const __m256i b5V =
+            _mm256_or_si256(_mm256_slli_epi32(tmpb5V, 3), _mm256_srli_epi32(tmpb5V, 2));
+        const __m256i rgb555V =
+            _mm256_or_si256(_mm256_or_si256(r5V, _mm256_slli_epi32(g5V, 8)),
+                            _mm256_or_si256(_mm256_slli_epi32(b5V, 16), aVxff00));
+
+        // RGBA4443: 00001234 -> 12341234, and 00000123 -> 12312312 for the alpha.
+        const __m256i tmpr4V = _mm256_and_si256(_mm256_srli_epi32(valV, 8), kMask_x0f);
+        const __m256i r4V = _mm256_or_si256(_mm256_slli_epi32(tmpr4V, 4), tmpr4V);
+        const __m256i tmpg4V = _mm256_and_si256(_mm256_srli_epi32(valV, 4), kMask_x0f);
+        const __m256i g4V = _mm256_or_si256(_mm256_slli_epi32(tmpg4V, 4), tmpg4V);
+        const __m256i tmpb4V = _mm256_and_si256(valV, kMask_x0f);
+        const __m256i b4V = _mm256_or_si256(_mm256_slli_epi32(tmpb4V, 4), tmpb4V);
+        const __m256i tmpaV = _mm256_and_si256(_mm256_srli_epi32(valV, 12), kMask_x07);
+        const __m256i aV = _mm256_or_si256(
+            _mm256_slli_epi32(tmpaV, 5),
+            _mm256_or_si256(_mm256_slli_epi32(tmpaV, 2), _mm256_srli_epi32(tmpaV, 1)));
+        const __m256i rgba4443V =
+            _mm256_or_si256(_mm256_or_si256(r4V, _mm256_slli_epi32(g4V, 8)),
+                            _mm256_or_si256(_mm256_slli_epi32(b4V, 16), _mm256_slli_epi32(aV, 24)));
+
+        const __m256i is555V = _mm256_srai_epi32(_mm256_slli_epi32(valV, 16), 31);
+        const __m256i final = _mm256_blendv_epi8(rgba4443V, rgb555V, is555V);
+        _mm_storeu_si128((__m128i*)(dst + (y + iy) * width + x), _mm256_castsi256_si128(final));
+        _mm_storeu_si128((__m128i*)(dst + (y + iy + 1) * width + x),
+                         _mm256_extracti128_si256(final, 1));
+      }
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_RGB5A3(u32* dst, const u8* src, int width, int height,
                                          TextureFormat texformat, const u8* tlut,
                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
@@ -1033,6 +1158,57 @@ static void TexDecoder_DecodeImpl_RGBA8_SSSE3(u32* dst, const u8* src, int width
   }
 }
 
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGBA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  const __m256i mask0312 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(12, 15, 13, 14, 8, 11, 9, 10, 4, 7, 5, 6, 0, 3, 1, 2));
+  for (int y = 0; y < height; y += 4)
+  {
+    int x = 0;
+    int yStep = (y / 4) * Wsteps4;
+    // Two blocks side by side, so that each store writes a row of 8 texels. Unpacking works
+    // within 128-bit lanes, so it gives rows 0 and 2, or rows 1 and 3, of a block.
+    for (; x + 8 <= width; x += 8, yStep += 2)
+    {
+      const u8* src2 = src + 64 * yStep;
+      const __m256i ar0 = _mm256_loadu_si256((const __m256i*)src2);
+      const __m256i gb0 = _mm256_loadu_si256((const __m256i*)src2 + 1);
+      const __m256i ar1 = _mm256_loadu_si256((const __m256i*)src2 + 2);
+      const __m256i gb1 = _mm256_loadu_si256((const __m256i*)src2 + 3);
+
+      const __m256i rgba02_0 = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(ar0, gb0), mask0312);
+      const __m256i rgba13_0 = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(ar0, gb0), mask0312);
+      const __m256i rgba02_1 = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(ar1, gb1), mask0312);
+      const __m256i rgba13_1 = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(ar1, gb1), mask0312);
+
+      _mm256_storeu_si256((__m256i*)(dst + (y + 0) * width + x),
+                          _mm256_permute2x128_si256(rgba02_0, rgba02_1, 0x20));
+      _mm256_storeu_si256((__m256i*)(dst + (y + 1) * width + x),
+                          _mm256_permute2x128_si256(rgba13_0, rgba13_1, 0x20));
+      _mm256_storeu_si256((__m256i*)(dst + (y + 2) * width + x),
+                          _mm256_permute2x128_si256(rgba02_0, rgba02_1, 0x31));
+      _mm256_storeu_si256((__m256i*)(dst + (y + 3) * width + x),
+                          _mm256_permute2x128_si256(rgba13_0, rgba13_1, 0x31));
+    }
+    for (; x < width; x += 4, yStep++)
+    {
+      const u8* src2 = src + 64 * yStep;
+      const __m256i ar = _mm256_loadu_si256((const __m256i*)src2);
+      const __m256i gb = _mm256_loadu_si256((const __m256i*)src2 + 1);
+      const __m256i rgba02 = _mm256_shuffle_epi8(_mm256_unpacklo_epi8(ar, gb), mask0312);
+      const __m256i rgba13 = _mm256_shuffle_epi8(_mm256_unpackhi_epi8(ar, gb), mask0312);
+
+      _mm_storeu_si128((__m128i*)(dst + (y + 0) * width + x), _mm256_castsi256_si128(rgba02));
+      _mm_storeu_si128((__m128i*)(dst + (y + 1) * width + x), _mm256_castsi256_si128(rgba13));
+      _mm_storeu_si128((__m128i*)(dst + (y + 2) * width + x), _mm256_extracti128_si256(rgba02, 1));
+      _mm_storeu_si128((__m128i*)(dst + (y + 3) * width + x), _mm256_extracti128_si256(rgba13, 1));
+    }
+  }
+}
+
 static void TexDecoder_DecodeImpl_RGBA8(u32* dst, const u8* src, int width, int height,
                                         TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt,
                                         int Wsteps4, int Wsteps8)
@@ -1431,7 +1607,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::I8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_I8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_I8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1447,7 +1626,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::IA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_IA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_IA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                       Wsteps8);
     else
@@ -1466,7 +1648,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGB5A3:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB5A3_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGB5A3_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                          Wsteps8);
     else
@@ -1475,7 +1660,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGBA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGBA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGBA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                         Wsteps8);
     else
@@ -3,22 +3,33 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "Common/Assert.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Flag.h"
+#include "Common/Logging/Log.h"
+#include "Common/Thread.h"
+#include "Core/ConfigManager.h"
 #include "Core/HW/Memmap.h"
 
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/PipelineProfiler.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -40,7 +51,52 @@ u32 g_current_components;
 typedef std::unordered_map<VertexLoaderUID, std::unique_ptr<VertexLoaderBase>> VertexLoaderMap;
 static std::mutex s_vertex_loader_map_lock;
 static VertexLoaderMap s_vertex_loader_map;
-// TODO - change into array of pointers. Keep a map of all seen so far.
+
+// The loaders that the GPU thread and the preprocessing thread used most recently, so that
+// switching between a few vertex formats every draw doesn't need the lock and a map lookup.
+// Each cache is only used by its own thread. Loaders are never removed from the map until it is
+// cleared, which bumps the generation to make the caches drop their pointers.
+namespace
+{
+constexpr size_t LOADER_CACHE_SIZE = 16;
+
+struct LoaderCache
+{
+  struct Entry
+  {
+    VertexLoaderUID uid;
+    VertexLoaderBase* loader = nullptr;
+  };
+
+  std::array<Entry, LOADER_CACHE_SIZE> entries;
+  u32 generation = 0;
+};
+}  // namespace
+
+static std::atomic<u32> s_vertex_loader_map_generation{0};
+static std::array<LoaderCache, 2> s_loader_caches;
+
+// Disk cache of the vertex formats that the game used, in the spirit of the pipeline UID cache of
+// ShaderCache. The file and the set of recorded UIDs are protected by s_vertex_loader_map_lock.
+namespace
+{
+constexpr u32 LOADER_UID_CACHE_MAGIC = 0x44495556;  // VUID
+constexpr u32 LOADER_UID_CACHE_VERSION = 1;
+constexpr size_t LOADER_UID_CACHE_HEADER_SIZE = sizeof(u32) + sizeof(u32);
+
+#pragma pack(push, 1)
+struct SerializedVertexLoaderUID
+{
+  u64 vtx_desc;
+  u32 vat[3];
+};
+#pragma pack(pop)
+}  // namespace
+
+static File::IOFile s_loader_uid_cache_file;
+static std::unordered_set<VertexLoaderUID> s_recorded_loader_uids;
+static std::thread s_loader_warmup_thread;
+static Common::Flag s_loader_warmup_abort;
 
 u8* cached_arraybases[12];
 
@@ -52,13 +108,140 @@ void Init()
   for (auto& map_entry : g_preprocess_cp_state.vertex_loaders)
     map_entry = nullptr;
   SETSTAT(stats.numVertexLoaders, 0);
+  SETSTAT(stats.numVertexLoaderCacheHits, 0);
+  SETSTAT(stats.numVertexLoaderCacheMisses, 0);
+}
+
+static void StopVertexLoaderWarmup()
+{
+  if (s_loader_warmup_thread.joinable())
+  {
+    s_loader_warmup_abort.Set();
+    s_loader_warmup_thread.join();
+  }
 }
 
 void Clear()
 {
+  StopVertexLoaderWarmup();
+
   std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+  s_loader_uid_cache_file.Close();
+  s_recorded_loader_uids.clear();
   s_vertex_loader_map.clear();
   s_native_vertex_map.clear();
+  s_vertex_loader_map_generation.fetch_add(1, std::memory_order_release);
+}
+
+static void CompileRecordedLoaders(std::vector<SerializedVertexLoaderUID> uids)
+{
+  Common::SetCurrentThreadName("Vertex loader warmup");
+
+  size_t compiled = 0;
+  for (const SerializedVertexLoaderUID& serialized : uids)
+  {
+    if (s_loader_warmup_abort.IsSet())
+      break;
+
+    TVtxDesc vtx_desc;
+    vtx_desc.Hex = serialized.vtx_desc;
+    VAT vtx_attr;
+    vtx_attr.g0.Hex = serialized.vat[0];
+    vtx_attr.g1.Hex = serialized.vat[1];
+    vtx_attr.g2.Hex = serialized.vat[2];
+    const VertexLoaderUID uid(vtx_desc, vtx_attr);
+    {
+      std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+      if (s_vertex_loader_map.count(uid))
+        continue;
+    }
+
+    // Compile without holding the lock, so that draws that need other loaders don't wait.
+    // The native vertex format is created by the GPU thread when it first uses the loader, which
+    // is also where the loader is counted in the statistics.
+    std::unique_ptr<VertexLoaderBase> loader =
+        VertexLoaderBase::CreateVertexLoader(vtx_desc, vtx_attr);
+    std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+    if (loader && s_vertex_loader_map.emplace(uid, std::move(loader)).second)
+      ++compiled;
+  }
+
+  INFO_LOG(VIDEO, "Compiled %zu of %zu recorded vertex loaders ahead of time", compiled,
+           uids.size());
+}
+
+void LoadVertexLoaderUIDCache()
+{
+  StopVertexLoaderWarmup();
+
+  const std::string filename =
+      File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".vluidcache";
+  std::vector<SerializedVertexLoaderUID> uids;
+
+  std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+  s_loader_uid_cache_file.Close();
+  s_recorded_loader_uids.clear();
+  if (s_loader_uid_cache_file.Open(filename, "rb+"))
+  {
+    u32 magic, version;
+    const u64 file_size = s_loader_uid_cache_file.GetSize();
+    const size_t uid_count = file_size >= LOADER_UID_CACHE_HEADER_SIZE ?
+                                 static_cast<size_t>(file_size - LOADER_UID_CACHE_HEADER_SIZE) /
+                                     sizeof(SerializedVertexLoaderUID) :
+                                 0;
+    const u64 expected_size =
+        LOADER_UID_CACHE_HEADER_SIZE + uid_count * sizeof(SerializedVertexLoaderUID);
+    uids.resize(uid_count);
+    // A file of the wrong version or size is started over rather than trusted.
+    if (!s_loader_uid_cache_file.ReadBytes(&magic, sizeof(magic)) ||
+        !s_loader_uid_cache_file.ReadBytes(&version, sizeof(version)) ||
+        magic != LOADER_UID_CACHE_MAGIC || version != LOADER_UID_CACHE_VERSION ||
+        file_size != expected_size ||
+        !s_loader_uid_cache_file.ReadArray(uids.data(), uids.size()) ||
+        !s_loader_uid_cache_file.Seek(expected_size, SEEK_SET))
+    {
+      uids.clear();
+      s_loader_uid_cache_file.Close();
+    }
+  }
+
+  if (!s_loader_uid_cache_file.IsOpen() && s_loader_uid_cache_file.Open(filename, "wb"))
+  {
+    s_loader_uid_cache_file.WriteBytes(&LOADER_UID_CACHE_MAGIC, sizeof(LOADER_UID_CACHE_MAGIC));
+    s_loader_uid_cache_file.WriteBytes(&LOADER_UID_CACHE_VERSION,
+                                       sizeof(LOADER_UID_CACHE_VERSION));
+  }
+
+  for (const SerializedVertexLoaderUID& serialized : uids)
+  {
+    TVtxDesc vtx_desc;
+    vtx_desc.Hex = serialized.vtx_desc;
+    const VAT vtx_attr = {{serialized.vat[0]}, {serialized.vat[1]}, {serialized.vat[2]}};
+    s_recorded_loader_uids.emplace(vtx_desc, vtx_attr);
+  }
+  INFO_LOG(VIDEO, "Read %zu vertex loader UIDs from %s", uids.size(), filename.c_str());
+
+  if (!uids.empty())
+  {
+    s_loader_warmup_abort.Clear();
+    s_loader_warmup_thread = std::thread(CompileRecordedLoaders, std::move(uids));
+  }
+}
+
+// Must be called with s_vertex_loader_map_lock held.
+static void RecordLoaderUID(const VertexLoaderUID& uid, const TVtxDesc& vtx_desc,
+                            const VAT& vtx_attr)
+{
+  if (!s_loader_uid_cache_file.IsOpen() || !s_recorded_loader_uids.insert(uid).second)
+    return;
+
+  const SerializedVertexLoaderUID serialized = {
+      vtx_desc.Hex, {vtx_attr.g0.Hex, vtx_attr.g1.Hex, vtx_attr.g2.Hex}};
+  if (!s_loader_uid_cache_file.WriteBytes(&serialized, sizeof(serialized)))
+  {
+    WARN_LOG(VIDEO, "Writing vertex loader UID to cache failed, closing file.");
+    s_loader_uid_cache_file.Close();
+  }
 }
 
 void UpdateVertexArrayPointers()
@@ -195,6 +378,20 @@ NativeVertexFormat* GetUberVertexFormat(const PortableVertexDeclaration& decl)
   return GetOrCreateMatchingFormat(new_decl);
 }
 
+static VertexLoaderBase* FindCachedLoader(LoaderCache* cache, const VertexLoaderUID& uid)
+{
+  const u32 generation = s_vertex_loader_map_generation.load(std::memory_order_acquire);
+  if (cache->generation != generation)
+  {
+    cache->entries.fill({});
+    cache->generation = generation;
+    return nullptr;
+  }
+
+  LoaderCache::Entry& entry = cache->entries[uid.GetHash() % LOADER_CACHE_SIZE];
+  return entry.loader && entry.uid == uid ? entry.loader : nullptr;
+}
+
 static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = false)
 {
   CPState* state = preprocess ? &g_preprocess_cp_state : &g_main_cp_state;
@@ -208,30 +405,47 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
     bool check_for_native_format = !preprocess;
 
     VertexLoaderUID uid(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
-    std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
-    VertexLoaderMap::iterator iter = s_vertex_loader_map.find(uid);
-    if (iter != s_vertex_loader_map.end())
+    LoaderCache* cache = &s_loader_caches[preprocess];
+    loader = FindCachedLoader(cache, uid);
+    // Statistics are only updated by the GPU thread.
+    if (!preprocess && loader)
+      INCSTAT(stats.numVertexLoaderCacheHits);
+    if (!preprocess && !loader)
+      INCSTAT(stats.numVertexLoaderCacheMisses);
+
+    // A loader that the preprocessing thread created may still need its native vertex format.
+    if (!loader || (check_for_native_format && !loader->m_native_vertex_format))
     {
-      loader = iter->second.get();
-      check_for_native_format &= !loader->m_native_vertex_format;
-    }
-    else
-    {
-      s_vertex_loader_map[uid] =
-          VertexLoaderBase::CreateVertexLoader(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
-      loader = s_vertex_loader_map[uid].get();
-      INCSTAT(stats.numVertexLoaders);
-    }
-    if (check_for_native_format)
-    {
-      // search for a cached native vertex format
-      const PortableVertexDeclaration& format = loader->m_native_vtx_decl;
-      std::unique_ptr<NativeVertexFormat>& native = s_native_vertex_map[format];
-      if (!native)
+      std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+      VertexLoaderMap::iterator iter = s_vertex_loader_map.find(uid);
+      if (iter != s_vertex_loader_map.end())
       {
-        native = g_vertex_manager->CreateNativeVertexFormat(format);
+        loader = iter->second.get();
+        check_for_native_format &= !loader->m_native_vertex_format;
       }
-      loader->m_native_vertex_format = native.get();
+      else
+      {
+        s_vertex_loader_map[uid] =
+            VertexLoaderBase::CreateVertexLoader(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
+        loader = s_vertex_loader_map[uid].get();
+        RecordLoaderUID(uid, state->vtx_desc, state->vtx_attr[vtx_attr_group]);
+      }
+      if (check_for_native_format)
+      {
+        // Every loader gets its native vertex format once, on the GPU thread, whichever thread
+        // created it. Count it here, as statistics are only updated by the GPU thread.
+        INCSTAT(stats.numVertexLoaders);
+
+        // search for a cached native vertex format
+        const PortableVertexDeclaration& format = loader->m_native_vtx_decl;
+        std::unique_ptr<NativeVertexFormat>& native = s_native_vertex_map[format];
+        if (!native)
+        {
+          native = g_vertex_manager->CreateNativeVertexFormat(format);
+        }
+        loader->m_native_vertex_format = native.get();
+      }
+      cache->entries[uid.GetHash() % LOADER_CACHE_SIZE] = {uid, loader};
     }
     state->vertex_loaders[vtx_attr_group] = loader;
     state->attr_dirty[vtx_attr_group] = false;
@@ -253,6 +467,9 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   if (!count)
     return 0;
 
+  PipelineProfiler::ScopedTimer profiler_timer(PipelineProfiler::Section::VertexLoading,
+                                               !is_preprocess);
+
   VertexLoaderBase* loader = RefreshLoader(vtx_attr_group, is_preprocess);
 
   int size = count * loader->m_VertexSize;
@@ -22,6 +22,11 @@ using NativeVertexFormatMap =
 void Init();
 void Clear();
 
+// Reads the vertex formats that the running game used in previous sessions, and starts
+// compiling their loaders in the background so that they are ready before the first draw that
+// needs them. The loaders of new vertex formats get added to the file until Clear() is called.
+void LoadVertexLoaderUIDCache();
+
 void MarkAllDirty();
 
 // Creates or obtains a pointer to a VertexFormat representing decl.
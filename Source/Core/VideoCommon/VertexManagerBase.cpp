@@ -16,14 +16,17 @@
 
 #include "Core/ConfigManager.h"
 
+#include "VideoCommon/AsyncRequests.h"
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/Debugger.h"
+#include "VideoCommon/EFBAccessCache.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/OpcodeDecoding.h"
 #include "VideoCommon/PerfQueryBase.h"
+#include "VideoCommon/PipelineProfiler.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/SamplerCommon.h"
@@ -274,6 +277,8 @@ void VertexManagerBase::Flush()
   if (m_is_flushed)
     return;
 
+  PipelineProfiler::ScopedTimer profiler_timer(PipelineProfiler::Section::VertexFlush);
+
   // loading a state will invalidate BP, so check for it
   g_video_backend->CheckInvalidState();
 
@@ -397,6 +402,8 @@ void VertexManagerBase::Flush()
     g_vertex_manager->vFlush();
     if (PerfQueryBase::ShouldEmulate())
       g_perf_query->DisableQuery(bpmem.zcontrol.early_ztest ? PQG_ZCOMP_ZCOMPLOC : PQG_ZCOMP);
+    EFBAccessCache::Invalidate();
+    AsyncRequests::GetInstance()->InvalidateBoundingBox();
   }
 
   GFX_DEBUGGER_PAUSE_AT(NEXT_FLUSH, true);
@@ -31,11 +31,14 @@
 #include "VideoCommon/BPStructs.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
+#include "VideoCommon/DisplayListCache.h"
+#include "VideoCommon/EFBAccessCache.h"
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OnScreenDisplay.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/PipelineProfiler.h"
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
@@ -80,6 +83,7 @@ void VideoBackendBase::Video_BeginField(u32 xfbAddr, u32 fbWidth, u32 fbStride,
   if (m_initialized && g_renderer && !g_ActiveConfig.bImmediateXFB)
   {
     Fifo::SyncGPU(Fifo::SyncGPUReason::Swap);
+    EFBAccessCache::FlushPokes();
 
     AsyncRequests::Event e;
     e.time = ticks;
@@ -102,28 +106,12 @@ u32 VideoBackendBase::Video_AccessEFB(EFBAccessType type, u32 x, u32 y, u32 Inpu
 
   if (type == EFBAccessType::PokeColor || type == EFBAccessType::PokeZ)
   {
-    AsyncRequests::Event e;
-    e.type = type == EFBAccessType::PokeColor ? AsyncRequests::Event::EFB_POKE_COLOR :
-                                                AsyncRequests::Event::EFB_POKE_Z;
-    e.time = 0;
-    e.efb_poke.data = InputData;
-    e.efb_poke.x = x;
-    e.efb_poke.y = y;
-    AsyncRequests::GetInstance()->PushEvent(e, false);
+    EFBAccessCache::Poke(type, x, y, InputData);
     return 0;
   }
   else
   {
-    AsyncRequests::Event e;
-    u32 result;
-    e.type = type == EFBAccessType::PeekColor ? AsyncRequests::Event::EFB_PEEK_COLOR :
-                                                AsyncRequests::Event::EFB_PEEK_Z;
-    e.time = 0;
-    e.efb_peek.x = x;
-    e.efb_peek.y = y;
-    e.efb_peek.data = &result;
-    AsyncRequests::GetInstance()->PushEvent(e, true);
-    return result;
+    return EFBAccessCache::Peek(type, x, y);
   }
 }
 
@@ -175,15 +163,7 @@ u16 VideoBackendBase::Video_GetBoundingBox(int index)
 
   Fifo::SyncGPU(Fifo::SyncGPUReason::BBox);
 
-  AsyncRequests::Event e;
-  u16 result;
-  e.time = 0;
-  e.type = AsyncRequests::Event::BBOX_READ;
-  e.bbox.index = index;
-  e.bbox.data = &result;
-  AsyncRequests::GetInstance()->PushEvent(e, true);
-
-  return result;
+  return AsyncRequests::GetInstance()->ReadBoundingBox(index);
 }
 
 void VideoBackendBase::PopulateList()
@@ -254,6 +234,9 @@ void VideoBackendBase::DoState(PointerWrap& p)
     // Clear all caches that touch RAM
     // (? these don't appear to touch any emulation state that gets saved. moved to on load only.)
     VertexLoaderManager::MarkAllDirty();
+    EFBAccessCache::Reset();
+    DisplayListCache::Clear();
+    AsyncRequests::GetInstance()->ResetBoundingBox();
   }
 }
 
@@ -289,6 +272,9 @@ void VideoBackendBase::InitializeShared()
   PixelEngine::Init();
   BPInit();
   VertexLoaderManager::Init();
+  EFBAccessCache::Init();
+  DisplayListCache::Init();
+  AsyncRequests::GetInstance()->ResetStatistics();
   IndexGenerator::Init();
   VertexShaderManager::Init();
   GeometryShaderManager::Init();
@@ -297,6 +283,11 @@ void VideoBackendBase::InitializeShared()
   g_Config.Refresh();
   g_Config.UpdateProjectionHack();
   UpdateActiveConfig();
+
+  if (g_ActiveConfig.bShaderCache)
+    VertexLoaderManager::LoadVertexLoaderUIDCache();
+
+  PipelineProfiler::Init();
 }
 
 void VideoBackendBase::ShutdownShared()
@@ -308,4 +299,5 @@ void VideoBackendBase::ShutdownShared()
 
   VertexLoaderManager::Clear();
   Fifo::Shutdown();
+  PipelineProfiler::Shutdown();
 }
@@ -92,6 +92,7 @@ struct VideoConfig final
   bool bTexFmtOverlayEnable;
   bool bTexFmtOverlayCenter;
   bool bLogRenderTimeToFile;
+  bool bProfileVideoPipeline;
 
   // Render
   bool bWireFrame;
@@ -178,6 +179,9 @@ struct VideoConfig final
   int iShaderCompilerThreads;
   int iShaderPrecompilerThreads;
 
+  // Replay display lists from a decoded copy when they are called again with the same contents.
+  bool bDisplayListCache;
+
   // Static config per API
   // TODO: Move this out of VideoConfig
   struct
@@ -219,6 +223,9 @@ struct VideoConfig final
     bool bSupportsBPTCTextures;
     bool bSupportsFramebufferFetch;  // Used as an alternative to dual-source blend on GLES
     bool bSupportsBackgroundCompiling;
+    // AccessEFB() reads back a region of the EFB and answers later peeks in it from memory, so a
+    // tile of pixels costs about as much as one.
+    bool bSupportsEFBPeekCache;
   } backend_info;
 
   // Utility
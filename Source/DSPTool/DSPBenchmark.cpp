@@ -0,0 +1,320 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "DSPBenchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Common/MemoryUtil.h"
+#include "Common/Swap.h"
+#include "Common/Timer.h"
+#include "Core/DSP/DSPAnalyzer.h"
+#include "Core/DSP/DSPCaptureLogger.h"
+#include "Core/DSP/DSPCodeUtil.h"
+#include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPHWInterface.h"
+#include "Core/DSP/DSPTables.h"
+
+namespace
+{
+// The DMAs access the main memory through g_dsp.cpu_ram, which has to cover MEM1 and the MEM2
+// of the Wii at 0x10000000. Only the pages that the replayed DMAs touch get backed by memory.
+constexpr u32 RAM_SIZE = 0x14000000;
+
+// Cycles run between two checks of the mailboxes.
+constexpr int SLICE_CYCLES = 5000;
+// Cycles that the DSP is given to handle the last mail of the trace.
+constexpr u64 DRAIN_CYCLES = 1000000;
+// The replay is considered stuck if the DSP doesn't read a mail for that long.
+constexpr u64 STALL_CYCLES = 1000000000;
+
+struct CoreResult
+{
+  u64 cycles = 0;
+  double seconds = 0;
+  bool stalled = false;
+  // DMAs from the main memory that didn't match the next one of the trace.
+  u32 mismatched_dmas = 0;
+  // Hash of the DMAs to the main memory and of the mails to the CPU.
+  u64 output_hash = 0;
+  std::array<u16, 32> registers;
+  std::vector<u16> dram;
+
+  void AddOutput(const void* data, size_t size)
+  {
+    output_hash = output_hash * 0x100000001b3 ^ HashAdler32(static_cast<const u8*>(data), size);
+  }
+};
+
+// Puts the data of the DMAs of the trace back in the main memory right before the DSP copies it,
+// and hashes the data that the DSP sends back.
+class ReplayLogger final : public DSP::DefaultDSPCaptureLogger
+{
+public:
+  ReplayLogger(const DSP::DSPCaptureTrace& trace, u8* ram, CoreResult* result)
+      : m_trace(trace), m_ram(ram), m_result(result)
+  {
+  }
+
+  void LogIFXWrite(u16 address, u16 written_value) override
+  {
+    // Writing the length starts the DMA, and this is called before it is done.
+    if ((address & 0xff) != DSP::DSP_DSBL ||
+        (DSP::g_dsp.ifx_regs[DSP::DSP_DSCR] & DSP::DSP_CR_TO_CPU))
+    {
+      return;
+    }
+
+    if (m_next_dma == m_trace.dmas_from_cpu.size())
+    {
+      ++m_result->mismatched_dmas;
+      return;
+    }
+
+    const DSP::CapturedDMA& dma = m_trace.dmas_from_cpu[m_next_dma++];
+    const u32 gc_address =
+        static_cast<u32>(DSP::g_dsp.ifx_regs[DSP::DSP_DSMAH]) << 16 |
+        DSP::g_dsp.ifx_regs[DSP::DSP_DSMAL];
+    const u32 offset = gc_address & (dma.control & DSP::DSP_CR_IMEM ? 0x0fffffff : 0x7fffffff);
+    if (dma.gc_address != gc_address || dma.data.size() != written_value ||
+        offset + dma.data.size() > RAM_SIZE)
+    {
+      ++m_result->mismatched_dmas;
+      return;
+    }
+
+    for (size_t i = 0; i + 1 < dma.data.size(); i += 2)
+    {
+      u16 value;
+      std::memcpy(&value, &dma.data[i], sizeof(value));
+      value = Common::swap16(value);
+      std::memcpy(&m_ram[offset + i], &value, sizeof(value));
+    }
+  }
+
+  void LogDMA(u16 control, u32 gc_address, u16 dsp_address, u16 length, const u8* data) override
+  {
+    if (control & DSP::DSP_CR_TO_CPU)
+      m_result->AddOutput(data, length);
+  }
+
+private:
+  const DSP::DSPCaptureTrace& m_trace;
+  size_t m_next_dma = 0;
+  u8* m_ram;
+  CoreResult* m_result;
+};
+
+template <size_t N>
+bool LoadRom(const std::string& path, std::array<u16, N>* rom)
+{
+  if (path.empty())
+  {
+    rom->fill(0);
+    return true;
+  }
+
+  std::string bytes;
+  std::vector<u16> code;
+  if (!File::ReadFileToString(path, bytes))
+    return false;
+  DSP::BinaryStringBEToCode(bytes, code);
+  if (code.size() != rom->size())
+  {
+    printf("ERROR: %s has a wrong size (%zu, expected %zu)\n", path.c_str(), bytes.size(),
+           rom->size() * sizeof(u16));
+    return false;
+  }
+
+  std::copy(code.begin(), code.end(), rom->begin());
+  return true;
+}
+
+std::optional<CoreResult> RunCore(DSP::DSPInitOptions init_options,
+                                  const DSPBenchmarkOptions& options,
+                                  const DSP::DSPCaptureTrace& trace, u8* ram)
+{
+  CoreResult result;
+  init_options.capture_logger = new ReplayLogger(trace, ram, &result);
+  if (!DSP::DSPCore_Init(init_options))
+    return std::nullopt;
+
+  const size_t ucode_size = std::min<size_t>(options.ucode.size(), DSP::DSP_IRAM_SIZE);
+  Common::UnWriteProtectMemory(DSP::g_dsp.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+  std::copy(options.ucode.begin(), options.ucode.begin() + ucode_size, DSP::g_dsp.iram);
+  Common::WriteProtectMemory(DSP::g_dsp.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+  // Nothing was compiled yet, so only the analysis needs to be updated.
+  DSP::Analyzer::Analyze();
+
+  DSP::g_dsp.cpu_ram = ram;
+  DSP::g_dsp.pc = options.entry_point;
+  // The DSP is held in halt until the CPU lets it run.
+  DSP::g_dsp.cr &= ~DSP::CR_HALT;
+
+  size_t next_mail = 0;
+  u64 cycles_since_mail = 0;
+  const u64 start = Common::Timer::GetTimeUs();
+  while (!(DSP::g_dsp.cr & DSP::CR_HALT))
+  {
+    // Send the next mail once the DSP has read the previous one.
+    const bool mail_pending = (DSP::gdsp_mbox_peek(DSP::MAILBOX_CPU) & 0x80000000) != 0;
+    if (!mail_pending && next_mail < trace.cpu_mails.size())
+    {
+      DSP::gdsp_mbox_write_h(DSP::MAILBOX_CPU, trace.cpu_mails[next_mail] >> 16);
+      DSP::gdsp_mbox_write_l(DSP::MAILBOX_CPU, trace.cpu_mails[next_mail] & 0xffff);
+      ++next_mail;
+      cycles_since_mail = 0;
+    }
+    else if (!mail_pending && cycles_since_mail >= DRAIN_CYCLES)
+    {
+      break;
+    }
+    else if (cycles_since_mail >= STALL_CYCLES)
+    {
+      result.stalled = true;
+      break;
+    }
+
+    // The JIT counts the cycles on 16 bits and can overrun the slice.
+    const int cycles_left = static_cast<s16>(DSP::DSPCore_RunCycles(SLICE_CYCLES));
+    const u64 cycles = SLICE_CYCLES - std::min(cycles_left, SLICE_CYCLES);
+    result.cycles += cycles;
+    cycles_since_mail += cycles;
+
+    // Read the mails of the DSP like the CPU would.
+    const u32 dsp_mail = DSP::gdsp_mbox_peek(DSP::MAILBOX_DSP);
+    if (dsp_mail & 0x80000000)
+    {
+      DSP::gdsp_mbox_read_l(DSP::MAILBOX_DSP);
+      result.AddOutput(&dsp_mail, sizeof(dsp_mail));
+    }
+  }
+  result.seconds = (Common::Timer::GetTimeUs() - start) / 1000000.0;
+
+  for (size_t reg = 0; reg < result.registers.size(); ++reg)
+    result.registers[reg] = DSP::DSPCore_ReadRegister(reg);
+  result.dram.assign(DSP::g_dsp.dram, DSP::g_dsp.dram + DSP::DSP_DRAM_SIZE);
+
+  DSP::DSPCore_Shutdown();
+  return result;
+}
+
+void PrintResult(const char* name, const CoreResult& result)
+{
+  printf("%-12s %" PRIu64 " cycles in %.3f s: %.2f Mcycles/s\n", name, result.cycles,
+         result.seconds, result.seconds > 0 ? result.cycles / result.seconds / 1000000 : 0.0);
+  if (result.stalled)
+    printf("%-12s stopped reading mails before the end of the trace\n", "");
+  if (result.mismatched_dmas)
+    printf("%-12s %u DMAs didn't match the trace\n", "", result.mismatched_dmas);
+}
+}  // namespace
+
+bool RunDSPBenchmark(const DSPBenchmarkOptions& options)
+{
+  const std::optional<DSP::DSPCaptureTrace> trace = DSP::ReadDSPCaptureTrace(options.trace_path);
+  if (!trace)
+  {
+    printf("ERROR: Could not read the capture %s\n", options.trace_path.c_str());
+    return false;
+  }
+  printf("Trace: %zu mails and %zu DMAs from the CPU\n", trace->cpu_mails.size(),
+         trace->dmas_from_cpu.size());
+
+  DSP::DSPInitOptions init_options;
+  if (!LoadRom(options.irom_path, &init_options.irom_contents) ||
+      !LoadRom(options.coef_path, &init_options.coef_contents))
+  {
+    return false;
+  }
+
+  DSP::InitInstructionTable();
+  // Each core gets main memory of its own, so that both start from the same state.
+  const auto run_core = [&](DSP::DSPInitOptions::CoreType core_type) {
+    init_options.core_type = core_type;
+    u8* const ram = static_cast<u8*>(Common::AllocateMemoryPages(RAM_SIZE));
+    const std::optional<CoreResult> result = RunCore(init_options, options, *trace, ram);
+    Common::FreeMemoryPages(ram, RAM_SIZE);
+    return result;
+  };
+
+  const std::optional<CoreResult> interpreter =
+      run_core(DSP::DSPInitOptions::CORE_INTERPRETER);
+  if (interpreter)
+    PrintResult("Interpreter:", *interpreter);
+
+#ifdef _M_X86
+  const std::optional<CoreResult> jit = run_core(DSP::DSPInitOptions::CORE_JIT);
+  if (jit)
+    PrintResult("JIT:", *jit);
+#else
+  const std::optional<CoreResult> jit = interpreter;
+#endif
+
+  if (!interpreter || !jit)
+  {
+    printf("ERROR: Could not initialize the DSP\n");
+    return false;
+  }
+
+#ifdef _M_X86
+  // Idle loops are skipped differently by the two cores, so compare the time taken by the
+  // whole trace rather than the cycle rates.
+  if (jit->seconds > 0)
+    printf("The JIT replayed the trace %.2fx as fast as the interpreter\n",
+           interpreter->seconds / jit->seconds);
+#endif
+
+  bool registers_match = true;
+  for (size_t reg = 0; reg < interpreter->registers.size(); ++reg)
+  {
+    if (interpreter->registers[reg] != jit->registers[reg])
+    {
+      printf("Register %s: %04x with the interpreter, %04x with the JIT\n",
+             DSP::pdregname(static_cast<int>(reg)), interpreter->registers[reg],
+             jit->registers[reg]);
+      registers_match = false;
+    }
+  }
+  const bool dram_match = interpreter->dram == jit->dram;
+  const bool output_match = interpreter->output_hash == jit->output_hash;
+  if (registers_match && dram_match && output_match)
+  {
+    printf("Final state: identical (output hash %016" PRIx64 ")\n", interpreter->output_hash);
+    return true;
+  }
+
+  // HALT pops the call stack with the JIT but not with the interpreter, and the JIT skips the
+  // flags that the analyzer finds to be overwritten before being read. Differences in those are
+  // reported above, but are expected.
+  std::array<u16, 32> interpreter_registers = interpreter->registers;
+  std::array<u16, 32> jit_registers = jit->registers;
+  for (std::array<u16, 32>* registers : {&interpreter_registers, &jit_registers})
+  {
+    (*registers)[DSP::DSP_REG_ST0] = 0;
+    (*registers)[DSP::DSP_REG_SR] &= ~DSP::SR_CMP_MASK;
+  }
+  const bool known_differences_only = interpreter_registers == jit_registers;
+  if (known_differences_only && dram_match && output_match)
+  {
+    printf("Final state: identical apart from the call stack and comparison flags (output hash "
+           "%016" PRIx64 ")\n",
+           interpreter->output_hash);
+    return true;
+  }
+
+  printf("Final state: MISMATCH in%s%s%s\n", known_differences_only ? "" : " registers",
+         dram_match ? "" : " DRAM", output_match ? "" : " output");
+  return false;
+}
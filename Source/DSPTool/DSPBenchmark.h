@@ -0,0 +1,26 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+struct DSPBenchmarkOptions
+{
+  std::vector<u16> ucode;
+  u16 entry_point = 0;
+  // Capture written by the DSP LLE capture logger while the ucode was running.
+  std::string trace_path;
+  // The ROMs are filled with zeros if these are empty.
+  std::string irom_path;
+  std::string coef_path;
+};
+
+// Replays the mails and DMAs that the CPU sent during a capture on the given ucode, with the
+// DSP interpreter and with the DSP JIT, and reports how many cycles per second each core ran.
+// Returns false if the files couldn't be loaded or if the cores didn't end up in the same state.
+bool RunDSPBenchmark(const DSPBenchmarkOptions& options);
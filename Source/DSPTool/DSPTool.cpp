@@ -5,10 +5,15 @@
 #include "Common/Common.h"
 #include "Common/FileUtil.h"
 #include "Common/StringUtil.h"
+#include "Core/DSP/DSPAnalyzer.h"
 #include "Core/DSP/DSPCodeUtil.h"
+#include "Core/DSP/DSPCore.h"
 #include "Core/DSP/DSPDisassembler.h"
 #include "Core/DSP/DSPHost.h"
 #include "Core/DSP/DSPTables.h"
+#include "Core/DSP/Jit/x64/DSPEmitter.h"
+
+#include "DSPBenchmark.h"
 
 // Stub out the dsplib host stuff, since this is just a simple cmdline tools.
 u8 DSP::Host::ReadHostMemory(u32 addr)
@@ -31,6 +36,10 @@ bool DSP::Host::IsWiiHost()
 }
 void DSP::Host::CodeLoaded(const u8* ptr, int size)
 {
+  // The benchmark replays the uploads of new ucodes.
+  if (g_dsp_jit)
+    g_dsp_jit->ClearIRAM();
+  Analyzer::Analyze();
 }
 void DSP::Host::InterruptRequest()
 {
@@ -123,12 +132,16 @@ static void CodesToHeader(const std::vector<u16>* codes, const std::vector<std::
 //   dsptool [-f] -h asdf.h asdf.txt
 // Print results from DSPSpy register dump
 //   dsptool -p dsp_dump0.bin
+// Replay a DSP capture on a ucode with the interpreter and the JIT
+//   dsptool -b dsp.pcap [-e 0010] [-irom dsp_rom.bin] [-coef dsp_coef.bin] ucode.bin
 int main(int argc, const char* argv[])
 {
   if (argc == 1 || (argc == 2 && (!strcmp(argv[1], "--help") || (!strcmp(argv[1], "-?")))))
   {
     printf("USAGE: DSPTool [-?] [--help] [-f] [-d] [-m] [-p <FILE>] [-o <FILE>] [-h <FILE>] <DSP "
            "ASSEMBLER FILE>\n");
+    printf("       DSPTool -b <CAPTURE FILE> [-e <ADDRESS>] [-irom <FILE>] [-coef <FILE>] <DSP "
+           "UCODE FILE>\n");
     printf("-? / --help: Prints this message\n");
     printf("-d: Disassemble\n");
     printf("-m: Input file contains a list of files (Header assembly only)\n");
@@ -141,6 +154,10 @@ int main(int argc, const char* argv[])
     printf("-pm <DUMP FILE>: Print results of DSPSpy register dump (convert PROD values)\n");
     printf("-psm <DUMP FILE>: Print results of DSPSpy register dump (convert PROD values/disable "
            "SR output)\n");
+    printf("-b <CAPTURE FILE>: Replay a DSP LLE capture on the ucode with the interpreter and the "
+           "JIT, and compare their speed and final state\n");
+    printf("-e <ADDRESS>: Entry point of the ucode in hexadecimal (benchmark only)\n");
+    printf("-irom <FILE>, -coef <FILE>: DSP ROMs (benchmark only, zero-filled by default)\n");
 
     return 0;
   }
@@ -148,11 +165,26 @@ int main(int argc, const char* argv[])
   std::string input_name;
   std::string output_header_name;
   std::string output_name;
+  DSPBenchmarkOptions benchmark_options;
 
   bool disassemble = false, compare = false, multiple = false, outputSize = false, force = false,
-       print_results = false, print_results_prodhack = false, print_results_srhack = false;
+       print_results = false, print_results_prodhack = false, print_results_srhack = false,
+       benchmark = false;
+  static const char* const options_with_argument[] = {"-o", "-h", "-b", "-e", "-irom", "-coef"};
   for (int i = 1; i < argc; i++)
   {
+    if (i + 1 == argc)
+    {
+      for (const char* option : options_with_argument)
+      {
+        if (!strcmp(argv[i], option))
+        {
+          printf("ERROR: %s needs an argument.\n", option);
+          return 1;
+        }
+      }
+    }
+
     if (!strcmp(argv[i], "-d"))
       disassemble = true;
     else if (!strcmp(argv[i], "-o"))
@@ -185,6 +217,17 @@ int main(int argc, const char* argv[])
       print_results_srhack = true;
       print_results_prodhack = true;
     }
+    else if (!strcmp(argv[i], "-b"))
+    {
+      benchmark = true;
+      benchmark_options.trace_path = argv[++i];
+    }
+    else if (!strcmp(argv[i], "-e"))
+      benchmark_options.entry_point = static_cast<u16>(strtoul(argv[++i], nullptr, 16));
+    else if (!strcmp(argv[i], "-irom"))
+      benchmark_options.irom_path = argv[++i];
+    else if (!strcmp(argv[i], "-coef"))
+      benchmark_options.coef_path = argv[++i];
     else
     {
       if (!input_name.empty())
@@ -221,6 +264,19 @@ int main(int argc, const char* argv[])
     return 0;
   }
 
+  if (benchmark)
+  {
+    if (input_name.empty())
+    {
+      printf("Benchmark: Must specify a ucode.\n");
+      return 1;
+    }
+    std::string binary_code;
+    File::ReadFileToString(input_name, binary_code);
+    DSP::BinaryStringBEToCode(binary_code, benchmark_options.ucode);
+    return RunDSPBenchmark(benchmark_options) ? 0 : 1;
+  }
+
   if (print_results)
   {
     std::string dumpfile, results;
@@ -0,0 +1,315 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AudioCommon/Mixer.h"
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/MathUtil.h"
+#include "Common/Swap.h"
+#include "Common/Timer.h"
+#include "Core/ConfigManager.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr unsigned int OUTPUT_SAMPLE_RATE = 48000;
+constexpr unsigned int DMA_SAMPLE_RATE = 32000;
+
+// The scalar linear interpolation that the mixer did before it got vectorized, reading from a
+// FIFO that holds all of the big endian stereo input.
+class ReferenceResampler
+{
+public:
+  explicit ReferenceResampler(const std::vector<short>& input) : m_input(input) {}
+  void Mix(short* samples, unsigned int num_samples, u32 ratio, s32 volume)
+  {
+    const u32 frames = static_cast<u32>(m_input.size() / 2);
+    unsigned int i = 0;
+    for (; i < num_samples && frames - m_index >= 2; ++i)
+    {
+      const s16 l1 = Common::swap16(m_input[m_index * 2]);
+      const s16 l2 = Common::swap16(m_input[m_index * 2 + 2]);
+      const s16 r1 = Common::swap16(m_input[m_index * 2 + 1]);
+      const s16 r2 = Common::swap16(m_input[m_index * 2 + 3]);
+      const s32 left = ((l1 << 16) + (l2 - l1) * static_cast<s32>(m_frac)) >> 16;
+      const s32 right = ((r1 << 16) + (r2 - r1) * static_cast<s32>(m_frac)) >> 16;
+      samples[i * 2] = MathUtil::Clamp(samples[i * 2] + ((right * volume) >> 8), -32767, 32767);
+      samples[i * 2 + 1] =
+          MathUtil::Clamp(samples[i * 2 + 1] + ((left * volume) >> 8), -32767, 32767);
+
+      m_frac += ratio;
+      m_index += m_frac >> 16;
+      m_frac &= 0xffff;
+    }
+
+    const s16 last_right = m_index ? Common::swap16(m_input[m_index * 2 - 1]) : 0;
+    const s16 last_left = m_index ? Common::swap16(m_input[m_index * 2 - 2]) : 0;
+    for (; i < num_samples; ++i)
+    {
+      samples[i * 2] =
+          MathUtil::Clamp(samples[i * 2] + ((last_right * volume) >> 8), -32767, 32767);
+      samples[i * 2 + 1] =
+          MathUtil::Clamp(samples[i * 2 + 1] + ((last_left * volume) >> 8), -32767, 32767);
+    }
+  }
+
+private:
+  const std::vector<short>& m_input;
+  u32 m_index = 0;
+  u32 m_frac = 0;
+};
+
+std::vector<short> GenerateNoise(size_t frames, u32 seed)
+{
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<int> distribution(-32768, 32767);
+  std::vector<short> samples(frames * 2);
+  for (short& sample : samples)
+    sample = Common::swap16(static_cast<u16>(distribution(generator)));
+  return samples;
+}
+
+std::vector<short> GenerateSine(size_t frames, double frequency, double amplitude)
+{
+  std::vector<short> samples(frames * 2);
+  for (size_t i = 0; i < frames; ++i)
+  {
+    const short value = static_cast<short>(
+        std::lround(amplitude * std::sin(2 * 3.14159265358979323846 * frequency * i /
+                                         DMA_SAMPLE_RATE)));
+    samples[i * 2] = Common::swap16(value);
+    samples[i * 2 + 1] = Common::swap16(static_cast<short>(-value));
+  }
+  return samples;
+}
+}  // namespace
+
+class MixerTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    // Resample at the nominal rates rather than following the fill level of the FIFOs.
+    SConfig::GetInstance().m_EmulationSpeed = 0.0f;
+    SConfig::GetInstance().m_audio_stretch = false;
+    SConfig::GetInstance().m_audio_polyphase_resampling = false;
+  }
+
+  void TearDown() override
+  {
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  std::string m_profile_path;
+};
+
+TEST_F(MixerTest, LinearMatchesScalarReference)
+{
+  const std::vector<short> input = GenerateNoise(3000, 1234);
+  Mixer mixer(OUTPUT_SAMPLE_RATE);
+  mixer.PushSamples(input.data(), static_cast<unsigned int>(input.size() / 2));
+  ReferenceResampler reference(input);
+  const u32 ratio = 65536 * DMA_SAMPLE_RATE / OUTPUT_SAMPLE_RATE;
+
+  // Odd sizes to exercise the tails of the vectorized loops, until well into the padding.
+  for (unsigned int chunk : {1u, 3u, 7u, 128u, 509u, 1000u, 2000u, 1000u})
+  {
+    std::vector<short> mixed(chunk * 2);
+    std::vector<short> expected(chunk * 2, 0);
+    mixer.Mix(mixed.data(), chunk);
+    reference.Mix(expected.data(), chunk, ratio, 256);
+    ASSERT_EQ(expected, mixed) << "chunk of " << chunk << " samples";
+  }
+}
+
+TEST_F(MixerTest, PolyphaseKeepsConstantSignal)
+{
+  SConfig::GetInstance().m_audio_polyphase_resampling = true;
+
+  std::vector<short> input(1000 * 2);
+  for (size_t i = 0; i < input.size(); i += 2)
+  {
+    input[i] = Common::swap16(static_cast<u16>(12345));
+    input[i + 1] = Common::swap16(static_cast<u16>(-20000));
+  }
+  Mixer mixer(OUTPUT_SAMPLE_RATE);
+  mixer.PushSamples(input.data(), static_cast<unsigned int>(input.size() / 2));
+
+  std::vector<short> mixed(1400 * 2);
+  mixer.Mix(mixed.data(), 1400);
+  for (size_t i = 0; i < mixed.size(); i += 2)
+  {
+    ASSERT_EQ(-20000, mixed[i]) << "sample " << i / 2;
+    ASSERT_EQ(12345, mixed[i + 1]) << "sample " << i / 2;
+  }
+}
+
+TEST_F(MixerTest, PolyphaseFollowsSine)
+{
+  SConfig::GetInstance().m_audio_polyphase_resampling = true;
+
+  constexpr double frequency = 5000.0;
+  constexpr double amplitude = 16000.0;
+  const std::vector<short> input = GenerateSine(3000, frequency, amplitude);
+  Mixer mixer(OUTPUT_SAMPLE_RATE);
+  mixer.PushSamples(input.data(), static_cast<unsigned int>(input.size() / 2));
+
+  constexpr unsigned int output_samples = 4000;
+  std::vector<short> mixed(output_samples * 2);
+  ASSERT_EQ(output_samples, mixer.Mix(mixed.data(), output_samples));
+
+  // The filter is centered between its fourth and fifth taps, which delays the output by three
+  // input samples.
+  const u32 ratio = 65536 * DMA_SAMPLE_RATE / OUTPUT_SAMPLE_RATE;
+  double max_error = 0.0;
+  for (unsigned int i = 0; i < output_samples; ++i)
+  {
+    const double position = static_cast<double>(i) * ratio / 65536 + 3;
+    const double expected =
+        amplitude * std::sin(2 * 3.14159265358979323846 * frequency * position / DMA_SAMPLE_RATE);
+    max_error = std::max(max_error, std::abs(mixed[i * 2 + 1] - expected));
+    max_error = std::max(max_error, std::abs(mixed[i * 2] + expected));
+  }
+  EXPECT_LT(max_error, amplitude / 100);
+}
+
+TEST_F(MixerTest, RampsVolumeChanges)
+{
+  // The streaming FIFO runs at the output rate, so each output sample is an input sample.
+  constexpr s32 value = 16000;
+  std::vector<short> input(3000 * 2);
+  for (size_t i = 0; i < input.size(); i += 2)
+  {
+    input[i] = Common::swap16(static_cast<u16>(value));
+    input[i + 1] = Common::swap16(static_cast<u16>(-value));
+  }
+  Mixer mixer(OUTPUT_SAMPLE_RATE);
+  mixer.PushStreamingSamples(input.data(), 3000);
+
+  constexpr unsigned int chunk = 1000;
+  std::vector<short> mixed(chunk * 2);
+  mixer.Mix(mixed.data(), chunk);
+  EXPECT_EQ(value, mixed[chunk * 2 - 1]);
+
+  // Muting fades the samples out over the next call instead of cutting them off.
+  mixer.SetStreamingVolume(0, 0);
+  std::fill(mixed.begin(), mixed.end(), 0);
+  mixer.Mix(mixed.data(), chunk);
+  // The volume has 256 steps, which are spread over the call.
+  const s32 max_step = value / 256 + 1;
+  EXPECT_GE(mixed[1], value - max_step);
+  for (unsigned int i = 1; i < chunk; ++i)
+  {
+    ASSERT_LE(mixed[i * 2 + 1], mixed[i * 2 - 1]) << "sample " << i;
+    ASSERT_LE(mixed[i * 2 - 1] - mixed[i * 2 + 1], max_step) << "sample " << i;
+    ASSERT_NEAR(-mixed[i * 2 + 1], mixed[i * 2], 1) << "sample " << i;
+  }
+  EXPECT_EQ(0, mixed[chunk * 2 - 1]);
+
+  // The next call starts at the new volume.
+  std::fill(mixed.begin(), mixed.end(), 0);
+  mixer.Mix(mixed.data(), chunk);
+  EXPECT_TRUE(std::all_of(mixed.begin(), mixed.end(), [](short sample) { return sample == 0; }));
+}
+
+TEST_F(MixerTest, Statistics)
+{
+  Mixer mixer(OUTPUT_SAMPLE_RATE);
+  const std::vector<short> input = GenerateNoise(3000, 5);
+  std::vector<short> mixed(2000 * 2);
+
+  mixer.PushSamples(input.data(), 3000);
+  // The FIFO only has room for 4096 samples.
+  mixer.PushSamples(input.data(), 2000);
+  mixer.Mix(mixed.data(), 2000);
+  EXPECT_EQ(0u, mixer.GetStatistics().dma.underruns);
+  EXPECT_EQ(1u, mixer.GetStatistics().dma.overruns);
+  // 3000 samples at 32 kHz were buffered.
+  EXPECT_NEAR(93.75, mixer.GetStatistics().dma.average_latency_ms, 0.01);
+
+  // This runs out of samples, but running idle afterwards isn't an underrun.
+  mixer.Mix(mixed.data(), 2000);
+  mixer.Mix(mixed.data(), 2000);
+  EXPECT_EQ(1u, mixer.GetStatistics().dma.underruns);
+
+  // The other FIFOs never played.
+  EXPECT_EQ(0u, mixer.GetStatistics().streaming.underruns);
+  EXPECT_EQ(0u, mixer.GetStatistics().wiimote_speaker.underruns);
+}
+
+TEST_F(MixerTest, Throughput)
+{
+  // Each round mixes 2000 samples of the three kinds of input. A bit more input than that gets
+  // pushed so that the FIFOs stay full and the mixer never has to pad.
+  constexpr unsigned int output_samples = 2000;
+  constexpr unsigned int wiimote_sample_rate = 3000;
+  constexpr unsigned int dma_samples = output_samples * DMA_SAMPLE_RATE / OUTPUT_SAMPLE_RATE + 16;
+  constexpr unsigned int streaming_samples = output_samples + 16;
+  constexpr unsigned int wiimote_samples =
+      output_samples * wiimote_sample_rate / OUTPUT_SAMPLE_RATE + 16;
+  constexpr int rounds = 20000;
+  const std::vector<short> dma_input = GenerateNoise(dma_samples, 1);
+  const std::vector<short> streaming_input = GenerateNoise(streaming_samples, 2);
+  const std::vector<short> wiimote_input = GenerateNoise(wiimote_samples, 3);
+  std::vector<short> mixed(output_samples * 2);
+
+  const auto measure = [&](bool polyphase) {
+    SConfig::GetInstance().m_audio_polyphase_resampling = polyphase;
+    auto mixer = std::make_unique<Mixer>(OUTPUT_SAMPLE_RATE);
+    u64 elapsed = 0;
+    for (int round = 0; round < rounds; ++round)
+    {
+      mixer->PushSamples(dma_input.data(), dma_samples);
+      mixer->PushStreamingSamples(streaming_input.data(), streaming_samples);
+      mixer->PushWiimoteSpeakerSamples(wiimote_input.data(), wiimote_samples,
+                                       wiimote_sample_rate);
+      const u64 start = Common::Timer::GetTimeUs();
+      mixer->Mix(mixed.data(), output_samples);
+      elapsed += Common::Timer::GetTimeUs() - start;
+    }
+    return static_cast<double>(output_samples) * rounds / std::max<u64>(elapsed, 1);
+  };
+
+  // The scalar loop that the mixer used to run on each FIFO, as a baseline.
+  const auto measure_reference = [&] {
+    const u64 start = Common::Timer::GetTimeUs();
+    for (int round = 0; round < rounds; ++round)
+    {
+      ReferenceResampler dma(dma_input);
+      ReferenceResampler streaming(streaming_input);
+      ReferenceResampler wiimote(wiimote_input);
+      std::fill(mixed.begin(), mixed.end(), 0);
+      dma.Mix(mixed.data(), output_samples, 65536 * DMA_SAMPLE_RATE / OUTPUT_SAMPLE_RATE, 256);
+      streaming.Mix(mixed.data(), output_samples, 65536, 256);
+      wiimote.Mix(mixed.data(), output_samples, 65536 * wiimote_sample_rate / OUTPUT_SAMPLE_RATE,
+                  256);
+    }
+    return static_cast<double>(output_samples) * rounds /
+           std::max<u64>(Common::Timer::GetTimeUs() - start, 1);
+  };
+
+  const double scalar = measure_reference();
+  const double linear = measure(false);
+  const double polyphase = measure(true);
+
+  printf("Scalar reference: %.1f M stereo samples/s, linear: %.1f M/s, polyphase: %.1f M/s\n",
+         scalar, linear, polyphase);
+}
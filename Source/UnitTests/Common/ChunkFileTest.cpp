@@ -0,0 +1,96 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+
+namespace
+{
+struct TestState
+{
+  u32 value = 0x12345678;
+  std::string name = "Dolphin";
+  std::map<u32, u64> map = {{1, 2}, {3, 4}};
+  std::vector<u8> memory = std::vector<u8>(3 * 1024 * 1024, 0xAB);
+
+  void DoState(PointerWrap& p)
+  {
+    p.Do(value);
+    p.Do(name);
+    p.Do(map);
+    p.DoArray(memory.data(), static_cast<u32>(memory.size()));
+    p.DoMarker("TestState");
+  }
+};
+}  // namespace
+
+static std::vector<u8> MeasureAndWrite(TestState& state)
+{
+  u8* ptr = nullptr;
+  PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+  state.DoState(p);
+
+  std::vector<u8> buffer(reinterpret_cast<size_t>(ptr));
+  ptr = buffer.data();
+  p.SetMode(PointerWrap::MODE_WRITE);
+  state.DoState(p);
+  return buffer;
+}
+
+TEST(PointerWrap, GrowableWriteMatchesMeasuredWrite)
+{
+  TestState state;
+  const std::vector<u8> expected = MeasureAndWrite(state);
+
+  std::vector<u8> buffer;
+  PointerWrap p(&buffer);
+  state.DoState(p);
+  EXPECT_EQ(expected.size(), p.FinishWrite());
+  EXPECT_EQ(expected, buffer);
+}
+
+TEST(PointerWrap, GrowableWriteReusesBuffer)
+{
+  TestState state;
+  std::vector<u8> buffer(16 * 1024 * 1024, 0xFF);
+  const u8* const data = buffer.data();
+
+  PointerWrap p(&buffer);
+  state.DoState(p);
+  p.FinishWrite();
+
+  // The buffer was large enough, so it must not have been reallocated.
+  EXPECT_EQ(data, buffer.data());
+  EXPECT_EQ(MeasureAndWrite(state), buffer);
+}
+
+TEST(PointerWrap, GrowableWriteRoundTrip)
+{
+  TestState state;
+  state.value = 42;
+  state.name = "Wii";
+  state.memory.assign(state.memory.size(), 0x55);
+
+  std::vector<u8> buffer;
+  PointerWrap writer(&buffer);
+  state.DoState(writer);
+  writer.FinishWrite();
+
+  TestState loaded;
+  u8* ptr = buffer.data();
+  PointerWrap reader(&ptr, PointerWrap::MODE_READ);
+  loaded.DoState(reader);
+
+  EXPECT_EQ(PointerWrap::MODE_READ, reader.GetMode());
+  EXPECT_EQ(buffer.data() + buffer.size(), ptr);
+  EXPECT_EQ(42u, loaded.value);
+  EXPECT_EQ("Wii", loaded.name);
+  EXPECT_EQ(state.map, loaded.map);
+  EXPECT_EQ(state.memory, loaded.memory);
+}
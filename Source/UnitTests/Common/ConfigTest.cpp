@@ -0,0 +1,100 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "Common/Config/Config.h"
+
+namespace
+{
+const Config::ConfigInfo<int> TEST_INT{{Config::System::Main, "Test", "Int"}, 42};
+const Config::ConfigInfo<bool> TEST_BOOL{{Config::System::Main, "Test", "Bool"}, false};
+const Config::ConfigInfo<float> TEST_FLOAT{{Config::System::Main, "Test", "Float"}, 1.5f};
+const Config::ConfigInfo<std::string> TEST_STRING{{Config::System::Main, "Test", "String"}, "a"};
+
+class ConfigTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    Config::Init();
+    Config::AddLayer(std::make_unique<Config::Layer>(Config::LayerType::Base));
+  }
+
+  void TearDown() override { Config::Shutdown(); }
+};
+}  // namespace
+
+TEST_F(ConfigTest, GetReturnsDefault)
+{
+  EXPECT_EQ(42, Config::Get(TEST_INT));
+  EXPECT_EQ(42, Config::Get(TEST_INT));
+  EXPECT_FALSE(Config::Get(TEST_BOOL));
+  EXPECT_EQ(1.5f, Config::Get(TEST_FLOAT));
+  EXPECT_EQ("a", Config::Get(TEST_STRING));
+}
+
+TEST_F(ConfigTest, CachedValueFollowsChanges)
+{
+  EXPECT_EQ(42, Config::Get(TEST_INT));
+
+  Config::SetBase(TEST_INT, 5);
+  EXPECT_EQ(5, Config::Get(TEST_INT));
+
+  Config::SetCurrent(TEST_INT, 7);
+  EXPECT_EQ(7, Config::Get(TEST_INT));
+
+  // Changes made directly to a layer, without going through Config::Set.
+  Config::GetLayer(Config::LayerType::CurrentRun)->DeleteKey(TEST_INT.location);
+  EXPECT_EQ(5, Config::Get(TEST_INT));
+  Config::GetLayer(Config::LayerType::Base)->Set(TEST_INT, 9);
+  EXPECT_EQ(9, Config::Get(TEST_INT));
+
+  Config::ClearCurrentRunLayer();
+  Config::SetCurrent(TEST_FLOAT, -2.25f);
+  EXPECT_EQ(-2.25f, Config::Get(TEST_FLOAT));
+  Config::ClearCurrentRunLayer();
+  EXPECT_EQ(1.5f, Config::Get(TEST_FLOAT));
+
+  Config::SetBase(TEST_BOOL, true);
+  EXPECT_TRUE(Config::Get(TEST_BOOL));
+  Config::SetBase(TEST_STRING, std::string("b"));
+  EXPECT_EQ("b", Config::Get(TEST_STRING));
+}
+
+TEST_F(ConfigTest, CopiesHaveTheirOwnCache)
+{
+  EXPECT_EQ(42, Config::Get(TEST_INT));
+  Config::ConfigInfo<int> copy = TEST_INT;
+  copy.default_value = 1;
+  EXPECT_EQ(1, Config::Get(copy));
+  EXPECT_EQ(42, Config::Get(TEST_INT));
+}
+
+// Not a correctness test: compares cached lookups with the full layer lookup they replace.
+TEST_F(ConfigTest, GetBenchmark)
+{
+  constexpr int ITERATIONS = 1000000;
+  Config::SetBase(TEST_INT, 3);
+
+  const auto measure = [](auto&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    int sum = 0;
+    for (int i = 0; i < ITERATIONS; ++i)
+      sum += function();
+    const auto end = std::chrono::steady_clock::now();
+    EXPECT_EQ(3 * ITERATIONS, sum);
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+  };
+
+  const double uncached = measure([] {
+    return Config::GetLayer(Config::GetActiveLayerForConfig(TEST_INT))->Get(TEST_INT);
+  });
+  const double cached = measure([] { return Config::Get(TEST_INT); });
+  std::printf("Config::Get: %.1f ns uncached, %.1f ns cached\n", uncached, cached);
+}
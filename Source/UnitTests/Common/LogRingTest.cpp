@@ -0,0 +1,110 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cinttypes>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "Common/Logging/LogRing.h"
+#include "Common/StringUtil.h"
+
+static LogRing::Record MakeRecord(u64 sequence, const std::string& text)
+{
+  LogRing::Record record{};
+  record.sequence = sequence;
+  record.file = __FILE__;
+  record.line = __LINE__;
+  record.text_length = static_cast<u16>(text.size());
+  return record;
+}
+
+TEST(LogRing, Simple)
+{
+  auto ring = std::make_unique<LogRing>();
+  EXPECT_TRUE(ring->Empty());
+
+  const std::string text = "Hello";
+  EXPECT_TRUE(ring->Push(MakeRecord(42, text), text.c_str()));
+  EXPECT_FALSE(ring->Empty());
+
+  const size_t count = ring->PopAll([](const LogRing::Record& record, const char* record_text) {
+    EXPECT_EQ(42u, record.sequence);
+    EXPECT_EQ("Hello", std::string(record_text, record.text_length));
+  });
+  EXPECT_EQ(1u, count);
+  EXPECT_TRUE(ring->Empty());
+  EXPECT_EQ(0u, ring->GetDroppedCount());
+}
+
+TEST(LogRing, DropsWhenFull)
+{
+  auto ring = std::make_unique<LogRing>();
+  const std::string text(200, 'x');
+
+  u64 pushed = 0;
+  while (ring->Push(MakeRecord(pushed, text), text.c_str()))
+    ++pushed;
+  EXPECT_FALSE(ring->Push(MakeRecord(pushed, text), text.c_str()));
+  EXPECT_EQ(2u, ring->GetDroppedCount());
+
+  u64 expected = 0;
+  ring->PopAll([&](const LogRing::Record& record, const char*) {
+    EXPECT_EQ(expected++, record.sequence);
+  });
+  EXPECT_EQ(pushed, expected);
+
+  // There is room again once the consumer caught up.
+  EXPECT_TRUE(ring->Push(MakeRecord(pushed, text), text.c_str()));
+}
+
+TEST(LogRing, WrapAround)
+{
+  auto ring = std::make_unique<LogRing>();
+
+  // Use lengths that don't divide the ring size so that records end up straddling its end.
+  u64 sequence = 0;
+  for (int round = 0; round < 1000; ++round)
+  {
+    const std::string text = StringFromFormat("%d", round) + std::string(round % 300, 'y');
+    ASSERT_TRUE(ring->Push(MakeRecord(sequence, text), text.c_str()));
+
+    ring->PopAll([&](const LogRing::Record& record, const char* record_text) {
+      EXPECT_EQ(sequence, record.sequence);
+      EXPECT_EQ(text, std::string(record_text, record.text_length));
+    });
+    ++sequence;
+  }
+  EXPECT_TRUE(ring->Empty());
+}
+
+TEST(LogRing, MultiThreaded)
+{
+  auto ring = std::make_unique<LogRing>();
+  constexpr u64 COUNT = 100000;
+
+  std::thread producer([&ring] {
+    for (u64 i = 0; i < COUNT;)
+    {
+      const std::string text = StringFromFormat("message %" PRIu64, i);
+      if (ring->Push(MakeRecord(i, text), text.c_str()))
+        ++i;
+    }
+  });
+
+  u64 expected = 0;
+  while (expected < COUNT)
+  {
+    ring->PopAll([&](const LogRing::Record& record, const char* text) {
+      EXPECT_EQ(expected, record.sequence);
+      EXPECT_EQ(StringFromFormat("message %" PRIu64, expected),
+                std::string(text, record.text_length));
+      ++expected;
+    });
+  }
+  producer.join();
+
+  EXPECT_TRUE(ring->Empty());
+}
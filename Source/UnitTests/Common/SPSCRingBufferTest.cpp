@@ -0,0 +1,129 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/SPSCRingBuffer.h"
+
+using Ring = Common::SPSCRingBuffer<u32, 16>;
+
+// Copies the first count elements of the ring, which may be split at the end of the buffer.
+static std::vector<u32> Read(const Ring& ring, size_t count)
+{
+  std::vector<u32> elements;
+  while (elements.size() < count)
+  {
+    size_t contiguous;
+    const u32* data = ring.Peek(elements.size(), &contiguous);
+    const size_t part = std::min(contiguous, count - elements.size());
+    elements.insert(elements.end(), data, data + part);
+  }
+  return elements;
+}
+
+TEST(SPSCRingBuffer, Simple)
+{
+  auto ring = std::make_unique<Ring>();
+  EXPECT_EQ(0u, ring->Size());
+
+  const std::vector<u32> first{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  EXPECT_TRUE(ring->Push(first.data(), first.size()));
+  EXPECT_EQ(10u, ring->Size());
+  EXPECT_EQ(first, Read(*ring, 10));
+
+  ring->Pop(6);
+  EXPECT_EQ(4u, ring->Size());
+  EXPECT_EQ(std::vector<u32>({7, 8, 9, 10}), Read(*ring, 4));
+
+  // This one wraps around the end of the buffer.
+  const std::vector<u32> second{11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22};
+  EXPECT_TRUE(ring->Push(second.data(), second.size()));
+  EXPECT_EQ(16u, ring->Size());
+  EXPECT_EQ(std::vector<u32>({7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22}),
+            Read(*ring, 16));
+
+  size_t contiguous;
+  EXPECT_EQ(15u, *ring->Peek(8, &contiguous));
+  EXPECT_EQ(2u, contiguous);
+  EXPECT_EQ(19u, *ring->Peek(12, &contiguous));
+  EXPECT_EQ(14u, contiguous);
+
+  ring->Pop(16);
+  EXPECT_EQ(0u, ring->Size());
+}
+
+TEST(SPSCRingBuffer, Statistics)
+{
+  auto ring = std::make_unique<Ring>();
+  Ring::Statistics statistics = ring->GetStatistics();
+  EXPECT_EQ(0u, statistics.overruns);
+  EXPECT_EQ(0u, statistics.underruns);
+  EXPECT_EQ(0.0, statistics.average_fill);
+
+  const std::vector<u32> elements(12);
+  EXPECT_TRUE(ring->Push(elements.data(), 12));
+  // Doesn't fit, so nothing gets written.
+  EXPECT_FALSE(ring->Push(elements.data(), 5));
+  EXPECT_EQ(12u, ring->Size());
+  EXPECT_TRUE(ring->Push(elements.data(), 4));
+
+  ring->Pop(10);
+  ring->Pop(0);
+  ring->CountUnderrun();
+
+  statistics = ring->GetStatistics();
+  EXPECT_EQ(1u, statistics.overruns);
+  EXPECT_EQ(1u, statistics.underruns);
+  // The fill level is sampled before every pop.
+  EXPECT_DOUBLE_EQ((16 + 6) / 2.0, statistics.average_fill);
+}
+
+TEST(SPSCRingBuffer, MultiThreaded)
+{
+  auto ring = std::make_unique<Ring>();
+  constexpr u32 count = 100000;
+
+  auto producer = [&ring]() {
+    u32 next = 0;
+    while (next < count)
+    {
+      // Push blocks of varying sizes to exercise the wrap-around.
+      u32 block[5];
+      const u32 block_size = std::min<u32>(1 + next % 5, count - next);
+      for (u32 i = 0; i < block_size; ++i)
+        block[i] = next + i;
+      if (ring->Push(block, block_size))
+        next += block_size;
+      else
+        std::this_thread::yield();
+    }
+  };
+
+  auto consumer = [&ring]() {
+    u32 expected = 0;
+    while (expected < count)
+    {
+      const size_t size = ring->Size();
+      if (size == 0)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      for (u32 value : Read(*ring, size))
+        ASSERT_EQ(expected++, value);
+      ring->Pop(size);
+    }
+  };
+
+  std::thread consumer_thread(consumer);
+  std::thread producer_thread(producer);
+  consumer_thread.join();
+  producer_thread.join();
+
+  EXPECT_EQ(0u, ring->Size());
+}
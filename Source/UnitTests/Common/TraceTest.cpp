@@ -0,0 +1,99 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <thread>
+
+#include <picojson/picojson.h>
+
+#include "Common/FileUtil.h"
+#include "Common/Thread.h"
+#include "Common/Trace.h"
+
+static picojson::array ReadTraceEvents(const std::string& path)
+{
+  std::string json;
+  EXPECT_TRUE(File::ReadFileToString(path, json));
+
+  picojson::value root;
+  EXPECT_EQ("", picojson::parse(root, json));
+  return root.get("traceEvents").get<picojson::array>();
+}
+
+TEST(Trace, DisabledRecordsNothing)
+{
+  const std::string dir = File::CreateTempDir();
+  const std::string path = dir + "/trace.json";
+
+  Common::Trace::Start();
+  Common::Trace::Stop();
+  {
+    Common::Trace::ScopedSlice slice("Disabled");
+  }
+  ASSERT_TRUE(Common::Trace::WriteChromeTrace(path));
+
+  for (const picojson::value& event : ReadTraceEvents(path))
+    EXPECT_NE("Disabled", event.get("name").to_str());
+
+  File::DeleteDirRecursively(dir);
+}
+
+TEST(Trace, SlicesAndFlowsAcrossThreads)
+{
+  const std::string dir = File::CreateTempDir();
+  const std::string path = dir + "/trace.json";
+
+  Common::Trace::Start();
+  const u64 flow_id = Common::Trace::NewFlowId();
+
+  std::thread producer([flow_id] {
+    Common::SetCurrentThreadName("Producer");
+    Common::Trace::ScopedSlice slice("Produce");
+    Common::Trace::FlowStart("Handoff", flow_id);
+  });
+  producer.join();
+
+  {
+    Common::Trace::ScopedSlice slice(Common::Trace::InternString("Consume"));
+    Common::Trace::FlowEnd("Handoff", flow_id);
+  }
+  Common::Trace::Stop();
+  ASSERT_TRUE(Common::Trace::WriteChromeTrace(path));
+
+  std::map<std::string, double> thread_names;
+  std::map<std::string, double> slice_tids;
+  std::map<std::string, double> flow_tids;
+  for (const picojson::value& event : ReadTraceEvents(path))
+  {
+    const std::string phase = event.get("ph").to_str();
+    const std::string name = event.get("name").to_str();
+    if (phase == "M" && name == "thread_name")
+    {
+      thread_names[event.get("args").get("name").to_str()] = event.get("tid").get<double>();
+    }
+    else if (phase == "X")
+    {
+      EXPECT_GE(event.get("dur").get<double>(), 0.0);
+      slice_tids[name] = event.get("tid").get<double>();
+    }
+    else if (phase == "s" || phase == "f")
+    {
+      EXPECT_EQ("Handoff", name);
+      EXPECT_EQ(static_cast<double>(flow_id), event.get("id").get<double>());
+      flow_tids[phase] = event.get("tid").get<double>();
+    }
+  }
+
+  ASSERT_EQ(1u, thread_names.count("Producer"));
+  ASSERT_EQ(1u, slice_tids.count("Produce"));
+  ASSERT_EQ(1u, slice_tids.count("Consume"));
+  EXPECT_EQ(thread_names["Producer"], slice_tids["Produce"]);
+  EXPECT_NE(slice_tids["Produce"], slice_tids["Consume"]);
+  EXPECT_EQ(slice_tids["Produce"], flow_tids["s"]);
+  EXPECT_EQ(slice_tids["Consume"], flow_tids["f"]);
+
+  File::DeleteDirRecursively(dir);
+}
@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -33,6 +35,32 @@ protected:
   bool m_accov_raised = false;
 };
 
+// Accelerator reading ADPCM data from a buffer, which loops back to the start of the sound when
+// looping is enabled, like the AX ucode does.
+class ADPCMTestAccelerator : public DSP::Accelerator
+{
+public:
+  ADPCMTestAccelerator(const std::vector<u8>& memory, bool looping)
+      : m_memory(memory), m_looping(looping)
+  {
+  }
+
+protected:
+  void OnEndException() override
+  {
+    if (m_looping)
+    {
+      SetPredScale(m_memory[0]);
+      SetYn1(0);
+      SetYn2(0);
+    }
+  }
+  u8 ReadMemory(u32 address) override { return m_memory[address % m_memory.size()]; }
+  void WriteMemory(u32 address, u8 value) override {}
+  const std::vector<u8>& m_memory;
+  bool m_looping;
+};
+
 TEST(DSPAccelerator, Initialization)
 {
   TestAccelerator accelerator;
@@ -185,3 +213,50 @@ TEST(DSPAccelerator, CurrentAddressSkips)
   accelerator.TestRead();
   EXPECT_EQ(accelerator.GetCurrentAddress(), 0x00000013u);
 }
+
+TEST(DSPAccelerator, BulkADPCMReadsMatchSingleReads)
+{
+  std::mt19937 rng(42);
+  std::vector<u8> memory(0x800);
+  for (u8& byte : memory)
+    byte = static_cast<u8>(rng());
+  std::array<s16, 16> coefs;
+  for (s16& coef : coefs)
+    coef = static_cast<s16>(rng());
+
+  // Cover the special end address cases and the start of a sound on a frame header.
+  for (u32 start_address : {0x0u, 0x2u, 0x25u})
+  {
+    for (u32 end_address : {0x100u, 0x101u, 0x10fu, 0x123u, 0xfffu})
+    {
+      for (bool looping : {false, true})
+      {
+        ADPCMTestAccelerator single(memory, looping);
+        ADPCMTestAccelerator bulk(memory, looping);
+        for (DSP::Accelerator* accelerator : {&single, &bulk})
+        {
+          accelerator->SetSampleFormat(0x00);
+          accelerator->SetStartAddress(start_address);
+          accelerator->SetEndAddress(end_address);
+          accelerator->SetCurrentAddress(start_address);
+          accelerator->SetPredScale(memory[start_address / 16 * 8]);
+        }
+
+        for (u32 count = 1; count < 200; ++count)
+        {
+          std::vector<u16> expected(count);
+          for (u16& sample : expected)
+            sample = single.Read(coefs.data());
+          std::vector<u16> samples(count);
+          bulk.ReadSamples(coefs.data(), samples.data(), count);
+
+          ASSERT_EQ(expected, samples);
+          ASSERT_EQ(single.GetCurrentAddress(), bulk.GetCurrentAddress());
+          ASSERT_EQ(single.GetYn1(), bulk.GetYn1());
+          ASSERT_EQ(single.GetYn2(), bulk.GetYn2());
+          ASSERT_EQ(single.GetPredScale(), bulk.GetPredScale());
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,168 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+// gtest's TEST macro conflicts with the TEST method of the x64 emitter, which DSPTables.h pulls
+// in. Only TEST_F is used in this file.
+#undef TEST
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/MemoryUtil.h"
+#include "Common/Timer.h"
+#include "Core/ConfigManager.h"
+#include "Core/DSP/DSPAnalyzer.h"
+#include "Core/DSP/DSPCodeUtil.h"
+#include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPTables.h"
+#include "UICommon/UICommon.h"
+
+// Mixes 32 voices of 160 samples each into a buffer, which is what the voice loops of the AX
+// ucode spend most of their time on.
+static const char s_mixer_code[] = R"(
+	lri	$AR3, #0x0000
+	bloopi	#32, voice_end
+	lri	$AR0, #0x0100
+	lri	$AR1, #0x0400
+	lrri	$AX0.H, @$AR3
+	bloopi	#160, sample_end
+	lrri	$AX0.L, @$AR0
+	lrr	$AC1.M, @$AR1
+	mul	$AX0.L, $AX0.H
+	addp	$ACC1
+	asr	$ACC1, #-4
+sample_end:
+	srri	@$AR1, $AC1.M
+voice_end:
+	nop
+	halt
+)";
+
+// A loop built from jumps rather than from BLOOP.
+static const char s_jump_loop_code[] = R"(
+	lri	$AR0, #0x0100
+	clr	$ACC0
+	lri	$AX1.H, #0x0800
+loop:
+	lrri	$AX0.L, @$AR0
+	addax	$ACC0, $AX0
+	movr	$ACC1, $AX1.H
+	addis	$AC1.M, #-1
+	mrr	$AX1.H, $AC1.M
+	tst	$ACC1
+	jz	done
+	jmp	loop
+done:
+	halt
+)";
+
+class DSPJitTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    DSP::InitInstructionTable();
+  }
+
+  void TearDown() override
+  {
+    DSP::DSPCore_Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  struct Result
+  {
+    std::array<u16, 32> registers;
+    std::vector<u16> dram;
+    double microseconds_per_run;
+  };
+
+  // Runs the code from a freshly initialized DSP until it halts, the given number of times.
+  static Result Run(const std::vector<u16>& code, DSP::DSPInitOptions::CoreType core_type,
+                    int runs)
+  {
+    DSP::DSPInitOptions options;
+    options.irom_contents.fill(0);
+    options.coef_contents.fill(0);
+    options.core_type = core_type;
+    EXPECT_TRUE(DSP::DSPCore_Init(options));
+
+    Common::UnWriteProtectMemory(DSP::g_dsp.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+    std::copy(code.begin(), code.end(), DSP::g_dsp.iram);
+    Common::WriteProtectMemory(DSP::g_dsp.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+    // Nothing was compiled yet, so only the analysis needs to be updated.
+    DSP::Analyzer::Analyze();
+
+    const u64 start = Common::Timer::GetTimeUs();
+    for (int i = 0; i < runs; ++i)
+    {
+      for (u16 address = 0; address < 0x100; ++address)
+      {
+        DSP::g_dsp.dram[address] = 0x1000 + address * 0x100;
+        DSP::g_dsp.dram[0x100 + address] = address * 0x35 - 0x2000;
+        DSP::g_dsp.dram[0x400 + address] = 0;
+      }
+
+      DSP::g_dsp.pc = 0;
+      DSP::g_dsp.cr &= ~DSP::CR_HALT;
+      while (!(DSP::g_dsp.cr & DSP::CR_HALT))
+        DSP::DSPCore_RunCycles(1000);
+    }
+    const u64 end = Common::Timer::GetTimeUs();
+
+    Result result;
+    for (size_t reg = 0; reg < result.registers.size(); ++reg)
+      result.registers[reg] = DSP::DSPCore_ReadRegister(reg);
+    // HALT pops the call stack with the JIT but not with the interpreter.
+    result.registers[DSP::DSP_REG_ST0] = 0;
+    // The JIT skips the flags that the analyzer finds to be overwritten before being read.
+    result.registers[DSP::DSP_REG_SR] &= ~DSP::SR_CMP_MASK;
+    result.dram.assign(DSP::g_dsp.dram, DSP::g_dsp.dram + 0x800);
+    result.microseconds_per_run = static_cast<double>(end - start) / runs;
+
+    DSP::DSPCore_Shutdown();
+    return result;
+  }
+
+  static void CompareCores(const char* name, const char* text, int runs)
+  {
+    std::vector<u16> code;
+    ASSERT_TRUE(DSP::Assemble(text, code));
+
+    const Result interpreter = Run(code, DSP::DSPInitOptions::CORE_INTERPRETER, runs);
+    const Result jit = Run(code, DSP::DSPInitOptions::CORE_JIT, runs);
+
+    EXPECT_EQ(interpreter.registers, jit.registers);
+    EXPECT_EQ(interpreter.dram, jit.dram);
+
+    printf("%s: %.1f us per run with the interpreter, %.1f us with the JIT\n", name,
+           interpreter.microseconds_per_run, jit.microseconds_per_run);
+  }
+
+  std::string m_profile_path;
+};
+
+TEST_F(DSPJitTest, BlockLoop)
+{
+  CompareCores("BLOOP mixer", s_mixer_code, 50);
+}
+
+TEST_F(DSPJitTest, JumpLoop)
+{
+  CompareCores("Jump loop", s_jump_loop_code, 50);
+}
@@ -0,0 +1,112 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/IOS/ES/Formats.h"
+#include "Core/IOS/NANDMetadataCache.h"
+
+using IOS::HLE::NANDMetadataCache;
+
+class NANDMetadataCacheTest : public testing::Test
+{
+protected:
+  // Returns how many times the listing of the given directory had to be loaded so far.
+  int LoadListing(const std::string& path)
+  {
+    m_cache.GetDirectoryListing(path, [this] {
+      ++m_loads;
+      return NANDMetadataCache::DirectoryListing{true, true, {}};
+    });
+    return m_loads;
+  }
+
+  int LoadTMD(u64 title_id)
+  {
+    m_cache.GetInstalledTMD(title_id, [this] {
+      ++m_loads;
+      return IOS::ES::TMDReader{};
+    });
+    return m_loads;
+  }
+
+  int LoadTitles(NANDMetadataCache::TitleList list)
+  {
+    m_cache.GetTitleList(list, [this] {
+      ++m_loads;
+      return std::vector<u64>{0x0001000248414241};
+    });
+    return m_loads;
+  }
+
+  NANDMetadataCache m_cache;
+  int m_loads = 0;
+};
+
+TEST_F(NANDMetadataCacheTest, CachesManagedDirectoriesOnly)
+{
+  EXPECT_EQ(1, LoadListing("/title/00010002"));
+  EXPECT_EQ(1, LoadListing("/title/00010002"));
+  EXPECT_EQ(1, LoadListing("/title/00010002/"));
+
+  EXPECT_EQ(2, LoadListing("/shared2"));
+  EXPECT_EQ(3, LoadListing("/shared2"));
+  EXPECT_EQ(4, LoadListing("/titles"));
+  EXPECT_EQ(5, LoadListing("/titles"));
+
+  const NANDMetadataCache::Statistics statistics = m_cache.GetStatistics();
+  EXPECT_EQ(2u, statistics.hits);
+  EXPECT_EQ(1u, statistics.misses);
+}
+
+TEST_F(NANDMetadataCacheTest, InvalidatesEntryParentsAndChildren)
+{
+  LoadListing("/title");
+  LoadListing("/title/00010002");
+  LoadListing("/title/00010002/48414241");
+  LoadListing("/title/00010002/48414241/data");
+  LoadListing("/title/00010002/48414242");
+  ASSERT_EQ(5, m_loads);
+
+  m_cache.InvalidateEntry("/title/00010002/48414241");
+  EXPECT_EQ(5, LoadListing("/title/00010002/48414242"));
+  EXPECT_EQ(6, LoadListing("/title/00010002/48414241/data"));
+  EXPECT_EQ(7, LoadListing("/title/00010002/48414241"));
+  EXPECT_EQ(8, LoadListing("/title/00010002"));
+  EXPECT_EQ(9, LoadListing("/title"));
+}
+
+TEST_F(NANDMetadataCacheTest, InvalidatesTitleMetadata)
+{
+  using TitleList = NANDMetadataCache::TitleList;
+  LoadTMD(0x0001000248414241);
+  LoadTMD(0x0001000248414242);
+  LoadTitles(TitleList::Installed);
+  LoadTitles(TitleList::Tickets);
+  ASSERT_EQ(4, m_loads);
+
+  // Writing to a file only affects the TMD of its title.
+  m_cache.InvalidateContents("/title/00010002/48414241/content/title.tmd");
+  EXPECT_EQ(4, LoadTitles(TitleList::Installed));
+  EXPECT_EQ(4, LoadTMD(0x0001000248414242));
+  EXPECT_EQ(5, LoadTMD(0x0001000248414241));
+
+  // Creating an entry also changes the list of installed titles.
+  m_cache.InvalidateEntry("/title/00010002/48414242/content");
+  EXPECT_EQ(5, LoadTMD(0x0001000248414241));
+  EXPECT_EQ(5, LoadTitles(TitleList::Tickets));
+  EXPECT_EQ(6, LoadTMD(0x0001000248414242));
+  EXPECT_EQ(7, LoadTitles(TitleList::Installed));
+
+  m_cache.InvalidateEntry("/ticket/00010002/48414241.tik");
+  EXPECT_EQ(7, LoadTMD(0x0001000248414241));
+  EXPECT_EQ(8, LoadTitles(TitleList::Tickets));
+
+  m_cache.Clear();
+  EXPECT_EQ(9, LoadTMD(0x0001000248414241));
+}
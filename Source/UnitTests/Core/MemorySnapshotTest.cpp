@@ -0,0 +1,125 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemTools.h"
+#include "UICommon/UICommon.h"
+
+class MemorySnapshotTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    Memory::Init();
+    EMM::InstallExceptionHandler();
+  }
+
+  void TearDown() override
+  {
+    Memory::FinishSnapshotCapture();
+    EMM::UninstallExceptionHandler();
+    Memory::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  static std::vector<u8> SaveMemory()
+  {
+    std::vector<u8> buffer;
+    PointerWrap p(&buffer);
+    Memory::DoState(p);
+    p.FinishWrite();
+    return buffer;
+  }
+
+  std::string m_profile_path;
+};
+
+TEST_F(MemorySnapshotTest, CapturesMemoryAtBeginning)
+{
+  if (!EMM::IsProcessWideHandlerInstalled())
+    return;
+
+  for (u32 i = 0; i < Memory::RAM_SIZE; i += 0x1000)
+    Memory::m_pRAM[i] = static_cast<u8>(i >> 12);
+  const std::vector<u8> expected = SaveMemory();
+
+  std::vector<u8> buffer;
+  PointerWrap p(&buffer);
+  u32 prefix = 0x12345678;
+  p.Do(prefix);
+  ASSERT_TRUE(Memory::BeginSnapshot());
+  Memory::DoState(p);
+  u32 suffix = 0x9ABCDEF0;
+  p.Do(suffix);
+  p.FinishWrite();
+  EXPECT_EQ(2 * sizeof(u32), buffer.size());
+
+  // A second snapshot can't begin while one is in flight.
+  EXPECT_FALSE(Memory::BeginSnapshot());
+
+  // Writes from this thread, from another thread and by the host OS.
+  Memory::m_pRAM[0x1234] = 0xFF;
+  Memory::Write_U32(0xDEADBEEF, 0x00400000);
+  std::thread([] { std::memset(Memory::m_pRAM + 0x100000, 0x22, 0x10000); }).join();
+  Memory::PrepareForHostWrite(0x00200800, 0x3000);
+  std::memset(Memory::GetPointer(0x00200800), 0x33, 0x3000);
+
+  Memory::WriteSnapshot(&buffer);
+
+  ASSERT_EQ(expected.size() + 2 * sizeof(u32), buffer.size());
+  EXPECT_EQ(0, std::memcmp(&prefix, buffer.data(), sizeof(u32)));
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin() + sizeof(u32)));
+  EXPECT_EQ(0, std::memcmp(&suffix, buffer.data() + buffer.size() - sizeof(u32), sizeof(u32)));
+
+  // The memory itself was modified as usual.
+  EXPECT_EQ(0xFF, Memory::m_pRAM[0x1234]);
+  EXPECT_EQ(0xDEADBEEF, Memory::Read_U32(0x00400000));
+  EXPECT_EQ(0x22, Memory::m_pRAM[0x10FFFF]);
+  EXPECT_EQ(0x33, Memory::m_pRAM[0x203000]);
+
+  // The memory is writable again, and a new snapshot can begin.
+  Memory::m_pRAM[0x5000] = 0x44;
+  EXPECT_TRUE(Memory::BeginSnapshot());
+  Memory::CancelSnapshot();
+}
+
+TEST_F(MemorySnapshotTest, FinishCaptureKeepsSnapshot)
+{
+  if (!EMM::IsProcessWideHandlerInstalled())
+    return;
+
+  std::memset(Memory::m_pRAM, 0x55, Memory::RAM_SIZE);
+  const std::vector<u8> expected = SaveMemory();
+
+  std::vector<u8> buffer;
+  PointerWrap p(&buffer);
+  ASSERT_TRUE(Memory::BeginSnapshot());
+  Memory::DoState(p);
+  p.FinishWrite();
+
+  // For example because the BATs changed.
+  Memory::FinishSnapshotCapture();
+  std::memset(Memory::m_pRAM, 0x66, Memory::RAM_SIZE);
+
+  Memory::WriteSnapshot(&buffer);
+  EXPECT_EQ(expected, buffer);
+}
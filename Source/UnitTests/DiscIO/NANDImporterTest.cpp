@@ -0,0 +1,231 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/AES.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "DiscIO/NANDImporter.h"
+
+namespace
+{
+constexpr size_t BLOCK_SIZE = 0x800;
+constexpr size_t SPARE_SIZE = 0x40;
+constexpr size_t BLOCKS = 0x40000;
+constexpr size_t CLUSTER_SIZE = 0x4000;
+constexpr size_t KEYS_SIZE = 0x400;
+constexpr size_t AES_KEY_OFFSET = 0x158;
+constexpr size_t SUPERBLOCK_OFFSET = 0x1fc00000;
+constexpr size_t FAT_OFFSET = SUPERBLOCK_OFFSET + 0xc;
+constexpr size_t FST_OFFSET = FAT_OFFSET + 0x10000;
+constexpr u16 LAST_CLUSTER = 0xfffb;
+
+// segher's byte by byte implementation of the ECC that the NAND stores for every 512 bytes.
+std::array<u8, 4> ReferenceECC(const u8* data)
+{
+  const auto parity = [](u8 x) {
+    u8 y = 0;
+    for (; x; x >>= 1)
+      y ^= x & 1;
+    return y;
+  };
+
+  u8 a[12][2] = {};
+  for (int i = 0; i < 512; ++i)
+  {
+    for (int j = 0; j < 9; ++j)
+      a[3 + j][(i >> j) & 1] ^= data[i];
+  }
+
+  const u8 x = a[3][0] ^ a[3][1];
+  a[0][0] = x & 0x55;
+  a[0][1] = x & 0xaa;
+  a[1][0] = x & 0x33;
+  a[1][1] = x & 0xcc;
+  a[2][0] = x & 0x0f;
+  a[2][1] = x & 0xf0;
+
+  u32 a0 = 0, a1 = 0;
+  for (int j = 0; j < 12; ++j)
+  {
+    a0 |= parity(a[j][0]) << j;
+    a1 |= parity(a[j][1]) << j;
+  }
+  return {{static_cast<u8>(a0), static_cast<u8>(a0 >> 8), static_cast<u8>(a1),
+           static_cast<u8>(a1 >> 8)}};
+}
+
+struct TestFile
+{
+  const char* name;
+  u16 fst_index;
+  std::vector<u16> clusters;
+  std::vector<u8> data;
+};
+
+// Writes a BootMii backup in which only the pages that hold something get written, so that the
+// 528 MiB image stays sparse. The pages that are left out read as zeros, which match their ECC.
+class ImageWriter
+{
+public:
+  explicit ImageWriter(const std::string& path) : m_file(path, "wb") {}
+
+  // With bad_ecc, the ECC of the first page gets a flipped bit.
+  void Write(size_t nand_offset, const std::vector<u8>& data, bool bad_ecc = false)
+  {
+    for (size_t offset = 0; offset < data.size(); offset += BLOCK_SIZE)
+    {
+      std::array<u8, BLOCK_SIZE + SPARE_SIZE> block{};
+      std::copy_n(&data[offset], std::min(BLOCK_SIZE, data.size() - offset), block.begin());
+      std::fill(block.begin() + BLOCK_SIZE, block.end(), 0xff);
+      for (size_t i = 0; i < BLOCK_SIZE / 0x200; ++i)
+      {
+        const std::array<u8, 4> ecc = ReferenceECC(&block[i * 0x200]);
+        std::copy(ecc.begin(), ecc.end(), &block[BLOCK_SIZE + 0x30 + i * 4]);
+      }
+      if (bad_ecc && offset == 0)
+        block[BLOCK_SIZE + 0x30] ^= 0x10;
+
+      WriteBlock((nand_offset + offset) / BLOCK_SIZE, block.data());
+    }
+  }
+
+  void WriteKeys(const std::array<u8, KEYS_SIZE>& keys)
+  {
+    m_file.Seek(BLOCKS * (BLOCK_SIZE + SPARE_SIZE), SEEK_SET);
+    m_file.WriteArray(keys.data(), keys.size());
+  }
+
+private:
+  void WriteBlock(size_t block_number, const u8* block)
+  {
+    m_file.Seek(block_number * (BLOCK_SIZE + SPARE_SIZE), SEEK_SET);
+    m_file.WriteBytes(block, BLOCK_SIZE + SPARE_SIZE);
+  }
+
+  File::IOFile m_file;
+};
+
+void WriteFSTEntry(std::vector<u8>* superblock, u16 index, const char* name, u8 mode, u16 sub,
+                   u16 sib, u32 size)
+{
+  u8* entry = &(*superblock)[FST_OFFSET - SUPERBLOCK_OFFSET + index * 0x20];
+  std::strncpy(reinterpret_cast<char*>(entry), name, 12);
+  entry[0x0c] = mode;
+  entry[0x0e] = sub >> 8;
+  entry[0x0f] = sub & 0xff;
+  entry[0x10] = sib >> 8;
+  entry[0x11] = sib & 0xff;
+  for (int i = 0; i < 4; ++i)
+    entry[0x12 + i] = static_cast<u8>(size >> (24 - i * 8));
+}
+}  // namespace
+
+class NANDImporterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_temp_path = File::CreateTempDir();
+    m_nand_root = m_temp_path + "/nand";
+    File::CreateDir(m_nand_root);
+    File::SetUserPath(D_WIIROOT_IDX, m_nand_root);
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_temp_path); }
+
+  std::string m_temp_path;
+  std::string m_nand_root;
+};
+
+TEST_F(NANDImporterTest, ImportSyntheticNAND)
+{
+  std::array<u8, KEYS_SIZE> keys;
+  for (size_t i = 0; i < keys.size(); ++i)
+    keys[i] = static_cast<u8>(i * 7 + 3);
+  const u8* const key = &keys[AES_KEY_OFFSET];
+
+  std::mt19937 random(1234);
+  std::vector<TestFile> files = {
+      {"big.bin", 2, {100, 57, 300}, std::vector<u8>(0x9123)},
+      {"SYSCONF", 3, {400}, std::vector<u8>(0x100)},
+      {"empty", 4, {}, {}},
+  };
+  for (TestFile& file : files)
+    std::generate(file.data.begin(), file.data.end(), [&random] { return u8(random()); });
+
+  std::vector<u8> superblock(FST_OFFSET - SUPERBLOCK_OFFSET + 5 * 0x20);
+  std::memcpy(superblock.data(), "SFFS\0\0\0\x01", 8);
+  // /
+  //   shared2/
+  //     SYSCONF
+  //     empty
+  //   big.bin
+  WriteFSTEntry(&superblock, 0, "/", 2, 1, 0xffff, 0);
+  WriteFSTEntry(&superblock, 1, "shared2", 2, 3, 2, 0);
+  WriteFSTEntry(&superblock, 2, "big.bin", 1, 100, 0xffff, 0x9123);
+  WriteFSTEntry(&superblock, 3, "SYSCONF", 1, 400, 4, 0x100);
+  WriteFSTEntry(&superblock, 4, "empty", 1, 0xffff, 0xffff, 0);
+
+  const std::string image_path = m_temp_path + "/nand.bin";
+  {
+    ImageWriter writer(image_path);
+    for (const TestFile& file : files)
+    {
+      for (size_t i = 0; i < file.clusters.size(); ++i)
+      {
+        const u16 cluster = file.clusters[i];
+        const u16 next = i + 1 < file.clusters.size() ? file.clusters[i + 1] : LAST_CLUSTER;
+        superblock[FAT_OFFSET - SUPERBLOCK_OFFSET + cluster * 2] = next >> 8;
+        superblock[FAT_OFFSET - SUPERBLOCK_OFFSET + cluster * 2 + 1] = next & 0xff;
+
+        std::vector<u8> plaintext(CLUSTER_SIZE);
+        const size_t offset = i * CLUSTER_SIZE;
+        std::copy_n(&file.data[offset], std::min(CLUSTER_SIZE, file.data.size() - offset),
+                    plaintext.begin());
+        std::array<u8, 16> iv{};
+        // The importer reports pages with a bad ECC, but still imports them.
+        writer.Write(cluster * CLUSTER_SIZE,
+                     Common::AES::Encrypt(key, iv.data(), plaintext.data(), CLUSTER_SIZE),
+                     cluster == 57);
+      }
+    }
+    writer.Write(SUPERBLOCK_OFFSET, superblock);
+    writer.WriteKeys(keys);
+  }
+
+  const std::optional<DiscIO::NANDImporter::Statistics> statistics =
+      DiscIO::NANDImporter().ImportNANDBin(image_path, [] {}, [] { return std::string(); });
+  ASSERT_TRUE(statistics);
+  EXPECT_EQ(2u, statistics->directories);
+  EXPECT_EQ(3u, statistics->files);
+  EXPECT_EQ(0x9223u, statistics->bytes_written);
+  EXPECT_EQ(1u, statistics->ecc_errors);
+  printf("Imported a %.0f MiB image in %.2f s: %.1f MB/s\n", statistics->bytes_read / 1048576.0,
+         statistics->seconds, statistics->bytes_read / statistics->seconds / 1000000);
+
+  for (const TestFile& file : files)
+  {
+    const std::string path = m_nand_root + (file.fst_index == 2 ? "/" : "/shared2/") + file.name;
+    std::string contents;
+    ASSERT_TRUE(File::ReadFileToString(path, contents)) << path;
+    EXPECT_EQ(file.data, std::vector<u8>(contents.begin(), contents.end())) << path;
+  }
+
+  std::string exported_keys;
+  ASSERT_TRUE(File::ReadFileToString(m_nand_root + "/keys.bin", exported_keys));
+  EXPECT_EQ(std::vector<u8>(keys.begin(), keys.end()),
+            std::vector<u8>(exported_keys.begin(), exported_keys.end()));
+}
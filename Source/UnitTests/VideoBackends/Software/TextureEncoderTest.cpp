@@ -0,0 +1,155 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Timer.h"
+#include "VideoBackends/Software/EfbInterface.h"
+#include "VideoBackends/Software/TextureEncoder.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/TextureCacheBase.h"
+#include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VideoCommon.h"
+
+namespace
+{
+constexpr EFBCopyFormat COPY_FORMATS[] = {
+    EFBCopyFormat::R4,     EFBCopyFormat::R8_0x1, EFBCopyFormat::RA4, EFBCopyFormat::RA8,
+    EFBCopyFormat::RGB565, EFBCopyFormat::RGB5A3, EFBCopyFormat::RGBA8, EFBCopyFormat::A8,
+    EFBCopyFormat::R8,     EFBCopyFormat::G8,     EFBCopyFormat::B8,    EFBCopyFormat::RG8,
+    EFBCopyFormat::GB8,
+};
+constexpr const char* COPY_FORMAT_NAMES[] = {"R4", "R8_0x1", "RA4", "RA8", "RGB565", "RGB5A3",
+                                             "RGBA8", "A8", "R8", "G8", "B8", "RG8", "GB8"};
+
+constexpr PEControl::PixelFormat EFB_FORMATS[] = {PEControl::RGB8_Z24, PEControl::RGBA6_Z24,
+                                                  PEControl::RGB565_Z16, PEControl::Z24};
+constexpr const char* EFB_FORMAT_NAMES[] = {"RGB8_Z24", "RGBA6_Z24", "RGB565_Z16", "Z24"};
+
+// Wide enough for a full width RGBA8 copy, whose blocks are 4 texels wide and 64 bytes long.
+constexpr u32 STRIDE_CHANNELS = EFB_WIDTH / 4 * 64 / 32;
+constexpr u32 DST_SIZE = STRIDE_CHANNELS * 32 * (EFB_HEIGHT / 4);
+
+// The depth encoders panic on the formats that only make sense for colours.
+bool IsSupported(PEControl::PixelFormat efb_format, EFBCopyFormat copy_format)
+{
+  return efb_format != PEControl::Z24 ||
+         (copy_format != EFBCopyFormat::RA4 && copy_format != EFBCopyFormat::RA8 &&
+          copy_format != EFBCopyFormat::RGB565 && copy_format != EFBCopyFormat::RGB5A3 &&
+          copy_format != EFBCopyFormat::A8);
+}
+
+class TextureEncoderTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    std::mt19937 random(1234);
+    const auto fill = [&random](u8* begin) {
+      std::generate(begin, begin + EFB_WIDTH * EFB_HEIGHT * 3,
+                    [&random] { return static_cast<u8>(random()); });
+    };
+    fill(EfbInterface::GetPixelPointer(0, 0, false));
+    fill(EfbInterface::GetPixelPointer(0, 0, true));
+  }
+
+  // The encoders read the size of the copy from the registers.
+  static EFBCopyParams SetUpCopy(PEControl::PixelFormat efb_format, EFBCopyFormat copy_format,
+                                 bool yuv, const EFBRectangle& rect, bool scale_by_half)
+  {
+    bpmem.copyTexSrcWH.x = rect.GetWidth() - 1;
+    bpmem.copyTexSrcWH.y = rect.GetHeight() - 1;
+    bpmem.triggerEFBCopy.half_scale = scale_by_half;
+    bpmem.copyMipMapStrideChannels = STRIDE_CHANNELS;
+    return EFBCopyParams(efb_format, copy_format, efb_format == PEControl::Z24, yuv, 1.0f);
+  }
+
+  static std::vector<u8> Encode(const EFBCopyParams& params, const EFBRectangle& rect,
+                                bool scale_by_half)
+  {
+    std::vector<u8> dst(DST_SIZE, 0xcd);
+    TextureEncoder::Encode(dst.data(), params, 0, 0, 0, 0, rect, scale_by_half);
+    return dst;
+  }
+
+  static std::vector<u8> EncodeGeneric(const EFBCopyParams& params, const EFBRectangle& rect,
+                                       bool scale_by_half)
+  {
+    std::vector<u8> dst(DST_SIZE, 0xcd);
+    TextureEncoder::EncodeGeneric(dst.data(), params, rect, scale_by_half);
+    return dst;
+  }
+};
+}  // namespace
+
+TEST_F(TextureEncoderTest, MatchesGenericEncoder)
+{
+  // The whole EFB, a copy that doesn't start at the origin or end on a block boundary, and one
+  // that is a pixel wider and taller than a whole number of blocks.
+  const EFBRectangle rects[] = {
+      {0, 0, EFB_WIDTH, EFB_HEIGHT}, {8, 6, 108, 58}, {16, 10, 145, 43}};
+  for (const EFBRectangle& rect : rects)
+  {
+    for (int scale_by_half = 0; scale_by_half < 2; scale_by_half++)
+    {
+      for (size_t i = 0; i < std::size(EFB_FORMATS); i++)
+      {
+        for (size_t j = 0; j < std::size(COPY_FORMATS); j++)
+        {
+          if (!IsSupported(EFB_FORMATS[i], COPY_FORMATS[j]))
+            continue;
+
+          for (int yuv = 0; yuv < 2; yuv++)
+          {
+            const EFBCopyParams params =
+                SetUpCopy(EFB_FORMATS[i], COPY_FORMATS[j], yuv, rect, scale_by_half);
+            EXPECT_TRUE(EncodeGeneric(params, rect, scale_by_half) ==
+                        Encode(params, rect, scale_by_half))
+                << EFB_FORMAT_NAMES[i] << " " << COPY_FORMAT_NAMES[j] << (yuv ? " YUV" : "")
+                << (scale_by_half ? " half scale" : "") << " " << rect.GetWidth() << "x"
+                << rect.GetHeight();
+          }
+        }
+      }
+    }
+  }
+}
+
+// Not a test as such: prints the speed of full EFB copies from an RGBA6 EFB to every format.
+TEST_F(TextureEncoderTest, Benchmark)
+{
+  constexpr int LOOPS = 20;
+  const EFBRectangle rect(0, 0, EFB_WIDTH, EFB_HEIGHT);
+  std::vector<u8> dst(DST_SIZE);
+  for (size_t i = 0; i < std::size(COPY_FORMATS); i++)
+  {
+    const EFBCopyParams params =
+        SetUpCopy(PEControl::RGBA6_Z24, COPY_FORMATS[i], false, rect, false);
+    double mtexels_per_second[2];
+    for (int generic = 0; generic < 2; generic++)
+    {
+      const u64 start = Common::Timer::GetTimeUs();
+      for (int j = 0; j < LOOPS; j++)
+      {
+        if (generic)
+          TextureEncoder::EncodeGeneric(dst.data(), params, rect, false);
+        else
+          TextureEncoder::Encode(dst.data(), params, 0, 0, 0, 0, rect, false);
+      }
+      const u64 elapsed_us = std::max<u64>(Common::Timer::GetTimeUs() - start, 1);
+      mtexels_per_second[generic] =
+          static_cast<double>(LOOPS) * EFB_WIDTH * EFB_HEIGHT / elapsed_us;
+    }
+
+    printf("%-7s %8.1f MTexels/s (generic %.1f MTexels/s)\n", COPY_FORMAT_NAMES[i],
+           mtexels_per_second[0], mtexels_per_second[1]);
+  }
+}
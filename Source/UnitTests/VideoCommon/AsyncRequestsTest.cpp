@@ -0,0 +1,133 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "VideoBackends/Null/Render.h"
+#include "VideoCommon/AsyncRequests.h"
+#include "VideoCommon/RenderBase.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+namespace
+{
+// Bounding box coordinate i reads as i * 10 plus the number of times it was read before.
+class FakeRenderer final : public Null::Renderer
+{
+public:
+  u16 BBoxRead(int index) override { return static_cast<u16>(index * 10 + bbox_reads[index]++); }
+  void PokeEFB(EFBAccessType type, const EfbPokeData* points, size_t num_points) override
+  {
+    poke_batches.push_back(static_cast<int>(num_points));
+  }
+
+  int bbox_reads[4] = {};
+  std::vector<int> poke_batches;
+};
+
+AsyncRequests::Event MakePoke(AsyncRequests::Event::Type type)
+{
+  AsyncRequests::Event e;
+  e.type = type;
+  e.time = 0;
+  e.efb_poke.x = 0;
+  e.efb_poke.y = 0;
+  e.efb_poke.data = 0;
+  return e;
+}
+
+u64 CountRequests(AsyncRequests::Event::Type type)
+{
+  const AsyncRequests::LatencyHistogram histogram =
+      AsyncRequests::GetInstance()->GetLatencyHistogram(type);
+  return std::accumulate(histogram.begin(), histogram.end(), u64(0));
+}
+
+class AsyncRequestsTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    SConfig::Init();
+    // Pushing wakes up the GPU loop instead of scheduling a sync on the CPU thread.
+    SConfig::GetInstance().bCPUThread = true;
+    g_renderer = std::make_unique<FakeRenderer>();
+    m_renderer = static_cast<FakeRenderer*>(g_renderer.get());
+    AsyncRequests::GetInstance()->ResetBoundingBox();
+    AsyncRequests::GetInstance()->ResetStatistics();
+  }
+
+  void TearDown() override
+  {
+    g_renderer.reset();
+    SConfig::Shutdown();
+  }
+
+  FakeRenderer* m_renderer;
+};
+}  // namespace
+
+TEST_F(AsyncRequestsTest, ReadsTheBoundingBoxOncePerChange)
+{
+  AsyncRequests* requests = AsyncRequests::GetInstance();
+  for (int i = 0; i < 4; i++)
+    EXPECT_EQ(i * 10, requests->ReadBoundingBox(i));
+  EXPECT_EQ(1, m_renderer->bbox_reads[0]);
+  EXPECT_EQ(1, m_renderer->bbox_reads[3]);
+  EXPECT_EQ(1u, CountRequests(AsyncRequests::Event::BBOX_READ));
+
+  requests->InvalidateBoundingBox();
+  EXPECT_EQ(21, requests->ReadBoundingBox(2));
+  EXPECT_EQ(31, requests->ReadBoundingBox(3));
+  EXPECT_EQ(2u, CountRequests(AsyncRequests::Event::BBOX_READ));
+}
+
+TEST_F(AsyncRequestsTest, MergesConsecutivePokes)
+{
+  std::vector<AsyncRequests::Event> events(5, MakePoke(AsyncRequests::Event::EFB_POKE_COLOR));
+  events.insert(events.end(), 3, MakePoke(AsyncRequests::Event::EFB_POKE_Z));
+  events.insert(events.end(), 2, MakePoke(AsyncRequests::Event::EFB_POKE_COLOR));
+  AsyncRequests::GetInstance()->PushEvents(events.data(), events.size());
+
+  EXPECT_EQ((std::vector<int>{5, 3, 2}), m_renderer->poke_batches);
+  EXPECT_EQ(7u, CountRequests(AsyncRequests::Event::EFB_POKE_COLOR));
+  EXPECT_EQ(3u, CountRequests(AsyncRequests::Event::EFB_POKE_Z));
+}
+
+TEST_F(AsyncRequestsTest, QueuesEventsForTheGPUThread)
+{
+  // The test thread takes over the GPU thread's part of Fifo around the pushes.
+  AsyncRequests* requests = AsyncRequests::GetInstance();
+  requests->SetEnable(true);
+  requests->SetPassthrough(false);
+  std::atomic<bool> running{true};
+  std::thread gpu_thread([&] {
+    while (running.load())
+      requests->PullEvents();
+  });
+
+  // More pokes than fit in the queue at once, followed by a request that waits for all of them.
+  const std::vector<AsyncRequests::Event> events(
+      5000, MakePoke(AsyncRequests::Event::EFB_POKE_COLOR));
+  requests->PushEvents(events.data(), events.size());
+  requests->InvalidateBoundingBox();
+  requests->ReadBoundingBox(1);
+
+  EXPECT_EQ(5000u, CountRequests(AsyncRequests::Event::EFB_POKE_COLOR));
+  EXPECT_EQ(1u, CountRequests(AsyncRequests::Event::BBOX_READ));
+
+  running.store(false);
+  gpu_thread.join();
+  requests->SetEnable(false);
+  requests->SetPassthrough(true);
+  EXPECT_EQ(5000, std::accumulate(m_renderer->poke_batches.begin(),
+                                  m_renderer->poke_batches.end(), 0));
+}
@@ -0,0 +1,175 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "Common/Event.h"
+#include "VideoCommon/AsyncShaderCompiler.h"
+
+using VideoCommon::AsyncShaderCompiler;
+
+namespace
+{
+struct Log
+{
+  std::mutex lock;
+  std::vector<int> compiled;
+  std::vector<int> retrieved;
+};
+
+class TestWorkItem : public AsyncShaderCompiler::WorkItem
+{
+public:
+  TestWorkItem(Log* log, int id, Common::Event* start = nullptr, Common::Event* block = nullptr)
+      : m_log(log), m_id(id), m_start(start), m_block(block)
+  {
+  }
+
+  bool Compile() override
+  {
+    if (m_start)
+      m_start->Set();
+    if (m_block)
+      m_block->Wait();
+
+    std::lock_guard<std::mutex> guard(m_log->lock);
+    m_log->compiled.push_back(m_id);
+    return true;
+  }
+
+  void Retrieve() override { m_log->retrieved.push_back(m_id); }
+
+private:
+  Log* m_log;
+  int m_id;
+  Common::Event* m_start;
+  Common::Event* m_block;
+};
+
+// Keeps the only worker busy until Release(), so that the items queued meanwhile are all pending.
+class BlockedCompiler
+{
+public:
+  explicit BlockedCompiler(Log* log)
+  {
+    m_compiler.StartWorkerThreads(1);
+    m_compiler.QueueWorkItem(
+        AsyncShaderCompiler::CreateWorkItem<TestWorkItem>(log, -1, &m_started, &m_blocked),
+        AsyncShaderCompiler::PRIORITY_LANE_ONDEMAND);
+    m_started.Wait();
+  }
+
+  ~BlockedCompiler() { m_compiler.StopWorkerThreads(); }
+
+  AsyncShaderCompiler* operator->() { return &m_compiler; }
+
+  void Release()
+  {
+    m_blocked.Set();
+    m_compiler.WaitUntilCompletion();
+    m_compiler.RetrieveWorkItems();
+  }
+
+private:
+  AsyncShaderCompiler m_compiler;
+  Common::Event m_started;
+  Common::Event m_blocked;
+};
+}  // namespace
+
+TEST(AsyncShaderCompiler, CompilesSynchronouslyWithoutWorkers)
+{
+  Log log;
+  AsyncShaderCompiler compiler;
+  compiler.QueueWorkItem(AsyncShaderCompiler::CreateWorkItem<TestWorkItem>(&log, 1), 0);
+  EXPECT_FALSE(compiler.HasPendingWork());
+  EXPECT_TRUE(compiler.HasCompletedWork());
+
+  compiler.RetrieveWorkItems();
+  EXPECT_EQ(std::vector<int>{1}, log.compiled);
+  EXPECT_EQ(std::vector<int>{1}, log.retrieved);
+}
+
+TEST(AsyncShaderCompiler, StartsItemsByLane)
+{
+  Log log;
+  BlockedCompiler compiler(&log);
+  const auto queue = [&](int id, u32 priority) {
+    compiler->QueueWorkItem(AsyncShaderCompiler::CreateWorkItem<TestWorkItem>(&log, id), priority);
+  };
+  queue(30, AsyncShaderCompiler::PRIORITY_LANE_PRECOMPILE);
+  queue(20, AsyncShaderCompiler::PRIORITY_LANE_UBERSHADER);
+  queue(31, AsyncShaderCompiler::PRIORITY_LANE_PRECOMPILE);
+  queue(10, AsyncShaderCompiler::PRIORITY_LANE_ONDEMAND);
+  // Past the last lane.
+  queue(32, 300);
+  queue(11, AsyncShaderCompiler::PRIORITY_LANE_ONDEMAND);
+  EXPECT_TRUE(compiler->HasPendingWork());
+  EXPECT_EQ(6u, compiler->GetStatistics().pending);
+
+  compiler.Release();
+  EXPECT_EQ((std::vector<int>{-1, 10, 11, 20, 30, 31, 32}), log.compiled);
+  EXPECT_EQ(log.compiled, log.retrieved);
+
+  const AsyncShaderCompiler::Statistics statistics = compiler->GetStatistics();
+  EXPECT_EQ(0u, statistics.pending);
+  EXPECT_EQ(7u, statistics.completed);
+  EXPECT_EQ(0u, statistics.cancelled);
+}
+
+TEST(AsyncShaderCompiler, CancelsPendingItems)
+{
+  Log log;
+  BlockedCompiler compiler(&log);
+  for (int i = 0; i < 5; i++)
+  {
+    compiler->QueueWorkItem(AsyncShaderCompiler::CreateWorkItem<TestWorkItem>(&log, i),
+                            AsyncShaderCompiler::PRIORITY_LANE_PRECOMPILE);
+  }
+
+  compiler->CancelPendingWork();
+  compiler->QueueWorkItem(AsyncShaderCompiler::CreateWorkItem<TestWorkItem>(&log, 5),
+                          AsyncShaderCompiler::PRIORITY_LANE_UBERSHADER);
+
+  // The item that was already being compiled still completes.
+  compiler.Release();
+  EXPECT_EQ((std::vector<int>{-1, 5}), log.compiled);
+  EXPECT_EQ(log.compiled, log.retrieved);
+
+  const AsyncShaderCompiler::Statistics statistics = compiler->GetStatistics();
+  EXPECT_EQ(0u, statistics.pending);
+  EXPECT_EQ(2u, statistics.completed);
+  EXPECT_EQ(5u, statistics.cancelled);
+}
+
+TEST(AsyncShaderCompiler, CompilesEveryItemOnceWithManyWorkers)
+{
+  Log log;
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(4));
+  constexpr int NUM_ITEMS = 1000;
+  for (int i = 0; i < NUM_ITEMS; i++)
+  {
+    compiler.QueueWorkItem(AsyncShaderCompiler::CreateWorkItem<TestWorkItem>(&log, i),
+                           i % AsyncShaderCompiler::NUM_PRIORITY_LANES);
+    // Change the number of workers halfway through, which hands the queued items out again.
+    if (i == NUM_ITEMS / 2)
+      ASSERT_TRUE(compiler.ResizeWorkerThreads(3));
+  }
+
+  compiler.WaitUntilCompletion();
+  compiler.RetrieveWorkItems();
+  compiler.StopWorkerThreads();
+
+  std::vector<int> retrieved = log.retrieved;
+  std::sort(retrieved.begin(), retrieved.end());
+  ASSERT_EQ(static_cast<size_t>(NUM_ITEMS), retrieved.size());
+  for (int i = 0; i < NUM_ITEMS; i++)
+    EXPECT_EQ(i, retrieved[i]);
+  EXPECT_EQ(static_cast<u64>(NUM_ITEMS), compiler.GetStatistics().completed);
+}
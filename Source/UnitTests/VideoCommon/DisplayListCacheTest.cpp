@@ -0,0 +1,259 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Hash.h"
+#include "Common/Timer.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "VideoBackends/Null/VertexManager.h"
+#include "VideoBackends/Null/VideoBackend.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/DisplayListCache.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VertexLoaderManager.h"
+#include "VideoCommon/VertexManagerBase.h"
+#include "VideoCommon/VideoConfig.h"
+#include "VideoCommon/XFMemory.h"
+
+namespace
+{
+constexpr u32 LIST_ADDRESS = 0x00010000;
+
+// Vertex descriptor with direct positions, and position formats of vertex group 0.
+constexpr u32 VCD_POSITION_DIRECT = 1 << 9;
+constexpr u32 VAT_POSITION_XYZ_FLOAT = 0x9;
+constexpr u32 VAT_POSITION_XY_FLOAT = 0x8;
+
+class ListWriter
+{
+public:
+  void Byte(u8 value) { m_data.push_back(value); }
+  void Word(u32 value)
+  {
+    for (int shift = 24; shift >= 0; shift -= 8)
+      Byte(static_cast<u8>(value >> shift));
+  }
+  void Float(float value)
+  {
+    u32 word;
+    std::memcpy(&word, &value, sizeof(word));
+    Word(word);
+  }
+
+  void LoadBP(u32 value)
+  {
+    Byte(OpcodeDecoder::GX_LOAD_BP_REG);
+    Word(value);
+  }
+  void LoadCP(u8 reg, u32 value)
+  {
+    Byte(OpcodeDecoder::GX_LOAD_CP_REG);
+    Byte(reg);
+    Word(value);
+  }
+  void LoadXF(u32 address, const std::vector<u32>& values)
+  {
+    Byte(OpcodeDecoder::GX_LOAD_XF_REG);
+    Word(static_cast<u32>(values.size() - 1) << 16 | address);
+    for (u32 value : values)
+      Word(value);
+  }
+  void Nops(int count)
+  {
+    for (int i = 0; i < count; i++)
+      Byte(OpcodeDecoder::GX_NOP);
+  }
+  void DrawTriangles(u16 count)
+  {
+    Byte(0x80 | OpcodeDecoder::GX_DRAW_TRIANGLES << OpcodeDecoder::GX_PRIMITIVE_SHIFT);
+    Byte(static_cast<u8>(count >> 8));
+    Byte(static_cast<u8>(count));
+  }
+
+  void CallDisplayList(u32 address, u32 size)
+  {
+    Byte(OpcodeDecoder::GX_CMD_CALL_DL);
+    Word(address);
+    Word(size);
+  }
+
+  DataReader Reader() { return DataReader(m_data.data(), m_data.data() + m_data.size()); }
+
+  // Writes the list to emulated memory.
+  u32 Store() const
+  {
+    std::memcpy(Memory::GetPointer(LIST_ADDRESS), m_data.data(), m_data.size());
+    return static_cast<u32>(m_data.size());
+  }
+
+private:
+  std::vector<u8> m_data;
+};
+
+class DisplayListCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    SConfig::Init();
+    Memory::Init();
+    SetHash64Function();
+    g_video_backend = &m_video_backend;
+    g_ActiveConfig.bDisplayListCache = true;
+    std::memset(&g_main_cp_state, 0, sizeof(g_main_cp_state));
+    std::memset(&xfmem, 0, sizeof(xfmem));
+    IndexGenerator::Init();
+    VertexLoaderManager::Init();
+    OpcodeDecoder::Init();
+    DisplayListCache::Init();
+  }
+
+  void TearDown() override
+  {
+    g_vertex_manager.reset();
+    g_video_backend = nullptr;
+    Memory::Shutdown();
+    SConfig::Shutdown();
+  }
+
+  // Calls the list from the FIFO, and returns the number of cycles that it took. Without a
+  // backend, the vertex manager would crash when it has to draw, so every call starts with a new
+  // one that doesn't hold any vertices yet.
+  static u32 Call(u32 size)
+  {
+    g_vertex_manager = std::make_unique<Null::VertexManager>();
+    ListWriter fifo;
+    fifo.CallDisplayList(LIST_ADDRESS, size);
+    u32 cycles = 0;
+    OpcodeDecoder::Run(fifo.Reader(), &cycles, false);
+    return cycles - 6;
+  }
+
+  // Calls the list without the cache, to compare with.
+  static u32 CallUncached(u32 size)
+  {
+    g_ActiveConfig.bDisplayListCache = false;
+    const u32 cycles = Call(size);
+    g_ActiveConfig.bDisplayListCache = true;
+    return cycles;
+  }
+
+  Null::VideoBackend m_video_backend;
+};
+}  // namespace
+
+TEST_F(DisplayListCacheTest, ReplaysListsThatWereCalledBefore)
+{
+  ListWriter list;
+  list.LoadCP(0x50, VCD_POSITION_DIRECT);
+  list.LoadCP(0x70, VAT_POSITION_XYZ_FLOAT);
+  list.LoadXF(XFMEM_SETNUMTEXGENS, {1});
+  list.Nops(3);
+  list.LoadXF(0, {0x3f800000, 0, 0, 0});
+  list.DrawTriangles(3);
+  for (int i = 0; i < 9; i++)
+    list.Float(static_cast<float>(i));
+  list.Nops(5);
+  const u32 size = list.Store();
+
+  const u32 cycles = CallUncached(size);
+  const int prims = stats.thisFrame.numDLPrims;
+  EXPECT_EQ(3, prims);
+
+  // The first call decodes the list, the second one replays it.
+  for (int i = 0; i < 2; i++)
+  {
+    std::memset(&xfmem, 0, sizeof(xfmem));
+    EXPECT_EQ(cycles, Call(size));
+    EXPECT_EQ(1u, xfmem.numTexGen.numTexGens);
+    EXPECT_EQ(1.0f, xfmem.posMatrices[0]);
+    EXPECT_EQ(prims * (i + 2), stats.thisFrame.numDLPrims);
+  }
+  EXPECT_EQ(1u, stats.numDisplayListCacheHits);
+  EXPECT_EQ(1u, stats.numDisplayListCacheMisses);
+}
+
+TEST_F(DisplayListCacheTest, DecodesListsAgainAfterTheyChanged)
+{
+  ListWriter list;
+  list.LoadXF(XFMEM_SETNUMTEXGENS, {1});
+  Call(list.Store());
+
+  ListWriter changed;
+  changed.LoadXF(XFMEM_SETNUMTEXGENS, {2});
+  Call(changed.Store());
+  EXPECT_EQ(2u, xfmem.numTexGen.numTexGens);
+  EXPECT_EQ(0u, stats.numDisplayListCacheHits);
+  EXPECT_EQ(2u, stats.numDisplayListCacheMisses);
+}
+
+TEST_F(DisplayListCacheTest, FallsBackWhenTheVertexFormatChanged)
+{
+  // With two components per position, the last vertex is read as NOPs instead. The list ends
+  // with a CP register load, as an XF one would make the vertex manager draw.
+  ListWriter list;
+  list.DrawTriangles(3);
+  for (int i = 0; i < 6; i++)
+    list.Float(static_cast<float>(i + 1));
+  list.Nops(12);
+  list.LoadCP(0x71, VAT_POSITION_XY_FLOAT);
+  const u32 size = list.Store();
+
+  LoadCPReg(0x50, VCD_POSITION_DIRECT);
+  LoadCPReg(0x70, VAT_POSITION_XYZ_FLOAT);
+  Call(size);
+
+  LoadCPReg(0x70, VAT_POSITION_XY_FLOAT);
+  const u32 cycles = CallUncached(size);
+  g_main_cp_state.vtx_attr[1].g0.Hex = 0;
+  EXPECT_EQ(cycles, Call(size));
+  EXPECT_EQ(VAT_POSITION_XY_FLOAT, g_main_cp_state.vtx_attr[1].g0.Hex);
+  EXPECT_EQ(1u, stats.numDisplayListCacheHits);
+  EXPECT_EQ(1u, stats.numDisplayListCacheFallbacks);
+}
+
+// Not a test as such: prints the speed of a list that only loads state, which is what the cache
+// saves the most on.
+TEST_F(DisplayListCacheTest, Benchmark)
+{
+  ListWriter list;
+  for (u32 i = 0; i < 32; i++)
+  {
+    list.LoadBP(static_cast<u32>(BPMEM_IND_MTXA + i % 9) << 24 | i);
+    list.LoadCP(static_cast<u8>(0x70 + i % 8), VAT_POSITION_XYZ_FLOAT);
+    list.LoadXF(i * 4, {i, i + 1, i + 2, i + 3});
+    list.LoadXF(XFMEM_SETNUMTEXGENS, {1});
+  }
+  const u32 size = list.Store();
+
+  constexpr int LOOPS = 20000;
+  double us_per_call[2];
+  for (int cached = 0; cached < 2; cached++)
+  {
+    g_ActiveConfig.bDisplayListCache = cached != 0;
+    g_vertex_manager = std::make_unique<Null::VertexManager>();
+    ListWriter fifo;
+    for (int i = 0; i < LOOPS; i++)
+      fifo.CallDisplayList(LIST_ADDRESS, size);
+
+    const u64 start = Common::Timer::GetTimeUs();
+    OpcodeDecoder::Run(fifo.Reader(), nullptr, false);
+    us_per_call[cached] = static_cast<double>(Common::Timer::GetTimeUs() - start) / LOOPS;
+  }
+
+  printf("%u byte state list: %.2f us per call (uncached %.2f us)\n", size, us_per_call[1],
+         us_per_call[0]);
+}
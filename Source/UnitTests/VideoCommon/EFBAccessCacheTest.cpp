@@ -0,0 +1,141 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/MMIO.h"
+#include "VideoBackends/Null/Render.h"
+#include "VideoCommon/EFBAccessCache.h"
+#include "VideoCommon/PixelEngine.h"
+#include "VideoCommon/RenderBase.h"
+#include "VideoCommon/VideoBackendBase.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace
+{
+// Peeks return the coordinates of the pixel, with the top bit set for depth and the alpha read
+// mode in the top byte for color. Async requests are handled on the calling thread, as they are
+// without a GPU thread.
+class FakeRenderer final : public Null::Renderer
+{
+public:
+  u32 AccessEFB(EFBAccessType type, u32 x, u32 y, u32 poke_data) override
+  {
+    peeks++;
+    if (type == EFBAccessType::PeekZ)
+      return 0x80000000 | y << 16 | x;
+    return PixelEngine::GetAlphaReadMode().ReadMode << 24 | y << 16 | x;
+  }
+
+  void PokeEFB(EFBAccessType type, const EfbPokeData* points, size_t num_points) override
+  {
+    poke_calls++;
+    pokes += static_cast<int>(num_points);
+  }
+
+  int peeks = 0;
+  int poke_calls = 0;
+  int pokes = 0;
+};
+
+class EFBAccessCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    SConfig::Init();
+    g_Config.backend_info.bSupportsEFBPeekCache = true;
+    g_renderer = std::make_unique<FakeRenderer>();
+    m_renderer = static_cast<FakeRenderer*>(g_renderer.get());
+    EFBAccessCache::Init();
+    PixelEngine::RegisterMMIO(&m_mmio, PE_BASE);
+    SetAlphaReadMode(0);
+  }
+
+  void TearDown() override
+  {
+    EFBAccessCache::Reset();
+    g_renderer.reset();
+    SConfig::Shutdown();
+  }
+
+  // The alpha read mode is written by the CPU.
+  void SetAlphaReadMode(u16 mode)
+  {
+    m_mmio.Write<u16>(PE_BASE | PixelEngine::PE_ALPHAREAD, mode);
+  }
+
+  static constexpr u32 PE_BASE = 0x0C001000;
+  MMIO::Mapping m_mmio;
+  FakeRenderer* m_renderer;
+};
+}  // namespace
+
+TEST_F(EFBAccessCacheTest, ReadsEachTileOnce)
+{
+  constexpr u32 TILE_PIXELS = EFBAccessCache::TILE_SIZE * EFBAccessCache::TILE_SIZE;
+  EXPECT_EQ(0x00050003u, EFBAccessCache::Peek(EFBAccessType::PeekColor, 3, 5));
+  EXPECT_EQ(static_cast<int>(TILE_PIXELS), m_renderer->peeks);
+
+  // The rest of the tile comes from the cache, and the depth tiles are separate.
+  EXPECT_EQ(0x000f000cu, EFBAccessCache::Peek(EFBAccessType::PeekColor, 12, 15));
+  EXPECT_EQ(static_cast<int>(TILE_PIXELS), m_renderer->peeks);
+  EXPECT_EQ(0x80050003u, EFBAccessCache::Peek(EFBAccessType::PeekZ, 3, 5));
+  EXPECT_EQ(static_cast<int>(TILE_PIXELS * 2), m_renderer->peeks);
+
+  // The last tile of the EFB.
+  EXPECT_EQ(0x020f027fu, EFBAccessCache::Peek(EFBAccessType::PeekColor, 639, 527));
+  EXPECT_EQ(static_cast<int>(TILE_PIXELS * 3), m_renderer->peeks);
+
+  EFBAccessCache::Invalidate();
+  EXPECT_EQ(0x00050003u, EFBAccessCache::Peek(EFBAccessType::PeekColor, 3, 5));
+  EXPECT_EQ(static_cast<int>(TILE_PIXELS * 4), m_renderer->peeks);
+}
+
+TEST_F(EFBAccessCacheTest, HoldsPokesBackUntilFlushed)
+{
+  EFBAccessCache::Peek(EFBAccessType::PeekColor, 0, 0);
+  EFBAccessCache::Peek(EFBAccessType::PeekColor, 100, 100);
+  const int peeks = m_renderer->peeks;
+
+  for (u32 x = 0; x < 10; x++)
+    EFBAccessCache::Poke(EFBAccessType::PokeColor, x, 0, 0);
+  EXPECT_EQ(0, m_renderer->pokes);
+
+  // Peeking another tile doesn't need the pokes.
+  EFBAccessCache::Peek(EFBAccessType::PeekColor, 100, 100);
+  EXPECT_EQ(0, m_renderer->pokes);
+  EXPECT_EQ(peeks, m_renderer->peeks);
+
+  // The poked tile is read again, after the pokes have been sent together.
+  EFBAccessCache::Peek(EFBAccessType::PeekColor, 15, 15);
+  EXPECT_EQ(1, m_renderer->poke_calls);
+  EXPECT_EQ(10, m_renderer->pokes);
+  EXPECT_EQ(peeks + static_cast<int>(EFBAccessCache::TILE_SIZE * EFBAccessCache::TILE_SIZE),
+            m_renderer->peeks);
+
+  EFBAccessCache::Poke(EFBAccessType::PokeZ, 0, 0, 0);
+  EFBAccessCache::FlushPokes();
+  EXPECT_EQ(11, m_renderer->pokes);
+}
+
+TEST_F(EFBAccessCacheTest, FollowsTheAlphaReadMode)
+{
+  EXPECT_EQ(0x00050003u, EFBAccessCache::Peek(EFBAccessType::PeekColor, 3, 5));
+  const int peeks = m_renderer->peeks;
+
+  // The tile is read again with the new mode, but depth doesn't depend on it.
+  SetAlphaReadMode(2);
+  EXPECT_EQ(0x02050004u, EFBAccessCache::Peek(EFBAccessType::PeekColor, 4, 5));
+  EXPECT_EQ(peeks * 2, m_renderer->peeks);
+  EFBAccessCache::Peek(EFBAccessType::PeekZ, 3, 5);
+  SetAlphaReadMode(1);
+  EXPECT_EQ(0x80050003u, EFBAccessCache::Peek(EFBAccessType::PeekZ, 3, 5));
+  EXPECT_EQ(peeks * 3, m_renderer->peeks);
+}
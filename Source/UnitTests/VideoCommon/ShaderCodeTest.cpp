@@ -0,0 +1,91 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <clocale>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/StringUtil.h"
+#include "VideoCommon/ShaderGenCommon.h"
+
+// ShaderCode has its own formatter, which must give the same results as the C library.
+#define EXPECT_FORMAT(...)                                                                         \
+  do                                                                                               \
+  {                                                                                                \
+    ShaderCode code;                                                                               \
+    code.Write(__VA_ARGS__);                                                                       \
+    EXPECT_EQ(StringFromFormat(__VA_ARGS__), code.GetBuffer());                                    \
+  } while (0)
+
+TEST(ShaderCode, Text)
+{
+  EXPECT_FORMAT("%s", "");
+  EXPECT_FORMAT("float4 rawpos : POSITION;\n");
+  EXPECT_FORMAT("100%% %%s%%");
+}
+
+TEST(ShaderCode, Integers)
+{
+  EXPECT_FORMAT("int2 c%d = int2(%i, %u);", 0, -42, 42u);
+  EXPECT_FORMAT("%d %d", std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+  EXPECT_FORMAT("%u %x %X", std::numeric_limits<u32>::max(), 0xdeadbeefu, 0xdeadbeefu);
+  EXPECT_FORMAT("%08x %06X %#x %#X %#x %o %#o %#o", 0x1234u, 0xabcu, 0xffu, 0xffu, 0u, 8u, 8u, 0u);
+  EXPECT_FORMAT("[%5d] [%-5d] [%05d] [%+d] [% d] [%+d]", 42, 42, -42, 42, 42, -42);
+  EXPECT_FORMAT("[%.3d] [%.0d] [%.0u] [%8.3d] [%-8.3x] [%08.3d]", 7, 0, 0u, -7, 0xau, 7);
+  EXPECT_FORMAT("[%*d] [%-*d] [%*d] [%.*d] [%.*d]", 6, 1, 6, 2, -6, 3, 4, 5, -1, 6);
+  EXPECT_FORMAT("%hhd %hhu %hd %hu", 300, 300u, 70000, 70000u);
+  EXPECT_FORMAT("%ld %lu %lld %llu %lx", -1L, 1UL, std::numeric_limits<long long>::min(),
+                std::numeric_limits<unsigned long long>::max(), 0x123456789aUL);
+  EXPECT_FORMAT("%zu %zx %td", size_t(1) << 40, size_t(0xabc), ptrdiff_t(-5));
+}
+
+TEST(ShaderCode, CharactersAndStrings)
+{
+  EXPECT_FORMAT("%s.%c%c%c = %s;", "prev", 'r', 'g', 'b', "float3(0.0, 0.0, 0.0)");
+  EXPECT_FORMAT("[%10s] [%-10s] [%.2s] [%5.1s] [%3c] [%-3c]", "abc", "abc", "abc", "abc", 'x', 'y');
+  EXPECT_FORMAT("[%*s] [%.*s]", 4, "a", 3, "abcdef");
+}
+
+TEST(ShaderCode, FloatingPoint)
+{
+  EXPECT_FORMAT("%f %.3f %e %g %10.4f %-8.1f|", 1.5, -2.0 / 3, 12345.678, 0.0001, 3.14159, 2.5);
+  EXPECT_FORMAT("%s = %f + %d;", "x", 0.25, 3);
+}
+
+TEST(ShaderCode, FloatingPointIgnoresTheLocale)
+{
+  // Shaders need a decimal point, even in locales that use a comma. The test can only check this
+  // where one of them is installed.
+  const std::string old_locale = std::setlocale(LC_NUMERIC, nullptr);
+  bool found = false;
+  for (const char* locale : {"de_DE.UTF-8", "fr_FR.UTF-8", "de_DE", "fr_FR", "German"})
+  {
+    if (std::setlocale(LC_NUMERIC, locale))
+    {
+      found = true;
+      break;
+    }
+  }
+
+  ShaderCode code;
+  code.Write("%f %.1e %g", 1.5, 2.5, 0.25);
+  std::setlocale(LC_NUMERIC, old_locale.c_str());
+  EXPECT_EQ("1.500000 2.5e+00 0.25", code.GetBuffer());
+  if (!found)
+    printf("No locale with a decimal comma is installed\n");
+}
+
+TEST(ShaderCode, Appends)
+{
+  ShaderCode code;
+  code.Write("a%d", 1);
+  code.Write("\n");
+  code.Write("%s%s", "b", "c");
+  EXPECT_EQ("a1\nbc", code.GetBuffer());
+}
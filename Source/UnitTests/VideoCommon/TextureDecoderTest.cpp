@@ -0,0 +1,155 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Timer.h"
+#include "VideoCommon/TextureDecoder.h"
+
+namespace
+{
+constexpr TextureFormat FORMATS[] = {
+    TextureFormat::I4,     TextureFormat::I8,    TextureFormat::IA4,    TextureFormat::IA8,
+    TextureFormat::RGB565, TextureFormat::RGB5A3, TextureFormat::RGBA8, TextureFormat::C4,
+    TextureFormat::C8,     TextureFormat::C14X2, TextureFormat::CMPR,   TextureFormat::XFB,
+};
+constexpr const char* FORMAT_NAMES[] = {"I4",    "I8", "IA4",   "IA8",  "RGB565", "RGB5A3",
+                                        "RGBA8", "C4", "C8",    "C14X2", "CMPR",  "XFB"};
+
+constexpr int WIDTH = 1024;
+constexpr int HEIGHT = 1024;
+// Small enough to always be decoded on the calling thread.
+constexpr int STRIP_HEIGHT = 8;
+static_assert(WIDTH * STRIP_HEIGHT < TEXTURE_DECODE_PARALLEL_THRESHOLD, "strips are too large");
+
+class TextureDecoderTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    std::mt19937 random(1234);
+    // Enough for 1024x1024 RGBA8, and for a palette of 16384 entries.
+    m_src.resize(WIDTH * HEIGHT * 4);
+    std::generate(m_src.begin(), m_src.end(), [&random] { return static_cast<u8>(random()); });
+    m_tlut.resize(16384 * 2);
+    std::generate(m_tlut.begin(), m_tlut.end(), [&random] { return static_cast<u8>(random()); });
+  }
+
+  std::vector<u32> Decode(TextureFormat format, int width, int height, const u8* src) const
+  {
+    std::vector<u32> dst(width * height);
+    TexDecoder_Decode(reinterpret_cast<u8*>(dst.data()), src, width, height, format,
+                      m_tlut.data(), TLUTFormat::RGB5A3);
+    return dst;
+  }
+
+  std::vector<u8> m_src;
+  std::vector<u8> m_tlut;
+};
+}  // namespace
+
+// Large textures are decoded in bands, which must give the same result as decoding them whole.
+TEST_F(TextureDecoderTest, LargeTexturesMatchDecodingInStrips)
+{
+  for (size_t i = 0; i < std::size(FORMATS); i++)
+  {
+    const TextureFormat format = FORMATS[i];
+    const std::vector<u32> whole = Decode(format, WIDTH, HEIGHT, m_src.data());
+
+    std::vector<u32> strips;
+    for (int y = 0; y < HEIGHT; y += STRIP_HEIGHT)
+    {
+      const u8* src = &m_src[TexDecoder_GetTextureSizeInBytes(WIDTH, y, format)];
+      const std::vector<u32> strip = Decode(format, WIDTH, STRIP_HEIGHT, src);
+      strips.insert(strips.end(), strip.begin(), strip.end());
+    }
+
+    EXPECT_TRUE(whole == strips) << FORMAT_NAMES[i];
+  }
+}
+
+// Every optimized decoder that the host can run must give the same result as the portable one.
+TEST_F(TextureDecoderTest, MatchesGenericDecoder)
+{
+  struct DecoderPath
+  {
+    const char* name;
+    bool ssse3;
+    bool avx2;
+  };
+  constexpr DecoderPath PATHS[] = {{"SSE2", false, false}, {"SSSE3", true, false},
+                                   {"AVX2", true, true}};
+  constexpr TLUTFormat TLUT_FORMATS[] = {TLUTFormat::IA8, TLUTFormat::RGB565, TLUTFormat::RGB5A3};
+  constexpr const char* TLUT_FORMAT_NAMES[] = {"IA8", "RGB565", "RGB5A3"};
+
+  const CPUInfo host_cpu_info = cpu_info;
+  for (const DecoderPath& path : PATHS)
+  {
+    if ((path.ssse3 && !host_cpu_info.bSSSE3) || (path.avx2 && !host_cpu_info.bAVX2))
+      continue;
+    cpu_info.bSSSE3 = path.ssse3;
+    cpu_info.bAVX2 = path.avx2;
+
+    for (size_t i = 0; i < std::size(FORMATS); i++)
+    {
+      const TextureFormat format = FORMATS[i];
+      // An odd number of blocks, so that the decoders that do two blocks at once have one left.
+      const int width = TexDecoder_GetBlockWidthInTexels(format) * 17;
+      const int height = TexDecoder_GetBlockHeightInTexels(format) * 8;
+      const size_t num_tlut_formats = IsColorIndexed(format) ? std::size(TLUT_FORMATS) : 1;
+      for (size_t j = 0; j < num_tlut_formats; j++)
+      {
+        std::vector<u32> expected(width * height);
+        _TexDecoder_DecodeImplGeneric(expected.data(), m_src.data(), width, height, format,
+                                      m_tlut.data(), TLUT_FORMATS[j]);
+        std::vector<u32> actual(width * height);
+        _TexDecoder_DecodeImpl(actual.data(), m_src.data(), width, height, format, m_tlut.data(),
+                               TLUT_FORMATS[j]);
+
+        EXPECT_TRUE(expected == actual) << path.name << " " << FORMAT_NAMES[i] << " "
+                                        << (IsColorIndexed(format) ? TLUT_FORMAT_NAMES[j] : "");
+      }
+    }
+  }
+  cpu_info = host_cpu_info;
+}
+
+// Not a test as such: prints the decoding speed of every format, for both sizes of textures.
+TEST_F(TextureDecoderTest, Benchmark)
+{
+  constexpr int LOOPS = 4;
+  for (size_t i = 0; i < std::size(FORMATS); i++)
+  {
+    const TextureFormat format = FORMATS[i];
+    double mtexels_per_second[2];
+    for (int large = 0; large < 2; large++)
+    {
+      const int width = large ? WIDTH : 64;
+      const int height = large ? HEIGHT : 64;
+      // The same number of texels either way.
+      const int textures = LOOPS * (WIDTH * HEIGHT) / (width * height);
+
+      std::vector<u32> dst(width * height);
+      const u64 start = Common::Timer::GetTimeUs();
+      for (int j = 0; j < textures; j++)
+      {
+        TexDecoder_Decode(reinterpret_cast<u8*>(dst.data()), m_src.data(), width, height, format,
+                          m_tlut.data(), TLUTFormat::RGB5A3);
+      }
+      const u64 elapsed_us = std::max<u64>(Common::Timer::GetTimeUs() - start, 1);
+      mtexels_per_second[large] = static_cast<double>(LOOPS) * WIDTH * HEIGHT / elapsed_us;
+    }
+
+    printf("%-7s %8.1f MTexels/s (64x64) %8.1f MTexels/s (%dx%d)\n", FORMAT_NAMES[i],
+           mtexels_per_second[0], mtexels_per_second[1], WIDTH, HEIGHT);
+  }
+}
@@ -2,19 +2,31 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <chrono>
 #include <limits>
 #include <memory>
+#include <string>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>  // NOLINT
 
 #include "Common/Common.h"
+#include "Common/Config/Config.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
 #include "Common/MathUtil.h"
+#include "Core/ConfigManager.h"
+#include "UICommon/UICommon.h"
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 
@@ -355,3 +367,114 @@ TEST_F(VertexLoaderTest, LargeFloatVertexSpeed)
   for (int i = 0; i < 100; ++i)
     RunVertices(100000);
 }
+
+class VertexLoaderUIDCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    File::CreateFullPath(File::GetUserPath(D_CACHE_IDX));
+    m_cache_path =
+        File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".vluidcache";
+    VertexLoaderManager::Init();
+  }
+
+  void TearDown() override
+  {
+    VertexLoaderManager::Clear();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // Same layout as the file that VertexLoaderManager writes: a magic, a version and the UIDs.
+  void WriteCache(u32 version, const std::vector<std::pair<TVtxDesc, VAT>>& formats)
+  {
+    File::IOFile file(m_cache_path, "wb");
+    const u32 magic = 0x44495556;
+    file.WriteBytes(&magic, sizeof(magic));
+    file.WriteBytes(&version, sizeof(version));
+    for (const auto& format : formats)
+    {
+      const u64 vtx_desc = format.first.Hex;
+      const u32 vat[3] = {format.second.g0.Hex, format.second.g1.Hex, format.second.g2.Hex};
+      file.WriteBytes(&vtx_desc, sizeof(vtx_desc));
+      file.WriteBytes(vat, sizeof(vat));
+    }
+  }
+
+  static size_t CountLoaders()
+  {
+    const std::string loaders = VertexLoaderManager::VertexLoadersToString();
+    return std::count(loaders.begin(), loaders.end(), '\n');
+  }
+
+  // The warmup thread can't be joined without clearing the loaders, so wait for them to show up.
+  static bool WaitForLoaders(size_t count)
+  {
+    for (int i = 0; i < 1000 && CountLoaders() < count; ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return CountLoaders() == count;
+  }
+
+  static std::pair<TVtxDesc, VAT> MakeFormat(int position_format, int tex0_format)
+  {
+    TVtxDesc vtx_desc;
+    memset(&vtx_desc, 0, sizeof(vtx_desc));
+    VAT vtx_attr;
+    memset(&vtx_attr, 0, sizeof(vtx_attr));
+    vtx_desc.Position = DIRECT;
+    vtx_attr.g0.PosFormat = position_format;
+    vtx_desc.Tex0Coord = DIRECT;
+    vtx_attr.g0.Tex0CoordFormat = tex0_format;
+    return {vtx_desc, vtx_attr};
+  }
+
+  std::string m_profile_path;
+  std::string m_cache_path;
+};
+
+TEST_F(VertexLoaderUIDCacheTest, CompilesRecordedLoadersAheadOfTime)
+{
+  WriteCache(1, {MakeFormat(FORMAT_FLOAT, FORMAT_SHORT), MakeFormat(FORMAT_BYTE, FORMAT_FLOAT),
+                 MakeFormat(FORMAT_FLOAT, FORMAT_SHORT)});
+  VertexLoaderManager::LoadVertexLoaderUIDCache();
+
+  // The duplicate is compiled once.
+  EXPECT_TRUE(WaitForLoaders(2));
+  // Only the GPU thread counts loaders, when it first uses them.
+  EXPECT_EQ(0, stats.numVertexLoaders);
+
+  VertexLoaderManager::Clear();
+  EXPECT_EQ(0u, CountLoaders());
+}
+
+TEST_F(VertexLoaderUIDCacheTest, StartsOverOnVersionMismatch)
+{
+  WriteCache(0, {MakeFormat(FORMAT_FLOAT, FORMAT_SHORT)});
+  VertexLoaderManager::LoadVertexLoaderUIDCache();
+  VertexLoaderManager::Clear();
+
+  EXPECT_EQ(0u, CountLoaders());
+  // Only the header of the new file is left.
+  EXPECT_EQ(2 * sizeof(u32), File::GetSize(m_cache_path));
+}
+
+TEST_F(VertexLoaderUIDCacheTest, StartsOverOnTruncatedFile)
+{
+  WriteCache(1, {MakeFormat(FORMAT_FLOAT, FORMAT_SHORT)});
+  {
+    File::IOFile file(m_cache_path, "ab");
+    const u8 partial_uid[3] = {};
+    file.WriteBytes(partial_uid, sizeof(partial_uid));
+  }
+  VertexLoaderManager::LoadVertexLoaderUIDCache();
+  VertexLoaderManager::Clear();
+
+  EXPECT_EQ(0u, CountLoaders());
+  EXPECT_EQ(2 * sizeof(u32), File::GetSize(m_cache_path));
+}